@@ -0,0 +1,234 @@
+#include "FollowerBenchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include <frc/RobotController.h>
+
+// Points evaluated along each curve.
+#define kSamplesPerCurve 64
+
+volatile double benchmarkSink = 0;
+
+FollowerBenchmark::FollowerBenchmark (std::vector<std::string> files, FollowPolybezier::Configuration config, Drivetrain* drivetrain)
+    : m_Files(std::move(files)), m_Config(config), m_Drivetrain(drivetrain)
+{
+    for (auto &file : m_Files) {
+        for (auto &curve : FollowPolybezier::LoadPath(file, m_Config).get()) {
+            m_Curves.push_back(curve.bezier);
+        }
+        m_Trajectories.push_back(FollowPolybezier::LoadTrajectory(file, m_Config).get());
+    }
+}
+
+std::vector<BenchmarkResult> FollowerBenchmark::Run () {
+    return {
+        Evaluate(),
+        EvaluateDerivatives(),
+        RadiusOfCurvature(),
+        PolylineApproximation(),
+        AddApproximation(),
+        CalculateAcceleration(),
+        BuildTrajectory(),
+        TrajectoryAtTime(),
+        TrajectoryAtDistance(),
+        TrajectoryProject(),
+    };
+}
+
+BenchmarkResult FollowerBenchmark::Evaluate () {
+    return Measure("evaluate", [&] {
+        double sum = 0;
+        for (auto &curve : m_Curves) {
+            for (int i = 0; i < kSamplesPerCurve; i++) {
+                sum += Bezier::evaluate(curve, i / (kSamplesPerCurve - 1.0)).x;
+            }
+        }
+        benchmarkSink = benchmarkSink + sum;
+        return m_Curves.size() * kSamplesPerCurve;
+    });
+}
+
+BenchmarkResult FollowerBenchmark::EvaluateDerivatives () {
+    return Measure("evaluateDerivatives", [&] {
+        double sum = 0;
+        for (auto &curve : m_Curves) {
+            for (int i = 0; i < kSamplesPerCurve; i++) {
+                sum += Bezier::evaluateDerivatives(curve, i / (kSamplesPerCurve - 1.0)).secondDeriv.x;
+            }
+        }
+        benchmarkSink = benchmarkSink + sum;
+        return m_Curves.size() * kSamplesPerCurve;
+    });
+}
+
+BenchmarkResult FollowerBenchmark::RadiusOfCurvature () {
+    std::vector<Bezier::Derivatives> derivatives;
+    for (auto &curve : m_Curves) {
+        for (int i = 0; i < kSamplesPerCurve; i++) {
+            derivatives.push_back(Bezier::evaluateDerivatives(curve, i / (kSamplesPerCurve - 1.0)));
+        }
+    }
+
+    return Measure("getRadiusOfCurvature", [&] {
+        double sum = 0;
+        for (auto &d : derivatives) {
+            sum += Bezier::getRadiusOfCurvature(d);
+        }
+        benchmarkSink = benchmarkSink + sum;
+        return derivatives.size();
+    });
+}
+
+BenchmarkResult FollowerBenchmark::PolylineApproximation () {
+    // Per curve, with the settings the follower uses.
+    return Measure("polylineApproximation", [&] {
+        size_t samples = 0;
+        for (auto &curve : m_Curves) {
+            samples += Bezier::polylineApproximation(curve, 1.001, 0.05).size();
+        }
+        benchmarkSink = benchmarkSink + samples;
+        return m_Curves.size();
+    });
+}
+
+BenchmarkResult FollowerBenchmark::AddApproximation () {
+    // Kept between batches, so their sample vectors already have room, as
+    // they do when the follower moves on to a new curve.
+    std::vector<FollowPolybezier::Curve> curves;
+    for (auto &curve : m_Curves) {
+        curves.push_back({curve, {}});
+    }
+
+    return Measure("FollowPolybezier::AddApproximation", [&] {
+        for (auto &curve : curves) {
+            FollowPolybezier::AddApproximation(&curve, m_Config);
+        }
+        return curves.size();
+    });
+}
+
+BenchmarkResult FollowerBenchmark::CalculateAcceleration () {
+    struct Case {
+        LegacyFollower* follower;
+        unsigned int curve, vertex;
+        double distance, velocity;
+        std::pair<unsigned int, unsigned int> nextMin;
+    };
+
+    // One lookahead from every vertex of every path, at the fastest speed the
+    // path allows there, which looks furthest ahead.
+    std::vector<std::unique_ptr<LegacyFollower>> followers;
+    std::vector<Case> cases;
+    for (auto &file : m_Files) {
+        // Both stay cached, so outlive the followers.
+        const FollowPolybezier::Path &path = FollowPolybezier::LoadPath(file, m_Config).get();
+        const Trajectory &trajectory = FollowPolybezier::LoadTrajectory(file, m_Config).get();
+        if (path.empty()) continue;
+
+        followers.push_back(std::make_unique<LegacyFollower>(m_Drivetrain, path, trajectory, m_Config, false));
+        LegacyFollower* follower = followers.back().get();
+
+        follower->Start(m_Drivetrain->GetPose());
+
+        for (unsigned int c = 0; c < follower->polybezier.size(); c++) {
+            auto &samples = follower->polybezier[c].samples;
+            for (unsigned int v = 0; v + 1 < samples.size(); v++) {
+                follower->currentBezier = c;
+                follower->prevVertex = v;
+                follower->SetNextMin();
+
+                cases.push_back({follower, c, v, samples[v].d, std::min(samples[v].maxV, 3.0), follower->nextMin});
+            }
+        }
+    }
+
+    return Measure("LegacyFollower::CalculateAcceleration", [&] {
+        double sum = 0;
+        for (auto &c : cases) {
+            LegacyFollower* follower = c.follower;
+            follower->currentBezier = c.curve;
+            follower->prevVertex = c.vertex;
+            follower->distanceTraveled = c.distance;
+            follower->velocity = c.velocity;
+            follower->acceleration = 0;
+            follower->nextMin = c.nextMin;
+            follower->lastTime = frc::RobotController::GetFPGATime() - 20000;
+
+            sum += follower->CalculateAcceleration().first;
+        }
+        benchmarkSink = benchmarkSink + sum;
+        return cases.size();
+    });
+}
+
+BenchmarkResult FollowerBenchmark::BuildTrajectory () {
+    std::vector<std::vector<Trajectory::Waypoint>> waypoints;
+    for (auto &file : m_Files) {
+        waypoints.push_back(FollowPolybezier::GetWaypoints(FollowPolybezier::LoadPath(file, m_Config).get()));
+    }
+
+    Trajectory::Constraints constraints {
+        m_Config.maximumVelocity, m_Config.maximumAcceleration, m_Config.maximumReverseAcceleration, m_Config.maximumRadialAcceleration
+    };
+
+    // Per path.
+    return Measure("Trajectory", [&] {
+        size_t samples = 0;
+        for (auto &path : waypoints) {
+            samples += Trajectory{path, constraints}.GetSize();
+        }
+        benchmarkSink = benchmarkSink + samples;
+        return waypoints.size();
+    });
+}
+
+BenchmarkResult FollowerBenchmark::TrajectoryAtTime () {
+    return Measure("Trajectory::AtTime", [&] {
+        double sum = 0;
+        for (auto &trajectory : m_Trajectories) {
+            for (int i = 0; i < kSamplesPerCurve; i++) {
+                sum += trajectory.AtTime(trajectory.GetDuration() * i / (kSamplesPerCurve - 1.0)).velocity;
+            }
+        }
+        benchmarkSink = benchmarkSink + sum;
+        return m_Trajectories.size() * kSamplesPerCurve;
+    });
+}
+
+BenchmarkResult FollowerBenchmark::TrajectoryAtDistance () {
+    return Measure("Trajectory::AtDistance", [&] {
+        double sum = 0;
+        for (auto &trajectory : m_Trajectories) {
+            for (int i = 0; i < kSamplesPerCurve; i++) {
+                sum += trajectory.AtDistance(trajectory.GetLength() * i / (kSamplesPerCurve - 1.0)).heading;
+            }
+        }
+        benchmarkSink = benchmarkSink + sum;
+        return m_Trajectories.size() * kSamplesPerCurve;
+    });
+}
+
+BenchmarkResult FollowerBenchmark::TrajectoryProject () {
+    // Points a little off each path, searched for a metre ahead like the
+    // followers do.
+    std::vector<std::pair<const Trajectory*, Trajectory::Sample>> queries;
+    for (auto &trajectory : m_Trajectories) {
+        for (int i = 0; i < kSamplesPerCurve; i++) {
+            Trajectory::Sample sample = trajectory.AtDistance(trajectory.GetLength() * i / (kSamplesPerCurve - 1.0));
+            sample.x -= 0.1 * std::sin(sample.heading);
+            sample.y += 0.1 * std::cos(sample.heading);
+            queries.push_back({&trajectory, sample});
+        }
+    }
+
+    return Measure("Trajectory::Project", [&] {
+        double sum = 0;
+        for (auto &[trajectory, sample] : queries) {
+            sum += trajectory->Project(sample.x, sample.y, sample.distance - 0.05, sample.distance + 1.0).crossTrack;
+        }
+        benchmarkSink = benchmarkSink + sum;
+        return queries.size();
+    });
+}
@@ -0,0 +1,151 @@
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <hal/HAL.h>
+#include <wpi/json.h>
+#include <wpi/raw_istream.h>
+
+#include "Constants.h"
+#include "FollowerBenchmark.h"
+#include "sim/DrivetrainPlant.h"
+#include "util/Deploy.h"
+
+// Micro-benchmarks for the bezier library and the path follower, on the
+// deployed paths.  Prints ns and heap allocations per operation.
+//
+//     pathBenchmark [--paths dir] [--baseline file [--save]] [--tolerance 0.15]
+//
+// With a baseline, each result is compared to it, and the run fails if any
+// got slower by more than the tolerance or allocates more.  --save writes
+// this run as the new baseline instead.  A baseline entry can leave out
+// nsPerOp or allocsPerOp to skip that check.  Compare timings from the same
+// machine only.
+//
+// ./gradlew benchmark runs it against src/benchmark/baseline.json, and
+// ./gradlew benchmark -PsaveBaseline records that.  The committed baseline
+// only holds allocation counts, which are the same on every machine: the
+// operations a control loop runs mustn't allocate.  Record timings over it
+// locally, but don't commit them.
+
+// False if the file is missing or isn't a baseline.  Comparing against
+// nothing would pass every run.
+static bool LoadBaseline (const std::string &file, wpi::json &baseline) {
+    std::error_code code;
+    wpi::raw_fd_istream in {file, code};
+    if (code.value() != 0) {
+        std::cerr << "Unable to open baseline " << file << ": " << code.message() << std::endl;
+        return false;
+    }
+
+    try {
+        in >> baseline;
+    } catch (const std::exception &ex) {
+        std::cerr << "Unable to read baseline " << file << ": " << ex.what() << std::endl;
+        return false;
+    }
+
+    if (!baseline.is_object()) {
+        std::cerr << "Unable to read baseline " << file << ": not an object" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main (int argc, char** argv) {
+    std::string paths = Deploy::path("paths");
+    std::string baselineFile;
+    bool save = false;
+    double tolerance = 0.15;
+
+    for (int i = 1; i < argc; i++) {
+        if (0 == std::strcmp(argv[i], "--paths") && i + 1 < argc) {
+            paths = argv[++i];
+        } else if (0 == std::strcmp(argv[i], "--baseline") && i + 1 < argc) {
+            baselineFile = argv[++i];
+        } else if (0 == std::strcmp(argv[i], "--save")) {
+            save = true;
+        } else if (0 == std::strcmp(argv[i], "--tolerance") && i + 1 < argc) {
+            tolerance = std::atof(argv[++i]);
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--paths dir] [--baseline file [--save]] [--tolerance fraction]" << std::endl;
+            return 2;
+        }
+    }
+
+    wpi::json baseline = wpi::json::object();
+    if (!baselineFile.empty() && !save && !LoadBaseline(baselineFile, baseline)) {
+        return 2;
+    }
+
+    HAL_Initialize(500, 0);
+
+    auto config = cpptoml::parse_file(Deploy::path(ConfigFiles::ConfigFile));
+
+    // Planned the way the robot plans them.
+    FollowPolybezier::Configuration followerConfig = FollowPolybezier::ReadConfiguration(config->get_table("follower"));
+
+    DrivetrainPlant plant {config->get_table("drivetrain"), nullptr};
+    Drivetrain drivetrain {config->get_table("drivetrain"), &plant};
+
+    std::vector<std::string> files;
+    for (auto &name : Deploy::listPaths(paths)) {
+        files.push_back(paths + "/" + name);
+    }
+    std::cout << "benchmarking " << files.size() << " paths from " << paths << std::endl;
+
+    FollowerBenchmark benchmark {files, followerConfig, &drivetrain};
+    std::vector<BenchmarkResult> results = benchmark.Run();
+
+    wpi::json current = wpi::json::object();
+    bool regressed = false;
+
+    std::cout << std::left << std::setw(40) << "benchmark" << std::right
+        << std::setw(12) << "ns/op" << std::setw(14) << "allocs/op" << std::setw(12) << "vs base" << std::endl;
+
+    for (auto &result : results) {
+        current[result.name] = {{"nsPerOp", result.nsPerOp}, {"allocsPerOp", result.allocsPerOp}};
+
+        std::cout << std::left << std::setw(40) << result.name << std::right << std::fixed
+            << std::setw(12) << std::setprecision(1) << result.nsPerOp
+            << std::setw(14) << std::setprecision(2) << result.allocsPerOp;
+
+        if (baseline.count(result.name)) {
+            const wpi::json &base = baseline[result.name];
+            bool worse = false;
+
+            if (base.count("nsPerOp")) {
+                double ns = base["nsPerOp"].get<double>();
+                double change = (result.nsPerOp - ns) / ns;
+
+                std::cout << std::setw(11) << std::showpos << std::setprecision(1) << 100.0 * change << "%" << std::noshowpos;
+                worse = change > tolerance;
+            } else {
+                std::cout << std::setw(12) << "-";
+            }
+
+            if (base.count("allocsPerOp")) {
+                worse = worse || result.allocsPerOp > base["allocsPerOp"].get<double>() + 0.005;
+            }
+
+            if (worse) {
+                std::cout << "  REGRESSED";
+                regressed = true;
+            }
+        }
+
+        std::cout << std::endl;
+    }
+
+    if (save && !baselineFile.empty()) {
+        std::ofstream out {baselineFile};
+        out << current.dump(4) << std::endl;
+        std::cout << "saved baseline to " << baselineFile << std::endl;
+    }
+
+    return regressed ? 1 : 0;
+}
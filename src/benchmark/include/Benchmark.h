@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "instrumentation/AllocationTracking.h"
+
+struct BenchmarkResult {
+    std::string name;
+    double nsPerOp;
+    double allocsPerOp;
+    uint64_t ops;
+};
+
+// Results are added to this, so the optimizer can't drop the work.
+extern volatile double benchmarkSink;
+
+// Times batch, which does some operations and returns how many, until at
+// least minimumTime has gone by.  One untimed batch warms up the caches
+// first.
+template <typename Batch>
+BenchmarkResult Measure (std::string name, Batch batch, std::chrono::milliseconds minimumTime = std::chrono::milliseconds(250)) {
+    using Clock = std::chrono::steady_clock;
+
+    batch();
+
+    uint64_t ops = 0;
+    uint64_t allocations = AllocationTracking::GetCount();
+    Clock::time_point start = Clock::now();
+    Clock::duration elapsed;
+
+    do {
+        ops += batch();
+        elapsed = Clock::now() - start;
+    } while (elapsed < minimumTime);
+
+    allocations = AllocationTracking::GetCount() - allocations;
+
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    return {std::move(name), ns / ops, (double)allocations / ops, ops};
+}
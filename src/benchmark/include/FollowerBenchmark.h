@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "commands/FollowPolybezier.h"
+#include "subsystems/Drivetrain.h"
+#include "trajectory/LegacyFollower.h"
+
+// Benchmarks for the bezier library, FollowPolybezier's planning and
+// trajectories, run on every curve of the given paths.
+class FollowerBenchmark {
+    public:
+        FollowerBenchmark(std::vector<std::string> paths, FollowPolybezier::Configuration config, Drivetrain* drivetrain);
+
+        std::vector<BenchmarkResult> Run();
+
+    private:
+        BenchmarkResult Evaluate();
+        BenchmarkResult EvaluateDerivatives();
+        BenchmarkResult RadiusOfCurvature();
+        BenchmarkResult PolylineApproximation();
+        BenchmarkResult AddApproximation();
+        BenchmarkResult CalculateAcceleration();
+        BenchmarkResult BuildTrajectory();
+        BenchmarkResult TrajectoryAtTime();
+        BenchmarkResult TrajectoryAtDistance();
+        BenchmarkResult TrajectoryProject();
+
+        std::vector<std::string> m_Files;
+        FollowPolybezier::Configuration m_Config;
+        Drivetrain* m_Drivetrain;
+
+        std::vector<Bezier::CubicBezier> m_Curves;
+        std::vector<Trajectory> m_Trajectories;
+};
@@ -1,7 +1,7 @@
 #include <algorithm>
 #include <iostream>
+#include <iterator>
 #include <limits>
-#include <set>
 
 #include "LayoutDetector.h"
 #include "PickupCellsChallenge.h"
@@ -19,7 +19,7 @@ int compute_error(const LayoutDetector::Point &actual, const LayoutDetector::Poi
     return (dx * dx + dy * dy);
 }
 
-int compute_layout_error(std::vector<LayoutDetector::Point> actualPoints, std::vector<LayoutDetector::Point> expectedPoints) {
+int compute_layout_error(const std::vector<LayoutDetector::Point> &actualPoints, const std::vector<LayoutDetector::Point> &expectedPoints) {
     // Compute error by finding sum of squared distances (dot product) between
     // nearest actual and expected points.
 
@@ -53,57 +53,46 @@ int compute_layout_error(std::vector<LayoutDetector::Point> actualPoints, std::v
 
 
 int LayoutDetector::GetError() {
-    std::vector<LayoutDetector::Point> actualPoints = ActualPoints();
-    std::vector<BlockStats> liked;
+    // Reuses the last call's storage, since this runs every loop.
+    expectedPoints.clear();
 
     // All liked blocks must have "old" age, but "old" is slow, so we don't
     // want to wait for oldest blocks.
-    for (auto pair : possibles) {
-        auto stats = pair.second;
-        if (OLD_BLOCK_LIMIT < stats.m_MaxAge) {
-            liked.push_back(BlockStats(stats));
+    for (auto &possible : possibles) {
+        if (!possible) continue;
+
+        if (OLD_BLOCK_LIMIT < possible->m_MaxAge) {
+            expectedPoints.push_back(to_average_position(*possible));
         }
 
-        if (3 == liked.size()) {
+        if (3 == expectedPoints.size()) {
             break;
         }
     }
 
     // Need at least two blocks.
-    if (2 > liked.size()) {
+    if (2 > expectedPoints.size()) {
         return std::numeric_limits<int>::max();
     }
 
-    std::vector<LayoutDetector::Point> expectedPoints;
-
-    for (auto stats: liked) {
-        expectedPoints.push_back(to_average_position(stats));
-    }
-
-    return compute_layout_error(actualPoints, expectedPoints);
+    return compute_layout_error(ActualPoints(), expectedPoints);
 }
 
 void LayoutDetector::ProcessBlocks(const std::vector<PixyBlock> &blocks) {
-    std::set<int> visited;
-
     for (auto& block : blocks) {
-        if (ProcessBlock(block)) {
-            visited.insert(block.m_Index);
-        }
+        ProcessBlock(block);
     }
 
-    std::set<int> notFound;
+    // Throw away blocks that didn't update.  There are only a handful, so
+    // searching again is cheaper than building sets every loop.
+    for (std::size_t index = 0; index < possibles.size(); index++) {
+        if (!possibles[index]) continue;
 
-    // Find blocks that didn't update.
-    for (auto pair : possibles) {
-        if (visited.end() == visited.find(pair.first)) {
-            notFound.insert(pair.first);
-        }
-    }
+        bool updated = std::any_of(blocks.begin(), blocks.end(), [&](const PixyBlock &block) {
+            return (uint8_t)block.m_Index == index && FilterBlock(block);
+        });
 
-    // Throw away blocks that didn't update.
-    for (auto index : notFound) {
-        possibles.erase(index);
+        if (!updated) possibles[index].reset();
     }
 }
 
@@ -112,24 +101,28 @@ bool LayoutDetector::ProcessBlock(const PixyBlock &block) {
         return false;
     }
 
+    auto &possible = possibles[(uint8_t)block.m_Index];
+
     // If possibles lacks this block...
-    if (possibles.end() != possibles.find(block.m_Index)) {
+    if (!possible) {
         // Add the block to possibles.
-        possibles[block.m_Index] = BlockStats(block);
+        possible = BlockStats(block);
     } else {
         // Update the stats of the possible with this block.
-        possibles[block.m_Index].Update(block);
+        possible->Update(block);
     }
 
     return true;
 }
 
 void LayoutDetector::Reset() {
-    possibles.clear();
+    for (auto &possible : possibles) {
+        possible.reset();
+    }
 }
 
 
-std::vector<LayoutDetector::Point> PathARedDetector::ActualPoints() {
+const std::vector<LayoutDetector::Point> &PathARedDetector::ActualPoints() {
     static std::vector<LayoutDetector::Point> actualPoints = {
         LayoutDetector::Point(166, 136),
         LayoutDetector::Point(231, 91),
@@ -139,7 +132,7 @@ std::vector<LayoutDetector::Point> PathARedDetector::ActualPoints() {
     return actualPoints;
 }
 
-std::vector<LayoutDetector::Point> PathABlueDetector::ActualPoints() {
+const std::vector<LayoutDetector::Point> &PathABlueDetector::ActualPoints() {
     static std::vector<LayoutDetector::Point> actualPoints = {
         LayoutDetector::Point(271, 83),
         LayoutDetector::Point(115, 72),
@@ -149,7 +142,7 @@ std::vector<LayoutDetector::Point> PathABlueDetector::ActualPoints() {
     return actualPoints;
 }
 
-std::vector<LayoutDetector::Point> PathBRedDetector::ActualPoints() {
+const std::vector<LayoutDetector::Point> &PathBRedDetector::ActualPoints() {
     static std::vector<LayoutDetector::Point> actualPoints = {
         LayoutDetector::Point(36, 136),
         LayoutDetector::Point(231, 91),
@@ -159,7 +152,7 @@ std::vector<LayoutDetector::Point> PathBRedDetector::ActualPoints() {
     return actualPoints;
 }
 
-std::vector<LayoutDetector::Point> PathBBlueDetector::ActualPoints() {
+const std::vector<LayoutDetector::Point> &PathBBlueDetector::ActualPoints() {
     static std::vector<LayoutDetector::Point> actualPoints = {
         LayoutDetector::Point(217, 81),
         LayoutDetector::Point(191, 64),
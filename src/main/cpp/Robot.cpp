@@ -1,33 +1,58 @@
 #include "Robot.h"
 
 #include <cmath>
-#include <frc/smartdashboard/SmartDashboard.h>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
 #include <frc2/command/CommandScheduler.h>
 #include <frc/DriverStation.h>
+#include <frc/simulation/DriverStationSim.h>
+#include <frc/simulation/SimHooks.h>
+#include <units/time.h>
 
-void Robot::RobotInit () {}
+#include "instrumentation/LoopTiming.h"
+#include "sim/AutoSimulation.h"
+#include "util/RateScheduler.h"
+#include "util/Realtime.h"
+#include "util/Telemetry.h"
+
+void Robot::RobotInit () {
+    RateScheduler::GetInstance().Install(this);
+
+    Realtime::Start();
+}
 
 void Robot::RobotPeriodic () {
-    frc2::CommandScheduler::GetInstance().Run();
+    LoopTiming::StartLoop();
 
-    m_container.PollInput();
+    {
+        LOOP_TIMER("RateScheduler.Run");
+        RateScheduler::GetInstance().Run();
+    }
 
-    // hal::fpga_clock::time_point now = hal::fpga_clock::now();
-    // m_DeltaTime = std::chrono::duration_cast<std::chrono::microseconds>(now - m_timePrev).count() / 1000000.0;
-    // m_timePrev = now;
+    // Before the scheduler, so commands see this loop's input.
+    {
+        LOOP_TIMER("RobotContainer.PollInput");
+        m_container.PollInput();
+    }
+
+    {
+        LOOP_TIMER("CommandScheduler.Run");
+        frc2::CommandScheduler::GetInstance().Run();
+    }
 
-    // Update rate (for logging)
-    static int c = 0;
-    if (c >= 50) {
-        //std::cout << "Update Rate: " << roundf(1/m_DeltaTime) << " Hz" << std::endl;
-        c = 0;
+    {
+        LOOP_TIMER("Telemetry.Flush");
+        Telemetry::Flush();
     }
-    c++;
 
     // ProfileShooterPID();
 }
 
 void Robot::AutonomousInit () {
+    Realtime::ReportFaults("auto");
+    m_container.StartInputLog();
+
     m_autonomousCommand = m_container.GetAutonomousCommand();
 
     if (m_autonomousCommand != nullptr) {
@@ -38,6 +63,9 @@ void Robot::AutonomousInit () {
 void Robot::AutonomousPeriodic () {}
 
 void Robot::TeleopInit () {
+    Realtime::ReportFaults("teleop");
+    m_container.StartInputLog();
+
     // This makes sure that the autonomous stops running when
     // teleop starts running. If you want the autonomous to
     // continue until interrupted by another command, remove
@@ -49,8 +77,10 @@ void Robot::TeleopInit () {
 }
 
 void Robot::TeleopPeriodic() {
+    LOOP_TIMER("Robot.TeleopPeriodic");
+
     std::string gameData = frc::DriverStation::GetInstance().GetGameSpecificMessage();
-    std::string color = "none";
+    const char* color = "none";
     if (gameData.length() > 0) {
         switch (gameData[0]) {
             case 'B':
@@ -67,15 +97,73 @@ void Robot::TeleopPeriodic() {
                 break;
         }
     }
-    frc::SmartDashboard::PutString("Control Panel Color", color);
+    m_ControlPanelColor.Set(color);
 }
 
 void Robot::TestPeriodic () {}
 
-void Robot::DisabledInit () {}
+void Robot::DisabledInit () {
+    Realtime::ReportFaults("disabled");
+    m_container.StopInputLog();
+}
 
 void Robot::DisabledPeriodic () {
+    LOOP_TIMER("Robot.DisabledPeriodic");
+
     m_container.ReportSelectedAuto();
+    m_container.PrepareSelectedAuto();
+}
+
+void Robot::SimulationInit () {
+    // Replays and headless autos run as fast as the code can go, stepping the
+    // clock instead of waiting for it.
+    if (nullptr != m_container.GetInputReplay() || nullptr != m_container.GetAutoSimulation()) {
+        frc::sim::PauseTiming();
+        frc::sim::DriverStationSim::SetDsAttached(true);
+
+        // StepTiming stops at every notifier alarm on the way and waits for
+        // its callbacks, so the drivetrain's fast loop runs at its own
+        // timestamps between robot loops, not four times at once.  It waits
+        // on this thread, so it needs its own.
+        units::second_t step = RateScheduler::GetInstance().GetFastestPeriod();
+        std::thread([step] {
+            while (true) {
+                frc::sim::StepTiming(step);
+            }
+        }).detach();
+    }
+}
+
+void Robot::SimulationPeriodic () {
+    m_container.GetSimulation()->Update();
+
+    AutoSimulation* autoSimulation = m_container.GetAutoSimulation();
+    if (nullptr != autoSimulation) {
+        if (!autoSimulation->Periodic()) {
+            std::exit(0);
+        }
+
+        return;
+    }
+
+    ReplayInput* replay = m_container.GetInputReplay();
+    if (nullptr == replay) return;
+
+    if (replay->IsFinished()) {
+        std::cout << "input replay: finished " << replay->GetLoopCount() << " loops" << std::endl;
+        std::exit(0);
+    }
+
+    // Follow the drivers between disabled, auto and teleop.  Takes effect on
+    // the next loop, the same as a real mode change.
+    InputLog::Mode mode = replay->GetMode();
+    if (mode != m_ReplayMode) {
+        frc::sim::DriverStationSim::SetEnabled(InputLog::kDisabled != mode);
+        frc::sim::DriverStationSim::SetAutonomous(InputLog::kAutonomous == mode);
+        frc::sim::DriverStationSim::SetTest(InputLog::kTest == mode);
+        frc::sim::DriverStationSim::NotifyNewData();
+        m_ReplayMode = mode;
+    }
 }
 
 void Robot::ProfileShooterPID () {
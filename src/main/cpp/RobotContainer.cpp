@@ -1,12 +1,16 @@
 #include "RobotContainer.h"
 
+#include <cstdlib>
 #include <iostream>
 #include <units/angular_velocity.h>
+#include <units/length.h>
 
 #include <cameraserver/CameraServer.h>
 
+#include <frc/DriverStation.h>
+#include <frc/geometry/Translation2d.h>
+#include <frc/RobotBase.h>
 #include <frc/smartdashboard/SmartDashboard.h>
-#include <frc2/command/button/JoystickButton.h>
 #include <frc2/command/CommandScheduler.h>
 #include <frc2/command/FunctionalCommand.h>
 #include <frc2/command/InstantCommand.h>
@@ -18,6 +22,11 @@
 #include <frc2/command/WaitUntilCommand.h>
 
 #include "Units.h"
+#include "sim/AutoSimulation.h"
+#include "subsystems/DrivetrainHardware.h"
+#include "subsystems/ShooterHardware.h"
+#include "util/Deploy.h"
+#include "util/Realtime.h"
 
 #include "commands/AimCommand.h"
 #include "commands/AimShootCommand.h"
@@ -25,13 +34,12 @@
 #include "commands/autonomous/AutonomousRotateTurretCommand.h"
 #include "commands/DriveUntilWallCommand.h"
 #include "commands/FollowPolybezier.h"
+#include "commands/WaitForCommand.h"
 
 #include "commands/challenge/PickupCellsCommand.h"
 #include "commands/challenge/TestPixycamDetectorCommand.h"
 #include "commands/challenge/TestPixycamPositionCommand.h"
 
-using JoystickHand = frc::GenericHID::JoystickHand;
-
 enum Pov {
     POV_RIGHT = 90,
     POV_LEFT = 270,
@@ -39,18 +47,57 @@ enum Pov {
     POV_DOWN = 180,
 };
 
+// The trench runs drive back until they are this close to where they
+// started, then slow down onto the line.
+#define kLineSlowdownDistance 0.5_m
+
+// When the running autonomous routine started, for reporting how long it took.
+static hal::fpga_clock::time_point autoStartTime;
+
 RobotContainer::RobotContainer () {
-    std::shared_ptr<cpptoml::table> toml = LoadConfig("/home/lvuser/deploy/" + ConfigFiles::ConfigFile);
+    std::shared_ptr<cpptoml::table> toml = LoadConfig(Deploy::path(ConfigFiles::ConfigFile));
+
+    // Before any of the threads it raises start.
+    Realtime::Configure(toml->get_table("realtime"));
 
-    m_Drivetrain = new Drivetrain(toml->get_table("drivetrain"));
+    DrivetrainIO* drivetrainIO;
+    ShooterIO* shooterIO;
+    if (frc::RobotBase::IsSimulation()) {
+        m_Simulation = new RobotSimulation(toml, LoadConfig(Deploy::path(ConfigFiles::SimConfigFile)));
+        drivetrainIO = m_Simulation->GetDrivetrain();
+        shooterIO = m_Simulation->GetShooter();
+    } else {
+        drivetrainIO = new DrivetrainHardware();
+        shooterIO = new ShooterHardware();
+    }
+
+    m_Drivetrain = new Drivetrain(toml->get_table("drivetrain"), drivetrainIO);
     m_Intake = new Intake(toml->get_table("intake"));
     m_Climb = new Climb();
-    m_Shooter = new Shooter(toml->get_table("shooter"));
+    m_Shooter = new Shooter(toml->get_table("shooter"), shooterIO);
     m_ControlPanel = new ControlPanel(toml->get_table("controlPanel"));
-    m_PowerCellCounter = new PowerCellCounter();
+    m_PowerCellCounter = new PowerCellCounter(m_Intake, toml->get_table("conveyor"));
 
     m_Pixy = new Pixycam();
 
+    FollowPolybezier::ConfigureFollowers(toml->get_table("follower"));
+
+    if (nullptr != m_Simulation) {
+        m_Simulation->SetIntake(m_Intake);
+    }
+
+    const char* replayPath = std::getenv("INPUT_REPLAY");
+    if (frc::RobotBase::IsSimulation() && nullptr != replayPath) {
+        m_InputReplay = new ReplayInput(replayPath);
+        m_InputSource = m_InputReplay;
+        std::cout << "input replay: " << m_InputReplay->GetLoopCount() << " loops from " << replayPath << std::endl;
+    } else {
+        m_InputSource = new DriverStationInput();
+    }
+
+    m_InputRecorder = new InputRecorder(frc::RobotBase::IsSimulation() ? "input-logs" : "/home/lvuser/input-logs");
+    Realtime::AddPrefault("input log queue", [=] { return m_InputRecorder->Prefault(); });
+
     auto aSpeed = rpm_t{
         toml->get_table("shooter")->get_qualified_as<double>("shootingSpeed.a").value_or(2500.0)
     };
@@ -63,13 +110,14 @@ RobotContainer::RobotContainer () {
     m_ExpelIntakeCommand        = new ExpelIntakeCommand(m_Intake);
     m_RetractIntakeCommand      = new RetractIntakeCommand(m_Intake);
     m_ExtendIntakeCommand       = new ExtendIntakeCommand(m_Intake);
-    m_TeleopDriveCommand        = new TeleopDriveCommand(m_Drivetrain, &m_DriverJoystick);
+    m_TeleopDriveCommand        = new TeleopDriveCommand(m_Drivetrain, &m_Input[ControllerPorts::kDriver]);
     m_TeleopShootCommand        = new ShootCommand(m_Shooter, m_Intake, aSpeed);
     m_TeleopSlowShootCommand    = new ShootCommand(m_Shooter, m_Intake, bSpeed);
     m_ReverseBrushesCommand     = new ReverseBrushesCommand(m_Intake);
+    m_IdleShooterCommand        = new IdleShooterCommand(m_Shooter, m_PowerCellCounter);
 
 
-    m_ControlWinchCommand   = new ControlWinchCommand(m_Climb, [=] { return m_ClimbJoystick.GetY(JoystickHand::kLeftHand); });
+    m_ControlWinchCommand   = new ControlWinchCommand(m_Climb, [=] { return m_Input[ControllerPorts::kClimb].GetAxis(Xbox::kLeftY); });
     m_RetractClimbCommand   = new RetractClimbCommand(m_Climb);
     m_ExtendClimbCommand    = new ExtendClimbCommand(m_Climb);
     m_RollClimbLeftCommand  = new RollClimbLeftCommand(m_Climb);
@@ -81,11 +129,11 @@ RobotContainer::RobotContainer () {
     m_ClimbCylinderRetractCommand = new ClimbCylinderRetractCommand(m_Climb);
 
     frc2::CommandScheduler::GetInstance().SetDefaultCommand(m_Drivetrain, *m_TeleopDriveCommand);
-    frc2::CommandScheduler::GetInstance().RegisterSubsystem(m_Shooter);
+    frc2::CommandScheduler::GetInstance().SetDefaultCommand(m_Shooter, *m_IdleShooterCommand);
     frc2::CommandScheduler::GetInstance().RegisterSubsystem(m_Intake);
     frc2::CommandScheduler::GetInstance().RegisterSubsystem(m_PowerCellCounter);
 
-    InitAutonomousChooser();
+    InitAutonomousChooser(toml);
     frc::SmartDashboard::PutData("Auto Modes", &m_DashboardAutoChooser);
 
     // Configure the button bindings
@@ -95,166 +143,174 @@ RobotContainer::RobotContainer () {
     cameraServer->StartAutomaticCapture();
 
     m_Drivetrain->SetBrake(false);
+
+    const char* autoSimRoutines = std::getenv("AUTO_SIM");
+    if (nullptr != m_Simulation && nullptr == m_InputReplay && nullptr != autoSimRoutines) {
+        m_AutoSimulation = new AutoSimulation(*this, autoSimRoutines);
+    }
 }
 
 frc2::Command* RobotContainer::GetAutonomousCommand () {
-    return m_DashboardAutoChooser.GetSelected();
+    std::string name = GetSelectedAutoName();
+
+    // Wait for a build still in progress, in case it is this one.
+    if (m_AutoBuild.valid()) {
+        m_AutoCache[m_AutoBuildName] = m_AutoBuild.get();
+    }
+
+    // Selected too late to be built while disabled.
+    if (0 == m_AutoCache.count(name) && 0 != m_AutoFactories.count(name)) {
+        m_AutoCache[name] = m_AutoFactories[name]();
+    }
+
+    return m_AutoCache[name];
 }
 
 void RobotContainer::PollInput () {
+    m_Input.Update(*m_InputSource);
+
+    auto &ds = frc::DriverStation::GetInstance();
+    InputLog::Mode mode = InputLog::kDisabled;
+    if (ds.IsEnabled()) {
+        mode = ds.IsAutonomous() ? InputLog::kAutonomous : (ds.IsTest() ? InputLog::kTest : InputLog::kTeleop);
+    }
+    m_InputRecorder->Record(m_Input, mode);
+
+    m_Bindings.Evaluate(m_Input);
+}
+
+void RobotContainer::StartInputLog () {
+    // Don't record a replay of a recording, or a headless run with no input.
+    if (nullptr != m_InputReplay || nullptr != m_AutoSimulation) return;
+
+    m_InputRecorder->Start();
+}
+
+void RobotContainer::StopInputLog () {
+    m_InputRecorder->Stop();
+}
+
+void RobotContainer::ConfigureButtonBindings () {
+    using namespace ControllerPorts;
+    using Input::Button;
+    using Input::POV;
+
     // ####################
     // #####  Driver  #####
     // ####################
 
     // Retract Intake (X)
-    if (m_DriverJoystick.GetXButtonPressed()) {
+    m_Bindings.OnPress(Button(kDriver, Xbox::kX), [=] {
         m_RetractIntakeCommand->Schedule();
         m_IntakeExtended = false;
-    }
+    });
 
     // Brake (RB)
-    if (m_DriverJoystick.GetBumperPressed(JoystickHand::kRightHand)) {
-        m_Drivetrain->SetBrake(false);
-    } else if (m_DriverJoystick.GetBumperReleased(JoystickHand::kRightHand)) {
-        m_Drivetrain->SetBrake(true);
-    }
+    m_Bindings.OnPressRelease(Button(kDriver, Xbox::kRightBumper),
+        [=] { m_Drivetrain->SetBrake(false); },
+        [=] { m_Drivetrain->SetBrake(true); });
 
     // ####################
     // #####   Both   #####
     // ####################
 
-    // Shooting (driver: RB, operator: A)
-    if (m_DriverJoystick.GetAButtonPressed() || m_OperatorJoystick.GetAButtonPressed()) {
-        m_TeleopShootCommand->Schedule();
-    } else if (m_DriverJoystick.GetAButtonReleased() || m_OperatorJoystick.GetAButtonReleased()) {
-        m_TeleopShootCommand->Cancel();
-    }
+    // Shooting (driver: A, operator: A)
+    m_Bindings.OnPressRelease(
+        [](const InputSnapshot &input) { return input[kDriver].GetButton(Xbox::kA) || input[kOperator].GetButton(Xbox::kA); },
+        [=] { m_TeleopShootCommand->Schedule(); },
+        [=] { m_TeleopShootCommand->Cancel(); });
 
     // Slow shooting (operator: B)
-    if (m_OperatorJoystick.GetBButtonPressed()) {
-        m_TeleopSlowShootCommand->Schedule();
-    } else if (m_OperatorJoystick.GetBButtonReleased()) {
-        m_TeleopSlowShootCommand->Cancel();
-    }
+    m_Bindings.OnPressRelease(Button(kOperator, Xbox::kB),
+        [=] { m_TeleopSlowShootCommand->Schedule(); },
+        [=] { m_TeleopSlowShootCommand->Cancel(); });
 
-    // Intake (driver: LB, operator: RT)
-    bool intakeAxis = m_OperatorJoystick.GetTriggerAxis(JoystickHand::kRightHand) > 0.1;
-    if (intakeAxis && !m_IntakeBallsCommand->IsScheduled()) {
-        m_IntakeBallsCommand->Schedule();
-    } else if (intakeAxis <= 0.1 && m_IntakeBallsCommand->IsScheduled()) {
-        m_IntakeBallsCommand->Cancel();
-    }
+    // Intake (operator: RT)
+    m_Bindings.WhileHeld(
+        [](const InputSnapshot &input) { return input[kOperator].GetAxis(Xbox::kRightTrigger) > 0.1; },
+        m_IntakeBallsCommand);
 
     // ####################
     // ##### Operator #####
     // ####################
 
-    // Camera Aiming (X)
-    if (m_OperatorJoystick.GetXButtonPressed() || m_OperatorJoystick.GetYButtonPressed() || m_DriverJoystick.GetXButtonPressed()) {
-        m_Shooter->SetTrackingMode(TrackingMode::CameraTracking);
-    } else if (m_OperatorJoystick.GetXButtonReleased() || m_OperatorJoystick.GetYButtonReleased() || m_DriverJoystick.GetXButtonReleased()) {
-        m_Shooter->ResetTurretPID();
-        m_Shooter->SetTrackingMode(TrackingMode::Off);
-    }
+    // Camera Aiming (operator: X or Y, driver: X)
+    m_Bindings.OnPressRelease(
+        [](const InputSnapshot &input) {
+            return input[kOperator].GetButton(Xbox::kX) || input[kOperator].GetButton(Xbox::kY) || input[kDriver].GetButton(Xbox::kX);
+        },
+        [=] { m_Shooter->SetTrackingMode(TrackingMode::CameraTracking); },
+        [=] {
+            m_Shooter->ResetTurretPID();
+            m_Shooter->SetTrackingMode(TrackingMode::Off);
+        });
 
     // Control Panel Deploy (LB)
-    if (m_OperatorJoystick.GetBumperPressed(JoystickHand::kLeftHand)) {
-        m_ControlPanel->Extend();
-    } else if (m_OperatorJoystick.GetBumperReleased(JoystickHand::kLeftHand)) {
-        m_ControlPanel->Retract();
-    }
+    m_Bindings.OnPressRelease(Button(kOperator, Xbox::kLeftBumper),
+        [=] { m_ControlPanel->Extend(); },
+        [=] { m_ControlPanel->Retract(); });
 
     // Left Stick
-    double operatorLeftX = m_OperatorJoystick.GetX(JoystickHand::kLeftHand);
-    if (m_OperatorJoystick.GetBumper(JoystickHand::kLeftHand)) {
-        // Control Panel Manual Control
-        m_ControlPanel->SetSpeed(operatorLeftX);
-    } else {
-        // Manual Aiming
-        if (std::fabs(operatorLeftX) > 0.15) {
-            operatorLeftX = std::copysign(std::sqrt(std::fabs(operatorLeftX)), operatorLeftX);
-            m_Shooter->SetTrackingMode(TrackingMode::Off);
-            m_Shooter->SetTurretSpeed(operatorLeftX * 15_rpm);
-            m_TurretManualControl = true;
-        } else if (m_TurretManualControl) {
-            m_Shooter->SetTurretSpeed(0_rpm);
-            m_TurretManualControl = false;
-        }
-    }
-
-    // Deploy/Retract Intake (RB)
-    if (m_OperatorJoystick.GetBumperPressed(JoystickHand::kRightHand) && !m_DriverJoystick.GetXButton()) {
-        if (m_Intake->IsExtended()) {
-            m_RetractIntakeCommand->Schedule();
+    m_Bindings.Always([=](const InputSnapshot &input) {
+        double operatorLeftX = input[kOperator].GetAxis(Xbox::kLeftX);
+        if (input[kOperator].GetButton(Xbox::kLeftBumper)) {
+            // Control Panel Manual Control
+            m_ControlPanel->SetSpeed(operatorLeftX);
         } else {
-            m_ExtendIntakeCommand->Schedule();
+            // Manual Aiming
+            if (std::fabs(operatorLeftX) > 0.15) {
+                operatorLeftX = std::copysign(std::sqrt(std::fabs(operatorLeftX)), operatorLeftX);
+                m_Shooter->SetTrackingMode(TrackingMode::Off);
+                m_Shooter->SetTurretSpeed(operatorLeftX * 15_rpm);
+                m_TurretManualControl = true;
+            } else if (m_TurretManualControl) {
+                m_Shooter->SetTurretSpeed(0_rpm);
+                m_TurretManualControl = false;
+            }
         }
-    }
+    });
+
+    // Deploy/Retract Intake (RB), unless the driver is retracting it
+    m_Bindings.OnPress(
+        [](const InputSnapshot &input) { return input[kOperator].GetButtonPressed(Xbox::kRightBumper) && !input[kDriver].GetButton(Xbox::kX); },
+        [=] {
+            if (m_Intake->IsExtended()) {
+                m_RetractIntakeCommand->Schedule();
+            } else {
+                m_ExtendIntakeCommand->Schedule();
+            }
+        });
 
     // Expel Intake (DP Left)
-    if (POV_LEFT == m_OperatorJoystick.GetPOV() && !m_ExpelIntakeCommand->IsScheduled()) {
-        m_ExpelIntakeCommand->Schedule();
-    } else if (POV_LEFT != m_OperatorJoystick.GetPOV() && m_ExpelIntakeCommand->IsScheduled()) {
-        m_ExpelIntakeCommand->Cancel();
-    }
+    m_Bindings.WhileHeld(POV(kOperator, POV_LEFT), m_ExpelIntakeCommand);
 
     // Reverse Brushes (DP Right)
-    if (POV_RIGHT == m_OperatorJoystick.GetPOV() && !m_ReverseBrushesCommand->IsScheduled()) {
-        m_ReverseBrushesCommand->Schedule();
-    } else if (POV_RIGHT != m_OperatorJoystick.GetPOV() && m_ReverseBrushesCommand->IsScheduled()) {
-        m_ReverseBrushesCommand->Cancel();
-    }
+    m_Bindings.WhileHeld(POV(kOperator, POV_RIGHT), m_ReverseBrushesCommand);
 
     // ####################
     // #####  Climb   #####
     // ####################
 
     // Climb Winch (LS)
-    if (std::abs(m_ClimbJoystick.GetY(frc::GenericHID::JoystickHand::kLeftHand)) > 0.2) {
-        if (!m_ControlWinchCommand->IsScheduled()) m_ControlWinchCommand->Schedule(true); // interruptible
-    } else {
-        if (m_ControlWinchCommand->IsScheduled()) m_ControlWinchCommand->Cancel();
-    }
+    m_Bindings.WhileHeld(
+        [](const InputSnapshot &input) { return std::abs(input[kClimb].GetAxis(Xbox::kLeftY)) > 0.2; },
+        m_ControlWinchCommand);
 
     // Climb Roll (Driver Dpad)
-    if (m_DriverJoystick.GetPOV() == POV_RIGHT) { // Right
-        if (!m_RollClimbRightCommand->IsScheduled()) {
-            m_RollClimbRightCommand->Schedule();
-        }
-    } else if (m_DriverJoystick.GetPOV() == POV_LEFT) { // Left
-        if (!m_RollClimbLeftCommand->IsScheduled()) {
-            m_RollClimbLeftCommand->Schedule();
-        }
-    } else {
-        m_RollClimbLeftCommand->Cancel();
-        m_RollClimbRightCommand->Cancel();
-    }
+    m_Bindings.WhileHeld(POV(kDriver, POV_RIGHT), m_RollClimbRightCommand);
+    m_Bindings.WhileHeld(POV(kDriver, POV_LEFT), m_RollClimbLeftCommand);
 
     // Climb Lock Winch (B)
-    if (m_ClimbJoystick.GetBButtonPressed()) {
-        m_LockWinchCommand->Schedule();
-    }
+    m_Bindings.OnPress(Button(kClimb, Xbox::kB), [=] { m_LockWinchCommand->Schedule(); });
 
     // Climb Unlock Winch (Y)
-    if (m_ClimbJoystick.GetYButtonPressed()) {
-        m_UnlockWinchCommand->Schedule();
-    }
+    m_Bindings.OnPress(Button(kClimb, Xbox::kY), [=] { m_UnlockWinchCommand->Schedule(); });
 
     // Climb Cylinder Retract (A)
-    if (m_ClimbJoystick.GetAButtonPressed()) {
-        m_ClimbCylinderExtendCommand->Schedule();
-    }
+    m_Bindings.OnPress(Button(kClimb, Xbox::kA), [=] { m_ClimbCylinderExtendCommand->Schedule(); });
 
     // Climb Cylinder Extend (X)
-    if (m_ClimbJoystick.GetXButtonPressed()) {
-        m_ClimbCylinderRetractCommand->Schedule();
-    }
-}
-
-void RobotContainer::ConfigureButtonBindings () {
-    // frc2::JoystickButton aButton{&m_DriverJoystick, 1};
-    // aButton.WhenPressed(m_VisionAimingCommand);
-    // aButton.WhenPressed(frc2::PrintCommand("Testing")).WhenReleased(frc2::PrintCommand("Released"));
+    m_Bindings.OnPress(Button(kClimb, Xbox::kX), [=] { m_ClimbCylinderRetractCommand->Schedule(); });
 }
 
 std::shared_ptr<cpptoml::table> RobotContainer::LoadConfig (std::string path) {
@@ -266,230 +322,321 @@ std::shared_ptr<cpptoml::table> RobotContainer::LoadConfig (std::string path) {
     }
 }
 
-void RobotContainer::InitAutonomousChooser () {
-    const rpm_t kShooterSpeed = 3750_rpm;
+void RobotContainer::InitAutonomousChooser (std::shared_ptr<cpptoml::table> toml) {
+    FollowPolybezier::Configuration followerConfig = FollowPolybezier::ReadConfiguration(toml->get_table("follower"));
+
+    // Parse and approximate every deployed path on the worker pool now, so
+    // the followers find them ready.
+    PreloadPaths(Deploy::path("paths"), followerConfig);
+
+    AddAutonomous("follow path - barrel racing", [=] {
+        FollowPolybezier barrel_racing_follower {m_Drivetrain, Deploy::path("paths/autonav6.json"), followerConfig};
+
+        return new frc2::SequentialCommandGroup(
+            FollowPolybezier::ResetPoseCommand(m_Drivetrain, barrel_racing_follower.GetPath()),
+            std::move(barrel_racing_follower)
+        );
+    });
+
+    AddAutonomous("follow path - bounce", [=] {
+        // One path, reversing at each marker.
+        FollowPolybezier bounce_follower {m_Drivetrain, Deploy::path("paths/bounce.json"), followerConfig};
+
+        return new frc2::SequentialCommandGroup(
+            FollowPolybezier::ResetPoseCommand(m_Drivetrain, bounce_follower.GetPath()),
+            std::move(bounce_follower)
+        );
+    });
+
+    AddAutonomous("follow path - test", [=] {
+        FollowPolybezier test_follower {m_Drivetrain, Deploy::path("paths/testPath.json"), followerConfig, true};
+
+        return new frc2::SequentialCommandGroup(
+            FollowPolybezier::ResetPoseCommand(m_Drivetrain, test_follower.GetPath()),
+            std::move(test_follower)
+        );
+    });
+
+    AddAutonomous("pickup cells : challenge", [=] {
+        return new PickupCellsCommand(
+            m_Drivetrain,
+            m_Intake,
+            m_Pixy,
+            followerConfig
+        );
+    });
+
+    AddAutonomous("test pixycam detector", [=] { return new TestPixycamDetectorCommand(m_Pixy); });
+    AddAutonomous("test pixycam position", [=] { return new TestPixycamPositionCommand(m_Pixy); });
+
+    LoadAutonomousRoutines(Deploy::path(ConfigFiles::AutoConfigFile), followerConfig);
+
+    // For trying out the follower in the simulator.
+    if (frc::RobotBase::IsSimulation()) {
+        AddPathRoutines(Deploy::path("paths"), followerConfig);
+    }
+}
 
-    frc2::SequentialCommandGroup* threeCellAutoCommand = new frc2::SequentialCommandGroup(
-        frc2::StartEndCommand {
-            [=]() { m_Shooter->SetTurretSpeed(0.8); },
-            [=]() { m_Shooter->SetTurretSpeed(0.0); },
-            m_Shooter
-        }.WithTimeout(0.5_s),
-        AimCommand{m_Shooter}.WithTimeout(2.0_s),
-        AimShootCommand{kShooterSpeed, m_Shooter, m_Intake, m_PowerCellCounter}.WithTimeout(3.5_s),
-        SimpleDriveCommand{0.25, 0.0, m_Drivetrain}.WithTimeout(1.0_s)
-    );
-
-    frc2::SequentialCommandGroup driveThruTrench {
-        // Drive thru trench picking up power cells.
-        frc2::ParallelCommandGroup{
-            frc2::SequentialCommandGroup{
-                SimpleDriveCommand{0.6 * (0.85/1.0), 0.0, m_Drivetrain}.WithTimeout(1.6_s * (1.0/0.85)),
-                // Decelerate.
-                SimpleDriveCommand{0.4, 0.0, m_Drivetrain}.WithTimeout(0.3_s),
-                SimpleDriveCommand{0.2, 0.0, m_Drivetrain}.WithTimeout(0.3_s)
-            },
-            // Run intake until 3 cells are collected, or timeout expires.
-            // frc2::ParallelRaceGroup{
-            IntakeBallsCommand{m_Intake, m_PowerCellCounter}.WithTimeout(2.5_s)
-            //     frc2::WaitUntilCommand{
-            //         [=]() { return 3 == m_PowerCellCounter->GetCount(); }
-            //     }
-            // }
-        },
-        // Reverse back to line.
-        frc2::ParallelRaceGroup{
-            SimpleDriveCommand{-0.6, 0.0, m_Drivetrain}.WithTimeout(1.6_s),
-            IntakeBallsCommand{m_Intake, m_PowerCellCounter}
-        },
-        // Decelerate.
-        SimpleDriveCommand{-0.4, 0.0, m_Drivetrain}.WithTimeout(0.3_s),
-        SimpleDriveCommand{-0.2, 0.0, m_Drivetrain}.WithTimeout(0.4_s)
+void RobotContainer::LoadAutonomousRoutines (std::string path, FollowPolybezier::Configuration followerConfig) {
+    using Params = RoutineCompiler::Params;
+
+    // For aimShoot, shoot and waitFor flywheelReady without an rpm.
+    const rpm_t shooterSpeed = m_Shooter->GetAutoSpeed();
+
+    auto number = [](const Params &params, const std::string &key, double fallback) {
+        return params->get_as<double>(key).value_or(fallback);
     };
 
-    static hal::fpga_clock::time_point startTime;
+    auto flag = [](const Params &params, const std::string &key, bool fallback) {
+        return params->get_as<bool>(key).value_or(fallback);
+    };
 
-    frc2::SequentialCommandGroup* sixCellAutoCommand = new frc2::SequentialCommandGroup(
-        frc2::InstantCommand{
-            [=]() {
-                startTime = hal::fpga_clock::now();
-                m_Shooter->SetLimelightLight(true);
-            }
-        },
-        ExtendIntakeCommand{m_Intake},
-        PreheatShooterCommand{m_Shooter},
-        AutonomousRotateTurretCommand{m_Shooter}.WithTimeout(0.3_s),
-        AimCommand{m_Shooter}.WithTimeout(1.0_s),
-        AimShootCommand{kShooterSpeed, m_Shooter, m_Intake, m_PowerCellCounter}.WithTimeout(4.0_s),
-        std::move(driveThruTrench),
-        PreheatShooterCommand{m_Shooter},
-        AimCommand{m_Shooter}.WithTimeout(0.5_s),
-        AimShootCommand{kShooterSpeed, m_Shooter, m_Intake, m_PowerCellCounter}.WithTimeout(4.0_s),
-        // RetractIntakeCommand{m_Intake},
-        frc2::InstantCommand{
-            [=] {
-                auto now = hal::fpga_clock::now();
-                auto delta = std::chrono::duration_cast<std::chrono::microseconds>(now - startTime).count() / 1.0E6;
-                std::cout << "Auto done in " << delta << " seconds" << std::endl;
-            }
+    // Where markLine was last run, for waitFor nearLine.
+    auto line = std::make_shared<frc::Translation2d>();
+
+    // Times the routine, and turns the light on for the target search.
+    m_RoutineCompiler.Register("startAuto", [=](const Params &params) {
+        return std::make_unique<frc2::InstantCommand>([=]() {
+            autoStartTime = hal::fpga_clock::now();
+            m_Shooter->SetLimelightLight(true);
+        });
+    });
+
+    // Prints how long the routine took since startAuto.
+    m_RoutineCompiler.Register("reportTime", [=](const Params &params) {
+        return std::make_unique<frc2::InstantCommand>([=]() {
+            auto delta = std::chrono::duration_cast<std::chrono::microseconds>(hal::fpga_clock::now() - autoStartTime).count() / 1.0E6;
+            std::cout << "Auto done in " << delta << " seconds" << std::endl;
+        });
+    });
+
+    m_RoutineCompiler.Register("markLine", [=](const Params &params) {
+        return std::make_unique<frc2::InstantCommand>([=]() { *line = m_Drivetrain->GetPose().Translation(); });
+    });
+
+    // { command = "drive", speed = 0.25, turn = 0.0 }
+    m_RoutineCompiler.Register("drive", [=](const Params &params) {
+        return std::make_unique<SimpleDriveCommand>(number(params, "speed", 0.0), number(params, "turn", 0.0), m_Drivetrain);
+    });
+
+    m_RoutineCompiler.Register("driveUntilWall", [=](const Params &params) {
+        return std::make_unique<DriveUntilWallCommand>(m_Drivetrain);
+    });
+
+    // { command = "path", file = "slalom.json", backwards = false, resetPose = false, follower = "ramsete" }
+    // file is relative to the deployed paths directory.  follower overrides
+    // the one [follower] in config.toml picks for the file.
+    m_RoutineCompiler.Register("path", [=](const Params &params) -> std::unique_ptr<frc2::Command> {
+        auto file = params->get_as<std::string>("file").value_or("");
+
+        std::optional<Follower::Kind> kind;
+        if (auto name = params->get_as<std::string>("follower")) {
+            kind = Follower::ParseKind(*name);
+            if (!kind) std::cerr << "path: unknown follower \"" << *name << "\"" << std::endl;
         }
-    );
 
-    frc2::SequentialCommandGroup positionBot {
-        SimpleDriveCommand{-0.4, 0.0, m_Drivetrain}.WithTimeout(1.0_s),
-        DriveUntilWallCommand{m_Drivetrain},
-        SimpleDriveCommand{0.1, 0.0, m_Drivetrain}.WithTimeout(0.1_s)
-    };
+        auto follower = std::make_unique<FollowPolybezier>(
+            m_Drivetrain, Deploy::path("paths/" + file), followerConfig, flag(params, "backwards", false), kind
+        );
 
-    frc2::SequentialCommandGroup* closeShotAutoCommand = new frc2::SequentialCommandGroup(
-        AutonomousRotateTurretCommand{m_Shooter}.WithTimeout(0.5_s),
-        AimCommand{m_Shooter}.WithTimeout(1.0_s),
-        PreheatShooterCommand{m_Shooter},
-        std::move(positionBot),
-        ShootCommand{m_Shooter, m_Intake, 2700_rpm}.WithTimeout(4.0_s)
-    );
-
-    FollowPolybezier::Configuration followerConfig {
-        5.0,    // maximumRadialAcceleration
-        3.0,    // maximumJerk
-        8.0     // maximumReverseAcceleration
-    };
+        if (!flag(params, "resetPose", false)) return follower;
 
-    auto getResetPose = [=](Point::Point p) {
-        return frc2::InstantCommand {
-            [=]() {
-                m_Drivetrain->SetPose(p.x, p.y, 0);
-            }
-        };
-    };
+        std::vector<std::unique_ptr<frc2::Command>> steps;
+        steps.push_back(std::make_unique<frc2::InstantCommand>(FollowPolybezier::ResetPoseCommand(m_Drivetrain, follower->GetPath())));
+        steps.push_back(std::move(follower));
+        return std::make_unique<frc2::SequentialCommandGroup>(std::move(steps));
+    });
 
-    FollowPolybezier barrel_racing_follower {m_Drivetrain, "/home/lvuser/deploy/paths/autonav6.json", followerConfig};
-    FollowPolybezier slalom_follower {m_Drivetrain, "/home/lvuser/deploy/paths/autonav-slalom-4.json", followerConfig};
-    FollowPolybezier test_follower {m_Drivetrain, "/home/lvuser/deploy/paths/testPath.json", followerConfig, true};
-
-    FollowPolybezier bounce_follower_a {m_Drivetrain, "/home/lvuser/deploy/paths/bounce-a.json", followerConfig};
-    FollowPolybezier bounce_follower_b {m_Drivetrain, "/home/lvuser/deploy/paths/bounce-b.json", followerConfig, true};
-    FollowPolybezier bounce_follower_c {m_Drivetrain, "/home/lvuser/deploy/paths/bounce-c.json", followerConfig};
-    FollowPolybezier bounce_follower_d {m_Drivetrain, "/home/lvuser/deploy/paths/bounce-d.json", followerConfig, true};
-
-    frc2::SequentialCommandGroup* followPathBR = new frc2::SequentialCommandGroup(
-        getResetPose(barrel_racing_follower.GetStartPoint()),
-        std::move(barrel_racing_follower)
-    );
-
-    frc2::SequentialCommandGroup* followPathS = new frc2::SequentialCommandGroup(
-        getResetPose(slalom_follower.GetStartPoint()),
-        std::move(slalom_follower)
-    );
-
-    frc2::SequentialCommandGroup* followPathBounce = new frc2::SequentialCommandGroup(
-        getResetPose(bounce_follower_a.GetStartPoint()),
-        std::move(bounce_follower_a),
-        std::move(bounce_follower_b),
-        std::move(bounce_follower_c),
-        std::move(bounce_follower_d)
-    );
-
-    frc2::SequentialCommandGroup* followPathTest = new frc2::SequentialCommandGroup(
-        getResetPose(test_follower.GetStartPoint()),
-        std::move(test_follower)
-    );
-
-    PickupCellsCommand* pickupCellsChallenge = new PickupCellsCommand(
-        m_Drivetrain,
-        m_Intake,
-        m_Pixy,
-        followerConfig
-    );
-
-    frc2::SequentialCommandGroup driveThroughTrenchFar {
-        // Drive through trench picking up power cells
-        frc2::ParallelRaceGroup{
-            frc2::SequentialCommandGroup{
-                SimpleDriveCommand{0.3, 0.0, m_Drivetrain}.WithTimeout(4.7_s),
-                SimpleDriveCommand{0.2, 0.0, m_Drivetrain}.WithTimeout(0.4_s)
-            },
-            IntakeBallsCommand{m_Intake, m_PowerCellCounter}
-        },
-        // Reverse back to line
-        frc2::ParallelRaceGroup{
-            frc2::ParallelCommandGroup{
-                SimpleDriveCommand{-0.6, -0.02, m_Drivetrain}.WithTimeout(2.1_s),
-                AutonomousRotateTurretCommand{m_Shooter}.WithTimeout(0.5_s),
-            },
-            IntakeBallsCommand{m_Intake, m_PowerCellCounter},
-        },
-        // Decelerate
-        frc2::ParallelRaceGroup{
-            SimpleDriveCommand{-0.4, 0.0, m_Drivetrain}.WithTimeout(0.7_s),
-            IntakeBallsCommand{m_Intake, m_PowerCellCounter},
-            frc2::SequentialCommandGroup{
-                PreheatShooterCommand{m_Shooter},
-                AimCommand{m_Shooter}
-            }
-        },
-        frc2::ParallelRaceGroup{
-            SimpleDriveCommand{-0.2, 0.0, m_Drivetrain}.WithTimeout(0.5_s),
-            IntakeBallsCommand{m_Intake, m_PowerCellCounter},
-            AimCommand{m_Shooter}
-        },
-    };
+    m_RoutineCompiler.Register("aim", [=](const Params &params) {
+        return std::make_unique<AimCommand>(m_Shooter);
+    });
+
+    // { command = "aimShoot", rpm = 3750, moving = false }
+    // Set moving when the robot may still be driving, to lead the target.
+    m_RoutineCompiler.Register("aimShoot", [=](const Params &params) {
+        auto rpm = rpm_t{number(params, "rpm", shooterSpeed.to<double>())};
+        if (flag(params, "moving", false)) {
+            return std::make_unique<AimShootCommand>(rpm, m_Shooter, m_Intake, m_PowerCellCounter, m_Drivetrain);
+        }
+        return std::make_unique<AimShootCommand>(rpm, m_Shooter, m_Intake, m_PowerCellCounter);
+    });
+
+    // { command = "shoot", rpm = 2700 }
+    m_RoutineCompiler.Register("shoot", [=](const Params &params) {
+        return std::make_unique<ShootCommand>(m_Shooter, m_Intake, rpm_t{number(params, "rpm", shooterSpeed.to<double>())});
+    });
+
+    m_RoutineCompiler.Register("preheat", [=](const Params &params) {
+        return std::make_unique<PreheatShooterCommand>(m_Shooter);
+    });
+
+    m_RoutineCompiler.Register("rotateTurret", [=](const Params &params) {
+        return std::make_unique<AutonomousRotateTurretCommand>(m_Shooter);
+    });
+
+    // { command = "turret", speed = 0.8 }, held until the step ends.
+    m_RoutineCompiler.Register("turret", [=](const Params &params) {
+        double speed = number(params, "speed", 0.0);
+        return std::make_unique<frc2::StartEndCommand>(frc2::StartEndCommand {
+            [=]() { m_Shooter->SetTurretSpeed(speed); },
+            [=]() { m_Shooter->SetTurretSpeed(0.0); },
+            m_Shooter
+        });
+    });
+
+    // { command = "limelight", on = true }
+    m_RoutineCompiler.Register("limelight", [=](const Params &params) {
+        bool on = flag(params, "on", true);
+        return std::make_unique<frc2::InstantCommand>([=]() { m_Shooter->SetLimelightLight(on); });
+    });
+
+    m_RoutineCompiler.Register("intake", [=](const Params &params) {
+        return std::make_unique<IntakeBallsCommand>(m_Intake, m_PowerCellCounter);
+    });
+
+    m_RoutineCompiler.Register("extendIntake", [=](const Params &params) {
+        return std::make_unique<ExtendIntakeCommand>(m_Intake);
+    });
+
+    m_RoutineCompiler.Register("retractIntake", [=](const Params &params) {
+        return std::make_unique<RetractIntakeCommand>(m_Intake);
+    });
+
+    // { command = "waitFor", condition = "onTarget", cap = 2.0 }
+    // Conditions are hasTarget, onTarget, flywheelReady (with rpm),
+    // hopperEmpty, cells (with count) and nearLine (with distance, meters
+    // from markLine).
+    m_RoutineCompiler.Register("waitFor", [=](const Params &params) {
+        auto condition = params->get_as<std::string>("condition").value_or("");
+        auto cap = units::second_t{number(params, "cap", 5.0)};
+
+        std::function<bool()> ready;
+        if ("hasTarget" == condition) {
+            ready = [=] { return m_Shooter->HasTarget(); };
+        } else if ("onTarget" == condition) {
+            ready = [=] { return m_Shooter->IsOnTarget(); };
+        } else if ("flywheelReady" == condition) {
+            auto rpm = rpm_t{number(params, "rpm", shooterSpeed.to<double>())};
+            ready = [=] { return m_Shooter->IsReadyToFeed(rpm); };
+        } else if ("hopperEmpty" == condition) {
+            ready = [=] { return m_PowerCellCounter->IsHopperEmpty(); };
+        } else if ("cells" == condition) {
+            int count = (int)number(params, "count", 3);
+            ready = [=] { return count <= m_PowerCellCounter->GetCount(); };
+        } else if ("nearLine" == condition) {
+            auto distance = units::meter_t{number(params, "distance", units::meter_t{kLineSlowdownDistance}.to<double>())};
+            ready = [=] { return m_Drivetrain->GetPose().Translation().Distance(*line) < distance; };
+        } else {
+            std::cerr << "waitFor: unknown condition \"" << condition << "\", waiting out the cap" << std::endl;
+            ready = [] { return false; };
+        }
+
+        return std::make_unique<WaitForCommand>(condition, ready, cap);
+    });
 
-    frc2::SequentialCommandGroup* eightCellAutoCommand = new frc2::SequentialCommandGroup(
-        frc2::InstantCommand{
-            [=]() {
-                startTime = hal::fpga_clock::now();
-                m_Shooter->SetLimelightLight(true);
+    // { command = "print", message = "..." }
+    m_RoutineCompiler.Register("print", [=](const Params &params) {
+        return std::make_unique<frc2::PrintCommand>(params->get_as<std::string>("message").value_or(""));
+    });
+
+    for (auto &routine : m_RoutineCompiler.Load(path)) {
+        if (0 != m_AutoFactories.count(routine.name)) {
+            std::cerr << path << ": routine \"" << routine.name << "\" is already defined" << std::endl;
+            continue;
+        }
+
+        RoutineCompiler::Step step = std::move(routine.step);
+        AddAutonomous(routine.name, [=] { return m_RoutineCompiler.Compile(step).release(); }, routine.isDefault);
+    }
+}
+
+void RobotContainer::PreloadPaths (std::string directory, FollowPolybezier::Configuration followerConfig) {
+    std::vector<std::shared_future<FollowPolybezier::Path>> paths;
+    std::vector<std::shared_future<Trajectory>> trajectories;
+    for (auto &name : Deploy::listPaths(directory)) {
+        paths.push_back(FollowPolybezier::LoadPath(directory + "/" + name, followerConfig));
+        trajectories.push_back(FollowPolybezier::LoadTrajectory(directory + "/" + name, followerConfig));
+    }
+
+    // With the real-time profile, wait for every path before the match and
+    // read it through, instead of on first use.
+    Realtime::AddPrefault("paths", [paths, trajectories] {
+        volatile double sink = 0;
+        std::size_t bytes = 0;
+
+        for (auto &path : paths) {
+            for (auto &curve : path.get()) {
+                for (auto &sample : curve.samples) {
+                    sink = sink + sample.d;
+                }
+                bytes += curve.samples.size() * sizeof(FollowPolybezier::DistanceSample);
             }
-        },
-        ExtendIntakeCommand{m_Intake},
-        frc2::ParallelRaceGroup{
-            frc2::SequentialCommandGroup{
-                PreheatShooterCommand{m_Shooter},
-                AutonomousRotateTurretCommand{m_Shooter}.WithTimeout(0.3_s),
-                AimCommand{m_Shooter}.WithTimeout(1.0_s)
-            },
-            IntakeBallsCommand{m_Intake, m_PowerCellCounter},
-        },
-        AimShootCommand{kShooterSpeed, m_Shooter, m_Intake, m_PowerCellCounter}.WithTimeout(2.2_s),
-        std::move(driveThroughTrenchFar),
-        PreheatShooterCommand{m_Shooter},
-        AimCommand{m_Shooter}.WithTimeout(0.5_s),
-        AimShootCommand{kShooterSpeed, m_Shooter, m_Intake, m_PowerCellCounter}.WithTimeout(4.0_s),
-        frc2::InstantCommand{
-            [=] {
-                auto now = hal::fpga_clock::now();
-                auto delta = std::chrono::duration_cast<std::chrono::microseconds>(now - startTime).count() / 1.0E6;
-                std::cout << "Auto done in " << delta << " seconds" << std::endl;
+        }
+
+        for (auto &trajectory : trajectories) {
+            for (double time : trajectory.get().GetTimes()) {
+                sink = sink + time;
             }
+            bytes += trajectory.get().GetSize() * sizeof(Trajectory::Sample);
         }
-    );
-
-    TestPixycamDetectorCommand* testPixycamDetector = new TestPixycamDetectorCommand(m_Pixy);
-    TestPixycamPositionCommand* testPixycamPosition = new TestPixycamPositionCommand(m_Pixy);
-
-    m_DashboardAutoChooser.SetDefaultOption("3 cell auto", threeCellAutoCommand);
-    m_DashboardAutoChooser.AddOption("6 cell auto", sixCellAutoCommand);
-    m_DashboardAutoChooser.AddOption("8 cell auto", eightCellAutoCommand);
-    m_DashboardAutoChooser.AddOption("close auto", closeShotAutoCommand);
-    m_DashboardAutoChooser.AddOption("follow path - barrel racing", followPathBR);
-    m_DashboardAutoChooser.AddOption("follow path - slalom", followPathS);
-    m_DashboardAutoChooser.AddOption("follow path - bounce", followPathBounce);
-    m_DashboardAutoChooser.AddOption("follow path - test", followPathTest);
-
-    m_DashboardAutoChooser.AddOption("pickup cells : challenge", pickupCellsChallenge);
-    m_DashboardAutoChooser.AddOption("test pixycam detector", testPixycamDetector);
-    m_DashboardAutoChooser.AddOption("test pixycam position", testPixycamPosition);
+
+        return bytes;
+    });
 }
 
-void RobotContainer::ReportSelectedAuto () {
-    std::string name;
+void RobotContainer::AddPathRoutines (std::string directory, FollowPolybezier::Configuration followerConfig) {
+    for (auto &name : Deploy::listPaths(directory)) {
+        std::string file = directory + "/" + name;
 
-    if (m_DashboardAutoChooser.HasSelected()) {
-        name = m_DashboardAutoChooser.GetSelectedName();
+        AddAutonomous(kPathRoutinePrefix + name, [=] {
+            FollowPolybezier follower {m_Drivetrain, file, followerConfig};
+
+            return new frc2::SequentialCommandGroup(
+                FollowPolybezier::ResetPoseCommand(m_Drivetrain, follower.GetPath()),
+                std::move(follower)
+            );
+        });
+    }
+}
+
+void RobotContainer::AddAutonomous (std::string name, AutoFactory factory, bool isDefault) {
+    if (isDefault) {
+        m_DashboardAutoChooser.SetDefaultOption(name, factory);
+    } else {
+        m_DashboardAutoChooser.AddOption(name, factory);
+    }
+
+    m_AutoFactories[name] = std::move(factory);
+    m_AutoNames.push_back(name);
+}
+
+std::string RobotContainer::GetSelectedAutoName () {
+    if (!m_AutoOverride.empty()) {
+        return m_AutoOverride;
+    } else if (m_DashboardAutoChooser.HasSelected()) {
+        return m_DashboardAutoChooser.GetSelectedName();
     } else {
-        name = m_DashboardAutoChooser.GetDefaultName();
+        return m_DashboardAutoChooser.GetDefaultName();
     }
+}
 
-    frc::SmartDashboard::PutString("Robot sees autonomous", name);
+void RobotContainer::PrepareSelectedAuto () {
+    // Collect a finished build.
+    if (m_AutoBuild.valid()) {
+        if (std::future_status::ready != m_AutoBuild.wait_for(std::chrono::seconds(0))) return;
+
+        m_AutoCache[m_AutoBuildName] = m_AutoBuild.get();
+    }
+
+    std::string name = GetSelectedAutoName();
+    if (0 != m_AutoCache.count(name) || 0 == m_AutoFactories.count(name)) return;
+
+    // Commands only touch their subsystems once scheduled, so building one
+    // off the main thread is safe.
+    m_AutoBuildName = name;
+    m_AutoBuild = std::async(std::launch::async, m_AutoFactories[name]);
+}
+
+void RobotContainer::ReportSelectedAuto () {
+    m_SelectedAutoTelemetry.Set(GetSelectedAutoName());
 }
@@ -0,0 +1,144 @@
+#include "autonomous/RoutineCompiler.h"
+
+#include <iostream>
+#include <stdexcept>
+
+#include <frc2/command/ParallelCommandGroup.h>
+#include <frc2/command/ParallelDeadlineGroup.h>
+#include <frc2/command/ParallelRaceGroup.h>
+#include <frc2/command/SequentialCommandGroup.h>
+#include <frc2/command/WaitCommand.h>
+
+void RoutineCompiler::Register (std::string name, CommandFactory factory) {
+    m_Factories[name] = std::move(factory);
+}
+
+std::vector<RoutineCompiler::Routine> RoutineCompiler::Load (const std::string &path) const {
+    std::vector<Routine> routines;
+
+    std::shared_ptr<cpptoml::table> toml;
+    try {
+        toml = cpptoml::parse_file(path);
+    } catch (const cpptoml::parse_exception &ex) {
+        std::cerr << "Unable to load autonomous routines: " << path << std::endl << ex.what() << std::endl;
+        return routines;
+    }
+
+    auto routineTables = toml->get_table_array("routine");
+    if (!routineTables) return routines;
+
+    for (const auto &table : *routineTables) {
+        auto name = table->get_as<std::string>("name");
+        if (!name) {
+            std::cerr << path << ": routine without a name" << std::endl;
+            continue;
+        }
+
+        try {
+            Step step;
+            step.kind = Step::kSequence;
+            step.steps = ParseSteps(*table, "steps");
+
+            routines.push_back(Routine {*name, table->get_as<bool>("default").value_or(false), std::move(step)});
+        } catch (const std::runtime_error &ex) {
+            std::cerr << path << ": routine \"" << *name << "\": " << ex.what() << std::endl;
+        }
+    }
+
+    return routines;
+}
+
+std::vector<RoutineCompiler::Step> RoutineCompiler::ParseSteps (const cpptoml::table &table, const std::string &key) const {
+    auto stepTables = table.get_table_array(key);
+    if (!stepTables) {
+        throw std::runtime_error(key + " must be a list of steps");
+    }
+
+    std::vector<Step> steps;
+    for (const auto &stepTable : *stepTables) {
+        steps.push_back(ParseStep(stepTable));
+    }
+
+    return steps;
+}
+
+RoutineCompiler::Step RoutineCompiler::ParseStep (const Params &params) const {
+    const cpptoml::table &table = *params;
+    Step step;
+
+    if (auto command = table.get_as<std::string>("command")) {
+        if (0 == m_Factories.count(*command)) {
+            throw std::runtime_error("unknown command \"" + *command + "\"");
+        }
+
+        step.kind = Step::kCommand;
+        step.command = *command;
+        step.params = params;
+    } else if (table.contains("sequence")) {
+        step.kind = Step::kSequence;
+        step.steps = ParseSteps(table, "sequence");
+    } else if (table.contains("parallel")) {
+        step.kind = Step::kParallel;
+        step.steps = ParseSteps(table, "parallel");
+    } else if (table.contains("race")) {
+        step.kind = Step::kRace;
+        step.steps = ParseSteps(table, "race");
+    } else if (table.contains("deadline")) {
+        step.kind = Step::kDeadline;
+        step.steps = ParseSteps(table, "deadline");
+        if (step.steps.empty()) {
+            throw std::runtime_error("deadline needs at least one step");
+        }
+    } else if (auto seconds = table.get_as<double>("wait")) {
+        step.kind = Step::kWait;
+        step.seconds = *seconds;
+    } else {
+        throw std::runtime_error("step is not a command, sequence, parallel, race, deadline or wait");
+    }
+
+    step.timeout = table.get_as<double>("timeout").value_or(0.0);
+
+    return step;
+}
+
+std::unique_ptr<frc2::Command> RoutineCompiler::Compile (const Step &step) const {
+    std::unique_ptr<frc2::Command> command;
+
+    std::vector<std::unique_ptr<frc2::Command>> children;
+    for (const auto &child : step.steps) {
+        children.push_back(Compile(child));
+    }
+
+    switch (step.kind) {
+        case Step::kCommand:
+            command = m_Factories.at(step.command)(step.params);
+            break;
+        case Step::kSequence:
+            command = std::make_unique<frc2::SequentialCommandGroup>(std::move(children));
+            break;
+        case Step::kParallel:
+            command = std::make_unique<frc2::ParallelCommandGroup>(std::move(children));
+            break;
+        case Step::kRace:
+            command = std::make_unique<frc2::ParallelRaceGroup>(std::move(children));
+            break;
+        case Step::kDeadline: {
+            auto deadline = std::move(children.front());
+            children.erase(children.begin());
+            command = std::make_unique<frc2::ParallelDeadlineGroup>(std::move(deadline), std::move(children));
+            break;
+        }
+        case Step::kWait:
+            command = std::make_unique<frc2::WaitCommand>(units::second_t(step.seconds));
+            break;
+    }
+
+    if (step.timeout > 0) {
+        std::vector<std::unique_ptr<frc2::Command>> race;
+        race.push_back(std::move(command));
+        race.push_back(std::make_unique<frc2::WaitCommand>(units::second_t(step.timeout)));
+        command = std::make_unique<frc2::ParallelRaceGroup>(std::move(race));
+    }
+
+    return command;
+}
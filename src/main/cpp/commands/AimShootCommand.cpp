@@ -1,5 +1,8 @@
 #include "commands/AimShootCommand.h"
 
+#include "instrumentation/AllocationTracking.h"
+#include "instrumentation/LoopTiming.h"
+
 #include <math.h>
 
 AimShootCommand::AimShootCommand (rpm_t shootSpeed, Shooter* shooter, Intake* intake, PowerCellCounter* counter) {
@@ -13,23 +16,40 @@ AimShootCommand::AimShootCommand (rpm_t shootSpeed, Shooter* shooter, Intake* in
     m_PowerCellCounter = counter;
 }
 
+AimShootCommand::AimShootCommand (rpm_t shootSpeed, Shooter* shooter, Intake* intake, PowerCellCounter* counter, Drivetrain* drivetrain)
+    : AimShootCommand(shootSpeed, shooter, intake, counter)
+{
+    m_Drivetrain = drivetrain;
+}
+
 void AimShootCommand::Initialize () {
     m_Shooter->SetTrackingMode(TrackingMode::CameraTracking);
     m_Shooter->SetShooterMotorSpeed(m_ShootSpeed);
 
-    feederActivated = false;
+    // Feeder holds cells back until the flywheel is ready.
+    m_Intake->SetConveyorSpeed(0.8);
+
+    m_TargetSpeed = m_ShootSpeed;
+    m_FeedState = FeedState::Unknown;
 }
 
 void AimShootCommand::Execute () {
-    if (!feederActivated && m_Shooter->GetShooterMotorSpeed() > m_ShootSpeed * 0.95) {
-        m_Intake->SetConveyorSpeed(0.8);
-        m_Intake->FeedShooterStart();
-        feederActivated = true;
+    LOOP_TIMER("AimShootCommand.Execute");
+    NO_ALLOC_REGION("AimShootCommand.Execute");
+
+    if (nullptr != m_Drivetrain) {
+        m_TargetSpeed = m_Shooter->CompensateForMotion(m_ShootSpeed, m_Drivetrain->GetSpeed());
+        m_Shooter->SetShooterMotorSpeed(m_TargetSpeed);
     }
 
-    if (feederActivated && m_Shooter->GetShooterMotorSpeed() < m_ShootSpeed * 0.95) {
-        m_Intake->FeedStop();
-        feederActivated = false;
+    if (m_Shooter->IsReadyToFeed(m_TargetSpeed)) {
+        SetFeedState(FeedState::Shooting);
+    } else if (m_PowerCellCounter->IsCellStaged()) {
+        // Next cell is waiting in the feeder for the flywheel to recover.
+        SetFeedState(FeedState::Stopped);
+    } else {
+        // Bring the next cell up to the feeder while the flywheel recovers.
+        SetFeedState(FeedState::Staging);
     }
 }
 
@@ -41,5 +61,23 @@ void AimShootCommand::End (bool interrupted) {
 }
 
 bool AimShootCommand::IsFinished () {
-    return 0 == m_PowerCellCounter->GetCount();
+    return m_PowerCellCounter->IsHopperEmpty();
+}
+
+void AimShootCommand::SetFeedState (FeedState state) {
+    if (state == m_FeedState) return;
+
+    switch (state) {
+        case FeedState::Shooting:
+            m_Intake->FeedShooterStart();
+            break;
+        case FeedState::Staging:
+            m_Intake->FeedLoadStart();
+            break;
+        default:
+            m_Intake->FeedStop();
+            break;
+    }
+
+    m_FeedState = state;
 }
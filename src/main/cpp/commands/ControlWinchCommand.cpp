@@ -1,5 +1,7 @@
 #include "commands/ControlWinchCommand.h"
 
+#include "instrumentation/AllocationTracking.h"
+#include "instrumentation/LoopTiming.h"
 
 ControlWinchCommand::ControlWinchCommand (Climb* Climb, std::function<double(void)> speedLambda) {
     AddRequirements(Climb);
@@ -10,6 +12,9 @@ ControlWinchCommand::ControlWinchCommand (Climb* Climb, std::function<double(voi
 void ControlWinchCommand::Initialize () {}
 
 void ControlWinchCommand::Execute () {
+    LOOP_TIMER("ControlWinchCommand.Execute");
+    NO_ALLOC_REGION("ControlWinchCommand.Execute");
+
     double rightStickY = m_SpeedCheck();
 
     if (rightStickY < -0.15) {
@@ -1,350 +1,356 @@
 #include "commands/FollowPolybezier.h"
 
-#include <fstream>
+#include "instrumentation/AllocationTracking.h"
+#include "instrumentation/LoopTiming.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <mutex>
 #include <tuple>
 
 #include <wpi/raw_istream.h>
 #include <frc/RobotController.h>
 
-constexpr double PI = 3.1415926535897932;
+#include "trajectory/LegacyFollower.h"
+#include "trajectory/PurePursuitFollower.h"
+#include "trajectory/RamseteFollower.h"
+#include "util/WorkerPool.h"
 
-FollowPolybezier::FollowPolybezier (Drivetrain* drivetrain, const wpi::Twine &filename, Configuration configuration, bool backwards) :
-    drivetrain(drivetrain), config(configuration), backwards(backwards)
-{
-    AddRequirements(drivetrain);
+constexpr double PI = 3.1415926535897932;
 
-    std::error_code code;
-    wpi::raw_fd_istream pathFile {filename, code};
+static FollowPolybezier::TrackingStats trackingStats;
 
-    if (code.value() != 0) {
-        std::cerr << "Unable to open file \"" << filename.str() << "\"" << std::endl;
-        std::cerr << code.message() << std::endl;
-        throw ENOENT;
-    }
+// From [follower] in config.toml.
+static struct {
+    Follower::Kind fallback = Follower::Kind::kLegacy;
+    std::map<std::string, Follower::Kind> byPath;
 
-    wpi::json pathJSON;
-    pathFile >> pathJSON;
+    RamseteFollower::Gains ramsete;
+    PurePursuitFollower::Lookahead lookahead;
+} followers;
 
-    for (auto val : pathJSON) {
-        LoadCurve(val);
+static std::optional<Follower::Kind> parseKind (const std::string &where, const std::string &name) {
+    auto kind = Follower::ParseKind(name);
+    if (!kind) {
+        std::cerr << "follower: unknown kind \"" << name << "\" for " << where << std::endl;
     }
+    return kind;
 }
 
-void FollowPolybezier::Initialize () {
-    logFile = new std::ofstream("/home/lvuser/logNew1.txt");
-
-    finished = false;
+void FollowPolybezier::ConfigureFollowers (std::shared_ptr<cpptoml::table> toml) {
+    if (nullptr == toml) return;
 
-    if (polybezier.size() < 1) { // there must be at least one curve
-        finished = true;
-        Cancel();
-        return;
+    auto fallback = toml->get_qualified_as<std::string>("default");
+    if (fallback) {
+        followers.fallback = parseKind("default", *fallback).value_or(Follower::Kind::kLegacy);
     }
 
-    currentBezier = 0;
-    ResetCurveProgress();
+    followers.ramsete.b = toml->get_qualified_as<double>("ramsete.b").value_or(followers.ramsete.b);
+    followers.ramsete.zeta = toml->get_qualified_as<double>("ramsete.zeta").value_or(followers.ramsete.zeta);
 
-    drivetrain->SetBrake(false);
+    followers.lookahead.minimum = toml->get_qualified_as<double>("purePursuit.lookaheadMinimum").value_or(followers.lookahead.minimum);
+    followers.lookahead.maximum = toml->get_qualified_as<double>("purePursuit.lookaheadMaximum").value_or(followers.lookahead.maximum);
+    followers.lookahead.gain = toml->get_qualified_as<double>("purePursuit.lookaheadGain").value_or(followers.lookahead.gain);
 
-    drivetrain->SetAcceleration(0, 0);
-    drivetrain->SetAngularVelocity(0);
-    velocity = 0;
-    acceleration = 0;
-    lastTime = frc::RobotController::GetFPGATime();
-}
+    followers.byPath.clear();
+    auto paths = toml->get_table("paths");
+    if (nullptr == paths) return;
 
-void FollowPolybezier::Execute () {
-    auto pose = drivetrain->GetPose();
-    distanceTraveled += pose.Translation().Distance(lastPose.Translation()).to<double>();
-
-    // std::cout << pose.Translation().X().to<double>()
-    //     << ", " << pose.Translation().Y().to<double>()
-    //     << ", " << pose.Rotation().Degrees().to<double>()
-    //     << std::endl;
-
-    auto *currentStep = &polybezier[currentBezier];
-
-    while (distanceTraveled >= currentStep->second[prevVertex+1].d) {
-        prevVertex++;
-        if (prevVertex + 1 >= currentStep->second.size()) { // if new prevVertex is the last
-            currentBezier++;
-            if (currentBezier >= polybezier.size()) {
-                finished = true;
-                return;
-            }
-            ResetCurveProgress();
+    for (auto &[file, value] : *paths) {
+        auto name = value->as<std::string>();
+        if (nullptr == name) {
+            std::cerr << "follower: " << file << " should name a kind" << std::endl;
+            continue;
         }
+
+        auto kind = parseKind(file, name->get());
+        if (kind) followers.byPath[file] = *kind;
     }
+}
 
-    double dT = currentStep->second[prevVertex+1].t - currentStep->second[prevVertex].t; // total change in t over the current segment
-    double dD = currentStep->second[prevVertex+1].d - currentStep->second[prevVertex].d; // total change in d over the current segment
+FollowPolybezier::Configuration FollowPolybezier::ReadConfiguration (std::shared_ptr<cpptoml::table> toml) {
+    Configuration config {
+        5.0,    // maximumRadialAcceleration
+        3.0,    // maximumJerk
+        8.0     // maximumReverseAcceleration
+    };
+    if (nullptr == toml) return config;
+
+    config.maximumRadialAcceleration  = toml->get_qualified_as<double>("maximumRadialAcceleration").value_or(config.maximumRadialAcceleration);
+    config.maximumJerk                = toml->get_qualified_as<double>("maximumJerk").value_or(config.maximumJerk);
+    config.maximumReverseAcceleration = toml->get_qualified_as<double>("maximumReverseAcceleration").value_or(config.maximumReverseAcceleration);
+    config.maximumVelocity            = toml->get_qualified_as<double>("maximumVelocity").value_or(config.maximumVelocity);
+    config.maximumAcceleration        = toml->get_qualified_as<double>("maximumAcceleration").value_or(config.maximumAcceleration);
+
+    return config;
+}
 
-    double distanceAlongSegment = distanceTraveled - currentStep->second[prevVertex].d; // change in d since the beginning of the segment
-    double timeAlongSegment = distanceAlongSegment * (dT/dD); // approximate change in t since the beginning of the segment
+frc2::InstantCommand FollowPolybezier::ResetPoseCommand (Drivetrain *drivetrain, std::shared_future<Path> path) {
+    return frc2::InstantCommand {
+        [=]() {
+            if (path.get().empty()) return;
 
-    double t = currentStep->second[prevVertex].t + timeAlongSegment; // approximate t value for the current position (initial + change)
+            auto p = path.get()[0].samples[0].p;
+            drivetrain->SetPose(p.x, p.y, 0);
+        }
+    };
+}
 
-    auto derivs = Bezier::evaluateDerivatives(currentStep->first, t);
-    double r = Bezier::getRadiusOfCurvature(derivs);
+// Paths are listed by their name in the paths directory.
+static Follower::Kind configuredKind (const std::string &filename) {
+    std::string name = filename.substr(filename.find_last_of('/') + 1);
 
-    double v = drivetrain->GetSpeed();
-    double w = v/r; // get the angular velocity needed to drive in a circle of radius r at velocity v
+    auto found = followers.byPath.find(name);
+    return found == followers.byPath.end() ? followers.fallback : found->second;
+}
 
-    // get the current target angle using the tangent at the current point
-    double angle = std::atan2(derivs.firstDeriv.y, derivs.firstDeriv.x);
+FollowPolybezier::TrackingStats FollowPolybezier::TakeTrackingStats () {
+    TrackingStats stats = trackingStats;
+    trackingStats = TrackingStats{};
+    return stats;
+}
 
-    if (backwards) {
-        w *= -1;
-        // shift angle by pi
-        if (angle > 0) {
-            angle -= PI;
-        } else {
-            angle += PI; 
-        }
-    }
+std::shared_future<FollowPolybezier::Path> FollowPolybezier::LoadPath (const std::string &filename, Configuration configuration) {
+    using Key = std::tuple<std::string, double, double, double>;
 
-    // shift by 360 degrees if one of the values rolls over but the other doesn't
-    double robotAngle = pose.Rotation().Radians().to<double>();
-    if (robotAngle - angle > 4.5) {
-        angle += 2*PI;
-    } else if (angle - robotAngle > 4.5) {
-        angle -= 2*PI;
-    }
+    static std::mutex cacheMutex;
+    static std::map<Key, std::shared_future<Path>> cache;
 
-    // std::cout << frc::RobotController::GetFPGATime() << "," << angle << "," << robotAngle << std::endl;
+    Key key {filename, configuration.maximumRadialAcceleration, configuration.maximumJerk, configuration.maximumReverseAcceleration};
 
-    auto accel = CalculateAcceleration();
+    std::lock_guard<std::mutex> lock(cacheMutex);
 
-    if (backwards) {
-        drivetrain->SetAcceleration(-accel.first, -accel.second);
-    } else {
-        drivetrain->SetAcceleration(accel.first, accel.second);
+    auto cached = cache.find(key);
+    if (cached != cache.end()) {
+        return cached->second;
     }
 
-    drivetrain->SetAngularVelocity(w, angle);
+    std::shared_future<Path> path = WorkerPool::GetInstance().Submit([=] {
+        Path loaded;
 
-    lastPose = pose;
-}
+        std::error_code code;
+        wpi::raw_fd_istream pathFile {filename, code};
 
-std::pair<double, double> FollowPolybezier::CalculateAcceleration () {
-    // get time since last execution
-    uint64_t currentTime = frc::RobotController::GetFPGATime();
-    double dt = (currentTime - lastTime) / 1'000'000.0;
-    lastTime = currentTime;
-
-    // compute velocity change since last execution
-    velocity += acceleration * dt;
-
-    double cVelocity = velocity;
-    double cAcceleration = acceleration;
-    unsigned int cBezier = currentBezier;
-    unsigned int cVertex = prevVertex;
-
-    std::pair<double, std::pair<unsigned int, unsigned int>> leastMargin = {cVelocity+1, {0, 0}};
-
-    std::vector<std::tuple<std::pair<unsigned int, unsigned int>, double, double, double>> points;
-
-    while (cVelocity > 0) {
-        cVertex++;
-        if (cVertex >= polybezier[cBezier].second.size()) {
-            cVertex = 0;
-            cBezier++;
-            if (cBezier >= polybezier.size()) {
-                double endMargin = -cVelocity; // add 0.2 for bounce
-                if (-cVelocity < leastMargin.first) leastMargin = {endMargin, {cBezier-1, polybezier[cBezier].second.size()-1}};
-                break;
-            }
+        if (code.value() != 0) {
+            // Leaves the path empty, so the command finishes straight away.
+            std::cerr << "Unable to open file \"" << filename << "\"" << std::endl;
+            std::cerr << code.message() << std::endl;
+            return loaded;
         }
 
-        auto *currentApproximation = &polybezier[cBezier].second;
+        wpi::json pathJSON;
+        pathFile >> pathJSON;
 
-        double distTraveled;
-        if (cVertex == 0) {
-            distTraveled = 0;
-        } else if (cBezier == currentBezier && cVertex == prevVertex+1) {
-            distTraveled = (*currentApproximation)[cVertex].d - distanceTraveled;
+        if (pathJSON.is_object()) {
+            for (auto segment : pathJSON.value("segments", wpi::json::array())) {
+                bool segmentBackwards = segment.value("backwards", false);
+                for (auto val : segment.value("curves", wpi::json::array())) {
+                    LoadCurve(loaded, val, configuration, segmentBackwards);
+                }
+            }
         } else {
-            distTraveled = (*currentApproximation)[cVertex].d - (*currentApproximation)[cVertex-1].d;
+            for (auto val : pathJSON) {
+                LoadCurve(loaded, val, configuration);
+            }
         }
 
-        // compute change in acceleration and velocity over distTraveled
-        double vSquared = cVelocity*cVelocity + 2*cAcceleration*distTraveled;
-        double newVelocity = vSquared > 0 ? std::sqrt(vSquared) : 0;
-        double dt = (newVelocity - cVelocity) / cAcceleration;
-        cAcceleration -= config.maximumJerk * dt;
-        cAcceleration = cAcceleration < -config.maximumReverseAcceleration ? -config.maximumReverseAcceleration : cAcceleration;
-        cVelocity = newVelocity;
+        return loaded;
+    }).share();
+
+    cache[key] = path;
+    return path;
+}
+
+std::shared_future<Trajectory> FollowPolybezier::LoadTrajectory (const std::string &filename, Configuration configuration, bool backwards) {
+    using Key = std::tuple<std::string, double, double, double, double, double, bool>;
+
+    static std::mutex cacheMutex;
+    static std::map<Key, std::shared_future<Trajectory>> cache;
+
+    Key key {
+        filename, configuration.maximumRadialAcceleration, configuration.maximumJerk, configuration.maximumReverseAcceleration,
+        configuration.maximumVelocity, configuration.maximumAcceleration, backwards
+    };
 
-        points.push_back({{cBezier, cVertex}, distTraveled, cVelocity, cAcceleration});
+    // Before taking the lock, and before submitting, so the path's job is
+    // always queued ahead of this one and the wait below can't stall the pool.
+    std::shared_future<Path> path = LoadPath(filename, configuration);
 
-        *logFile << "@ " << cBezier << "," << cVertex << "," << polybezier[cBezier].second[cVertex].maxV << ", " << cVelocity << ", " << cAcceleration << std::endl;
+    std::lock_guard<std::mutex> lock(cacheMutex);
 
-        double margin = polybezier[cBezier].second[cVertex].maxV - cVelocity;
-        if (margin < leastMargin.first) leastMargin = {margin, {cBezier, cVertex}};
+    auto cached = cache.find(key);
+    if (cached != cache.end()) {
+        return cached->second;
     }
 
-    // limit based on point past min
-    if (leastMargin.second.first > nextMin.first || (leastMargin.second.first == nextMin.first && leastMargin.second.second > nextMin.second)) {
-        // act like normal
-    } else {
-        // calculate margin for min:
-        // get min distance
-        auto minPoint = polybezier[nextMin.first].second[nextMin.second];
-        double mDistance = minPoint.d; // add distance from beginning of bezier with nextMin to nextMin
-        mDistance -= polybezier[cBezier].second[cVertex].d; // remove distance from beginning of current bezier to current point
-
-        if (cBezier < nextMin.first) { // if nextMin is in a later bezier curve
-            int nB = cBezier-1;
-            while (++nB < nextMin.first) {
-                mDistance += polybezier[nB].second.end()->d;
-            }
-        }
+    Trajectory::Constraints constraints {
+        configuration.maximumVelocity,
+        configuration.maximumAcceleration,
+        configuration.maximumReverseAcceleration,
+        configuration.maximumRadialAcceleration
+    };
 
-        // find d
-        double v = velocity;
-        double q1 = (1.0/3.0)/(config.maximumJerk*config.maximumJerk) * acceleration*acceleration;
-        double q2 = (1.0/config.maximumJerk)*v;
-        double d = (q1-q2) * acceleration;
+    std::shared_future<Trajectory> trajectory = WorkerPool::GetInstance().Submit([=] {
+        return Trajectory{GetWaypoints(path.get()), constraints, backwards};
+    }).share();
 
-        // check if we need to start reducing acceleration
-        if (mDistance < d + 0.05 && acceleration < 0) {
-            // bring acceleration to 0
-            leastMargin.first = 0.2; // override margin
-        } else {
-            // calculate margin and adjust leastMargin appropriately
-            double tD = 0;
-            int index = -2;
-            for (int i = 0; i < points.size(); i++) {
-                tD += std::get<1>(points[i]);
-                double v = std::get<2>(points[i]);
-                double a = std::get<3>(points[i]);
-
-                double q1 = (1.0/3.0)/(config.maximumJerk*config.maximumJerk) * a*a;
-                double q2 = (1.0/config.maximumJerk)*v;
-                double d = (q1-q2) * a;
-
-                if (mDistance - tD < d) {
-                    index = i-1;
-                    break;
-                }
-            }
-            if (index > -2) { 
-                if (index == -1) index = 0;
-                double v = std::get<2>(points[index]);
-                double a = std::get<3>(points[index]);
-                double t = -a/config.maximumJerk;
-                double dv = (a + t*config.maximumJerk/2)*t;
-                v += dv;
-                double margin = minPoint.maxV - v;
-                if (margin < leastMargin.first) leastMargin.first = margin;
-            }
+    cache[key] = trajectory;
+    return trajectory;
+}
+
+std::vector<Trajectory::Waypoint> FollowPolybezier::GetWaypoints (const Path &path) {
+    std::vector<Trajectory::Waypoint> waypoints;
+
+    for (auto &curve : path) {
+        // Each curve starts where the last one ended.
+        for (std::size_t i = waypoints.empty() ? 0 : 1; i < curve.samples.size(); i++) {
+            auto &sample = curve.samples[i];
+            auto derivs = Bezier::evaluateDerivatives(curve.bezier, sample.t);
+
+            double speed = Point::magnitude(derivs.firstDeriv);
+            double curvature = speed > 0 ? (derivs.firstDeriv.x * derivs.secondDeriv.y - derivs.firstDeriv.y * derivs.secondDeriv.x) / (speed*speed*speed) : 0;
+
+            waypoints.push_back({sample.p.x, sample.p.y, std::atan2(derivs.firstDeriv.y, derivs.firstDeriv.x), curvature, curve.backwards});
         }
     }
 
-    // set acceleration
-    if (leastMargin.first < 0.05) {
-        acceleration -= config.maximumJerk*dt;
-    } else if (leastMargin.first < 0.1) {
-        // do nothing
-    } else {
-        acceleration += config.maximumJerk*dt;
+    return waypoints;
+}
+
+FollowPolybezier::FollowPolybezier (Drivetrain* drivetrain, const wpi::Twine &filename, Configuration configuration, bool backwards,
+    std::optional<Follower::Kind> kind) :
+    drivetrain(drivetrain), config(configuration), backwards(backwards)
+{
+    AddRequirements(drivetrain);
+
+    std::string file = filename.str();
+    this->kind = kind.value_or(configuredKind(file));
+
+    path = LoadPath(file, configuration);
+    trajectory = LoadTrajectory(file, configuration, backwards);
+}
+
+void FollowPolybezier::Initialize () {
+    finished = false;
+
+    // Only waits if the command was scheduled before the path was ready, and
+    // then the trajectory is ready too, or nearly.
+    if (path.get().size() < 1 || trajectory.get().IsEmpty()) { // there must be at least one curve
+        finished = true;
+        Cancel();
+        return;
     }
 
-    acceleration = std::clamp(acceleration, -config.maximumReverseAcceleration, std::min(drivetrain->GetMaxAvailableAcceleration(), 1.0));
+    switch (kind) {
+        case Follower::Kind::kLegacy:
+            follower = std::make_unique<LegacyFollower>(drivetrain, path.get(), trajectory.get(), config, backwards);
+            break;
+        case Follower::Kind::kRamsete:
+            follower = std::make_unique<RamseteFollower>(trajectory.get(), followers.ramsete);
+            break;
+        case Follower::Kind::kPurePursuit:
+            follower = std::make_unique<PurePursuitFollower>(trajectory.get(), followers.lookahead);
+            break;
+    }
 
-    double targetVelocity = velocity + 0.5*acceleration*dt;
+    follower->Start(drivetrain->GetPose());
+    startTime = frc::RobotController::GetFPGATime();
 
-    *logFile << currentTime << ", " << dt << ", " << acceleration << ", " << velocity << ", " << leastMargin.first << std::endl;
+    drivetrain->SetBrake(false);
 
-    return {acceleration, targetVelocity};
+    drivetrain->SetAcceleration(0, 0);
+    drivetrain->SetAngularVelocity(0);
 }
 
-void FollowPolybezier::LoadCurve (wpi::json::value_type controlPoints) {
-    std::pair<Bezier::CubicBezier, std::vector<FollowPolybezier::DistanceSample>> result {{
+void FollowPolybezier::Execute () {
+    LOOP_TIMER("FollowPolybezier.Execute");
+    NO_ALLOC_REGION("FollowPolybezier.Execute");
+
+    if (finished) return;
+
+    auto pose = drivetrain->GetPose();
+    double time = (frc::RobotController::GetFPGATime() - startTime) / 1'000'000.0;
+
+    Follower::Output output;
+    if (!follower->Update(pose, time, output)) {
+        finished = true;
+        return;
+    }
+
+    // Cross-track error, off the tangent at the point the follower aimed for.
+    const Trajectory::Sample &reference = output.reference;
+    double dx = pose.X().to<double>() - reference.x;
+    double dy = pose.Y().to<double>() - reference.y;
+    double trackingError = std::fabs(dx * std::sin(reference.heading) - dy * std::cos(reference.heading));
+    trackingStats.samples++;
+    trackingStats.total += trackingError;
+    trackingStats.max = std::max(trackingStats.max, trackingError);
+
+    // shift by 360 degrees if one of the values rolls over but the other doesn't
+    double angle = output.targetAngle;
+    double robotAngle = pose.Rotation().Radians().to<double>();
+    if (robotAngle - angle > 4.5) {
+        angle += 2*PI;
+    } else if (angle - robotAngle > 4.5) {
+        angle -= 2*PI;
+    }
+
+    drivetrain->SetAcceleration(output.acceleration, output.targetSpeed);
+    drivetrain->SetAngularVelocity(output.angularVelocity, angle);
+}
+
+void FollowPolybezier::LoadCurve (Path &path, wpi::json::value_type controlPoints, const Configuration &config, bool backwards) {
+    Curve result {{
         {controlPoints[0][0], controlPoints[0][1]},
         {controlPoints[1][0], controlPoints[1][1]},
         {controlPoints[2][0], controlPoints[2][1]},
         {controlPoints[3][0], controlPoints[3][1]}
-    }, {}};
+    }, {}, backwards};
 
     double l = 0;
-    if (polybezier.size() > 0) {
-        l = polybezier[polybezier.size()-1].second.end()->maxV;
+    if (path.size() > 0) {
+        l = path.back().samples.back().maxV;
     }
 
-    AddApproximation(&result, l);
+    AddApproximation(&result, config, l);
 
-    polybezier.push_back(result);
+    path.push_back(result);
 }
 
-void FollowPolybezier::AddApproximation (std::pair<Bezier::CubicBezier, std::vector<DistanceSample>> *bezier, double previousCurveFinalSpeed) {
-    auto samples = Bezier::polylineApproximation(bezier->first, 1.001, 0.05);
+void FollowPolybezier::AddApproximation (Curve *curve, const Configuration &config, double previousCurveFinalSpeed) {
+    auto samples = Bezier::polylineApproximation(curve->bezier, 1.001, 0.05);
     int nSamples = samples.size();
 
-    bezier->second.clear();
-    bezier->second.reserve(nSamples);
+    curve->samples.clear();
+    curve->samples.reserve(nSamples);
 
     // std::cout << "curve:" << std::endl;
 
-    bezier->second.push_back({samples[0].p, samples[0].t, 0, 100, false});
+    curve->samples.push_back({samples[0].p, samples[0].t, 0, 100, false});
 
     double distance = 0;
     for (int i = 1; i < nSamples; i++) {
         distance += Point::distance(samples[i-1].p, samples[i].p);
 
-        double r = Bezier::getRadiusOfCurvature(bezier->first, samples[i].t);
+        double r = Bezier::getRadiusOfCurvature(curve->bezier, samples[i].t);
         double maxV = std::sqrt(config.maximumRadialAcceleration * std::fabs(r));
 
         if (i == nSamples-1) maxV = 100;
 
-        bool lessPrev = bezier->second[i-1].maxV < (i>1 ? bezier->second[i-2].maxV : previousCurveFinalSpeed);
-        bool lessThis = bezier->second[i-1].maxV < maxV;
+        bool lessPrev = curve->samples[i-1].maxV < (i>1 ? curve->samples[i-2].maxV : previousCurveFinalSpeed);
+        bool lessThis = curve->samples[i-1].maxV < maxV;
         if (lessPrev && lessThis) {
-            bezier->second[i-1].minimum = true;
-            // std::cout << "minimum: " << i-1 << "," << bezier->second[i-1].t << "," << bezier->second[i-1].maxV << std::endl;
+            curve->samples[i-1].minimum = true;
+            // std::cout << "minimum: " << i-1 << "," << curve->samples[i-1].t << "," << curve->samples[i-1].maxV << std::endl;
         }
 
-        // std::cout << i-1 << "," << samples[i-1].p.x << "," << samples[i-1].p.y << "," << maxV << "," << (bezier->second[i-1].minimum ? 1 : 0) << std::endl;
+        // std::cout << i-1 << "," << samples[i-1].p.x << "," << samples[i-1].p.y << "," << maxV << "," << (curve->samples[i-1].minimum ? 1 : 0) << std::endl;
 
-        bezier->second.push_back({samples[i].p, samples[i].t, distance, maxV, false});
+        curve->samples.push_back({samples[i].p, samples[i].t, distance, maxV, false});
     }
 
-    // std::cout << nSamples-1 << "," << samples[nSamples-1].p.x << "," << samples[nSamples-1].p.y << "," << (*bezier->second.end()).maxV << ",";
-    // std::cout << ((*bezier->second.end()).minimum ? 1 : 0) << std::endl;
-}
-
-void FollowPolybezier::SetNextMin () {
-    unsigned int cBezier = currentBezier;
-    unsigned int cVertex = prevVertex;
-
-    while (true) {
-        if (cVertex >= polybezier[cBezier].second.size()) {
-            cVertex = 0;
-            cBezier++;
-            if (cBezier >= polybezier.size()) {
-                nextMin = {cBezier,cVertex};
-                break;
-            }
-        }
-        if (polybezier[cBezier].second[cVertex].minimum) {
-            nextMin = {cBezier,cVertex};
-            break;
-        }
-        cVertex++;
-    }
-}
-
-void FollowPolybezier::ResetCurveProgress () {
-    // reset the variables that track progress along the curve
-    prevVertex = 0;
-    distanceTraveled = 0;
-
-    // start tracking distance along the new Bezier curve from the current position
-    lastPose = drivetrain->GetPose();
-
-    // correct for the real current position
-    polybezier[currentBezier].first.p0 = {lastPose.X().to<double>(), lastPose.Y().to<double>()};
-    AddApproximation(&(polybezier[currentBezier]));
-
-    SetNextMin();
+    // std::cout << nSamples-1 << "," << samples[nSamples-1].p.x << "," << samples[nSamples-1].p.y << "," << (*curve->samples.end()).maxV << ",";
+    // std::cout << ((*curve->samples.end()).minimum ? 1 : 0) << std::endl;
 }
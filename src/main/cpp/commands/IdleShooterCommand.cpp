@@ -0,0 +1,32 @@
+#include "commands/IdleShooterCommand.h"
+
+#include "instrumentation/AllocationTracking.h"
+#include "instrumentation/LoopTiming.h"
+
+IdleShooterCommand::IdleShooterCommand (Shooter* shooter, PowerCellCounter* counter) {
+    AddRequirements(shooter);
+    // No requirement for read-only PowerCellCounter.
+
+    m_Shooter = shooter;
+    m_PowerCellCounter = counter;
+}
+
+void IdleShooterCommand::Initialize () {
+    // Whatever ran before us probably stopped the flywheel.
+    m_NeedsUpdate = true;
+}
+
+void IdleShooterCommand::Execute () {
+    LOOP_TIMER("IdleShooterCommand.Execute");
+    NO_ALLOC_REGION("IdleShooterCommand.Execute");
+
+    rpm_t speed = 0 < m_PowerCellCounter->GetCount() ? m_Shooter->GetIdleSpeed() : 0_rpm;
+
+    if (m_NeedsUpdate || speed != m_AppliedSpeed) {
+        m_Shooter->SetShooterMotorSpeed(speed);
+        m_AppliedSpeed = speed;
+        m_NeedsUpdate = false;
+    }
+}
+
+void IdleShooterCommand::End (bool interrupted) {}
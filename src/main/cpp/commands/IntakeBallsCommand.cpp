@@ -1,5 +1,8 @@
 #include "commands/IntakeBallsCommand.h"
 
+#include "instrumentation/AllocationTracking.h"
+#include "instrumentation/LoopTiming.h"
+
 #include <iostream>
 
 IntakeBallsCommand::IntakeBallsCommand (Intake* intake, PowerCellCounter* cellCounter) {
@@ -22,6 +25,9 @@ void IntakeBallsCommand::Initialize () {
 }
 
 void IntakeBallsCommand::Execute () {
+    LOOP_TIMER("IntakeBallsCommand.Execute");
+    NO_ALLOC_REGION("IntakeBallsCommand.Execute");
+
     // if (m_PowerCellCounter->GetCount() >= 5) {
     //     // If robot has 5 balls, stop intake & expel balls in intake
     //     m_Intake->IntakeReverse();
@@ -1,5 +1,8 @@
 #include "commands/ShootCommand.h"
 
+#include "instrumentation/AllocationTracking.h"
+#include "instrumentation/LoopTiming.h"
+
 #include <math.h>
 
 #include <frc/smartdashboard/SmartDashboard.h>
@@ -21,7 +24,10 @@ void ShootCommand::Initialize () {
 }
 
 void ShootCommand::Execute () {
-    if (!feederActivated && m_Shooter->GetShooterMotorSpeed() > m_Speed * 0.95) {
+    LOOP_TIMER("ShootCommand.Execute");
+    NO_ALLOC_REGION("ShootCommand.Execute");
+
+    if (!feederActivated && m_Shooter->IsReadyToFeed(m_Speed)) {
         m_Intake->SetConveyorSpeed(0.8);
         m_Intake->FeedShooterStart();
         feederActivated = true;
@@ -1,5 +1,8 @@
 #include "commands/TeleopDriveCommand.h"
 
+#include "instrumentation/AllocationTracking.h"
+#include "instrumentation/LoopTiming.h"
+
 #include <math.h>
 
 #define defaultSpeed 0.6 // Default driving speed
@@ -11,7 +14,7 @@
 #define makeValueFullRange(deadzonedInput) (1/(1 - kJoystickDeadzone) * (deadzonedInput - std::copysign(kJoystickDeadzone, deadzonedInput)))
 #define deadzone(input) ((fabs(input) < kJoystickDeadzone) ? 0.0 : makeValueFullRange(input))
 
-TeleopDriveCommand::TeleopDriveCommand(Drivetrain* drivetrain, frc::XboxController* driverController) {
+TeleopDriveCommand::TeleopDriveCommand(Drivetrain* drivetrain, const ControllerSnapshot* driverController) {
     m_Drivetrain = drivetrain;
     m_Controller = driverController;
 
@@ -21,16 +24,19 @@ TeleopDriveCommand::TeleopDriveCommand(Drivetrain* drivetrain, frc::XboxControll
 void TeleopDriveCommand::Initialize () {}
 
 void TeleopDriveCommand::Execute () {
+    LOOP_TIMER("TeleopDriveCommand.Execute");
+    NO_ALLOC_REGION("TeleopDriveCommand.Execute");
+
     double speedFactor = defaultSpeed; // When no triggers are pulled, drive at the default speed
 
     // Scale between default speed and max speed as the right trigger is pulled (analog)
-    speedFactor += m_Controller->GetTriggerAxis(frc::XboxController::kRightHand) * (maxSpeed - defaultSpeed);
+    speedFactor += m_Controller->GetAxis(Xbox::kRightTrigger) * (maxSpeed - defaultSpeed);
     // Same as previous line, but between default and min speed, with the left trigger
-    speedFactor -= m_Controller->GetTriggerAxis(frc::XboxController::kLeftHand) * (defaultSpeed - minSpeed);
+    speedFactor -= m_Controller->GetAxis(Xbox::kLeftTrigger) * (defaultSpeed - minSpeed);
 
     // Get inputs from the controller
-    double xInput = deadzone(m_Controller->GetX(frc::XboxController::kRightHand));
-    double yInput = -deadzone(m_Controller->GetY(frc::XboxController::kLeftHand));
+    double xInput = deadzone(m_Controller->GetAxis(Xbox::kRightX));
+    double yInput = -deadzone(m_Controller->GetAxis(Xbox::kLeftY));
     
     m_Drivetrain->Drive(speedFactor * yInput, xInput);
 }
\ No newline at end of file
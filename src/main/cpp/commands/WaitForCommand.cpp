@@ -0,0 +1,23 @@
+#include "commands/WaitForCommand.h"
+
+#include <iostream>
+
+WaitForCommand::WaitForCommand (std::string what, std::function<bool()> ready, units::second_t cap)
+    : m_What(std::move(what)), m_Ready(std::move(ready)), m_Cap(cap) {}
+
+void WaitForCommand::Initialize () {
+    m_Timer.Reset();
+    m_Timer.Start();
+}
+
+void WaitForCommand::End (bool interrupted) {
+    m_Timer.Stop();
+
+    if (!interrupted && !m_Ready()) {
+        std::cerr << "Gave up waiting for " << m_What << " after " << m_Cap.to<double>() << " seconds" << std::endl;
+    }
+}
+
+bool WaitForCommand::IsFinished () {
+    return m_Ready() || m_Timer.HasElapsed(m_Cap);
+}
@@ -1,4 +1,6 @@
+#include <array>
 #include <iostream>
+#include <utility>
 
 #include <frc2/command/Command.h>
 #include <frc2/command/InstantCommand.h>
@@ -7,6 +9,9 @@
 #include "PickupCellsChallenge.h"
 
 #include "commands/challenge/PickupCellsCommand.h"
+#include "instrumentation/AllocationTracking.h"
+#include "instrumentation/LoopTiming.h"
+#include "util/Deploy.h"
 
 using challenge::Layout;
 
@@ -38,28 +43,28 @@ PickupCellsCommand::PickupCellsCommand (
         m_Drivetrain,
         m_Intake,
         followerConfig,
-        "/home/lvuser/deploy/paths/pickup-a-red.json"
+        Deploy::path("paths/pickup-a-red.json")
     );
 
     m_FollowABlue = build_pickup_command(
         m_Drivetrain,
         m_Intake,
         followerConfig,
-        "/home/lvuser/deploy/paths/pickup-a-blue.json"
+        Deploy::path("paths/pickup-a-blue.json")
     );
 
     m_FollowBRed = build_pickup_command(
         m_Drivetrain,
         m_Intake,
         followerConfig,
-        "/home/lvuser/deploy/paths/pickup-b-red.json"
+        Deploy::path("paths/pickup-b-red.json")
     );
 
     m_FollowBBlue = build_pickup_command(
         m_Drivetrain,
         m_Intake,
         followerConfig,
-        "/home/lvuser/deploy/paths/pickup-b-blue.json"
+        Deploy::path("paths/pickup-b-blue.json")
     );
 }
 
@@ -76,12 +81,15 @@ void PickupCellsCommand::Initialize () {
 }
 
 void PickupCellsCommand::Execute () {
-    std::vector<PixyBlock> blockList = m_Pixy->GetBlocks();
+    LOOP_TIMER("PickupCellsCommand.Execute");
+    NO_ALLOC_REGION("PickupCellsCommand.Execute");
 
-    m_DetectorARed.ProcessBlocks(blockList);
-    m_DetectorABlue.ProcessBlocks(blockList);
-    m_DetectorBRed.ProcessBlocks(blockList);
-    m_DetectorBBlue.ProcessBlocks(blockList);
+    m_Pixy->GetBlocks(m_Blocks);
+
+    m_DetectorARed.ProcessBlocks(m_Blocks);
+    m_DetectorABlue.ProcessBlocks(m_Blocks);
+    m_DetectorBRed.ProcessBlocks(m_Blocks);
+    m_DetectorBBlue.ProcessBlocks(m_Blocks);
 
     Layout bestLayout = find_best(
         m_DetectorARed.GetError(),
@@ -146,19 +154,20 @@ bool PickupCellsCommand::IsFinished () {
 static Layout find_best(int ared, int ablue, int bred, int bblue) {
     Layout bestLayout = Layout::CONFUSED;
 
-    std::map<Layout, int> errorMap;
-
-    errorMap[Layout::A_RED] = ared;
-    errorMap[Layout::A_BLUE] = ablue;
-    errorMap[Layout::B_RED] = bred;
-    errorMap[Layout::B_BLUE] = bblue;
+    // Runs every Execute, so on the stack.
+    const std::array<std::pair<Layout, int>, 4> errors {{
+        {Layout::A_RED, ared},
+        {Layout::A_BLUE, ablue},
+        {Layout::B_RED, bred},
+        {Layout::B_BLUE, bblue},
+    }};
 
-    for (auto pair : errorMap) {
-        if (MAX_ERROR_FOR_MATCH > pair.second) {
+    for (auto &[layout, error] : errors) {
+        if (MAX_ERROR_FOR_MATCH > error) {
             if (Layout::CONFUSED != bestLayout) {
                 return Layout::CONFUSED;
             } else {
-                bestLayout = pair.first;
+                bestLayout = layout;
             }
         }
     }
@@ -173,14 +182,13 @@ static frc2::Command* build_pickup_command(
     wpi::Twine path
 ) {
     FollowPolybezier follower { drivetrain, path, followerConfig };
-    auto start = follower.GetStartPoint();
 
     return new frc2::SequentialCommandGroup(
+        FollowPolybezier::ResetPoseCommand(drivetrain, follower.GetPath()),
         frc2::InstantCommand(
-            [intake, drivetrain, start] {
+            [intake] {
                 intake->IntakeExtend();
                 intake->IntakeStart();
-                drivetrain->SetPose(start.x, start.y, 0);
             },
             { intake }
         ),
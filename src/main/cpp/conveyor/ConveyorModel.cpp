@@ -0,0 +1,126 @@
+#include "conveyor/ConveyorModel.h"
+
+#include <algorithm>
+#include <cmath>
+
+ConveyorModel::ConveyorModel (const Configuration &config) : config(config) {}
+
+void ConveyorModel::Reset (int count) {
+    m_Count = 0;
+    m_UnseenExits = 0;
+
+    count = std::clamp(count, 0, kMaxCells);
+    for (int i = 0; i < count; i++) {
+        m_Positions[i] = std::max(config.feederPosition - i * config.cellDiameter, 0.0);
+    }
+    m_Count = count;
+}
+
+void ConveyorModel::Update (double dt, double conveyorSpeed, double feederSpeed) {
+    double limit = 1.0e9; // how far forward the cell ahead lets us go
+
+    for (int i = 0; i < m_Count; i++) {
+        double p = m_Positions[i];
+        bool inFeeder = p >= config.feederPosition;
+
+        double speed = inFeeder ? feederSpeed * config.feederCellSpeed : conveyorSpeed * config.conveyorCellSpeed;
+        double next = p + speed * dt;
+
+        // The feeder wheels hold back anything the conveyor pushes into them,
+        // unless they are turning forward.
+        if (!inFeeder && feederSpeed <= 0) {
+            next = std::min(next, config.feederPosition);
+        }
+
+        next = std::min(next, limit);
+        m_Positions[i] = next;
+        limit = next - config.cellDiameter;
+    }
+
+    // Cells gone past the exit without the exit beam seeing them, or spat
+    // back out of the intake.
+    while (0 < m_Count && m_Positions[0] > config.exitPosition + config.cellDiameter) {
+        Remove(0);
+        m_UnseenExits = std::min(m_UnseenExits + 1, kMaxCells);
+    }
+    while (0 < m_Count && m_Positions[m_Count - 1] < -config.cellDiameter) {
+        Remove(m_Count - 1);
+    }
+}
+
+void ConveyorModel::OnIntakeEdge () {
+    Insert(0.0);
+}
+
+void ConveyorModel::OnFeederEdge () {
+    // The closest cell not already past the feeder has arrived there.
+    for (int i = 0; i < m_Count; i++) {
+        if (m_Positions[i] <= config.feederPosition + config.cellDiameter * 0.5) {
+            m_Positions[i] = config.feederPosition;
+
+            // Anything behind it can't be closer than a cell diameter.
+            for (int j = i + 1; j < m_Count; j++) {
+                m_Positions[j] = std::min(m_Positions[j], m_Positions[j - 1] - config.cellDiameter);
+            }
+            return;
+        }
+    }
+
+    // We lost track of one.
+    Insert(config.feederPosition);
+}
+
+void ConveyorModel::OnExitEdge () {
+    if (0 < m_UnseenExits) {
+        m_UnseenExits--;
+        return;
+    }
+
+    if (0 < m_Count) {
+        Remove(0);
+    }
+}
+
+bool ConveyorModel::IsCellStaged () {
+    // Anywhere in the feeder, short of the flywheel, is one feed away.
+    for (int i = 0; i < m_Count; i++) {
+        double p = m_Positions[i];
+        if (p >= config.feederPosition - config.cellDiameter * 0.25 && p < config.exitPosition) {
+            return true;
+        }
+    }
+    return false;
+}
+
+double ConveyorModel::GetTimeUntilStaged (double conveyorSpeed) {
+    if (IsCellStaged()) return 0;
+
+    // Front-most cell still on the conveyor.
+    for (int i = 0; i < m_Count; i++) {
+        double remaining = config.feederPosition - m_Positions[i];
+        if (remaining <= 0) continue;
+
+        double speed = conveyorSpeed * config.conveyorCellSpeed;
+        return speed > 0 ? remaining / speed : -1;
+    }
+    return -1;
+}
+
+void ConveyorModel::Insert (double position) {
+    if (kMaxCells <= m_Count) return;
+
+    int i = m_Count;
+    while (0 < i && m_Positions[i - 1] < position) {
+        m_Positions[i] = m_Positions[i - 1];
+        i--;
+    }
+    m_Positions[i] = position;
+    m_Count++;
+}
+
+void ConveyorModel::Remove (int i) {
+    for (; i + 1 < m_Count; i++) {
+        m_Positions[i] = m_Positions[i + 1];
+    }
+    m_Count--;
+}
@@ -0,0 +1,66 @@
+#include "input/InputBindings.h"
+
+void InputBindings::OnPress (Condition condition, Action action) {
+    Binding binding;
+    binding.condition = std::move(condition);
+    binding.press = std::move(action);
+    m_Bindings.push_back(std::move(binding));
+}
+
+void InputBindings::OnPressRelease (Condition condition, Action press, Action release) {
+    Binding binding;
+    binding.condition = std::move(condition);
+    binding.press = std::move(press);
+    binding.release = std::move(release);
+    m_Bindings.push_back(std::move(binding));
+}
+
+void InputBindings::WhileHeld (Condition condition, frc2::Command* command) {
+    Binding binding;
+    binding.condition = std::move(condition);
+    binding.command = command;
+    m_Bindings.push_back(std::move(binding));
+}
+
+void InputBindings::Always (std::function<void(const InputSnapshot&)> action) {
+    Binding binding;
+    binding.always = std::move(action);
+    m_Bindings.push_back(std::move(binding));
+}
+
+void InputBindings::Evaluate (const InputSnapshot &input) {
+    for (auto &binding : m_Bindings) {
+        if (binding.always) {
+            binding.always(input);
+            continue;
+        }
+
+        bool active = binding.condition(input);
+
+        if (nullptr != binding.command) {
+            if (active && !binding.command->IsScheduled()) {
+                binding.command->Schedule();
+            } else if (!active && binding.command->IsScheduled()) {
+                binding.command->Cancel();
+            }
+        } else if (active && !binding.active) {
+            if (binding.press) binding.press();
+        } else if (!active && binding.active) {
+            if (binding.release) binding.release();
+        }
+
+        binding.active = active;
+    }
+}
+
+namespace Input {
+
+InputBindings::Condition Button (int port, int button) {
+    return [=](const InputSnapshot &input) { return input[port].GetButton(button); };
+}
+
+InputBindings::Condition POV (int port, int angle) {
+    return [=](const InputSnapshot &input) { return input[port].GetPOV() == angle; };
+}
+
+}
@@ -0,0 +1,40 @@
+#include "input/InputLog.h"
+
+#include <algorithm>
+#include <cmath>
+
+// The Driver Station scales axis bytes by 127 going up and 128 going down.
+#define kAxisScalePositive 127.0
+#define kAxisScaleNegative 128.0
+
+namespace InputLog {
+
+Controller pack (const ControllerState &state) {
+    Controller controller;
+
+    for (int i = 0; i < ControllerState::kMaxAxes; i++) {
+        double scale = state.axes[i] < 0 ? kAxisScaleNegative : kAxisScalePositive;
+        controller.axes[i] = (int8_t)std::clamp(std::lround(state.axes[i] * scale), -128L, 127L);
+    }
+
+    controller.pov = state.pov;
+    controller.buttons = state.buttons;
+
+    return controller;
+}
+
+ControllerState unpack (const Controller &controller) {
+    ControllerState state;
+
+    for (int i = 0; i < ControllerState::kMaxAxes; i++) {
+        double scale = controller.axes[i] < 0 ? kAxisScaleNegative : kAxisScalePositive;
+        state.axes[i] = (float)(controller.axes[i] / scale);
+    }
+
+    state.pov = controller.pov;
+    state.buttons = controller.buttons;
+
+    return state;
+}
+
+}
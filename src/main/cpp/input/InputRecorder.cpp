@@ -0,0 +1,94 @@
+#include "input/InputRecorder.h"
+
+#include <ctime>
+#include <iostream>
+
+#include <sys/stat.h>
+
+#include "util/Realtime.h"
+
+#define kWriterPeriod std::chrono::milliseconds(100)
+
+InputRecorder::InputRecorder (std::string directory) : m_Directory(std::move(directory)) {}
+
+InputRecorder::~InputRecorder () {
+    Stop();
+}
+
+void InputRecorder::Start () {
+    if (nullptr != m_File) return;
+
+    mkdir(m_Directory.c_str(), 0755);
+
+    // Wall clock is only right once the Driver Station has set it, but the
+    // name only needs to be unique.
+    char name[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(name, sizeof(name), "input-%Y%m%d-%H%M%S.bin", std::localtime(&now));
+
+    std::string path = m_Directory + "/" + name;
+    m_File = std::fopen(path.c_str(), "wb");
+    if (nullptr == m_File) {
+        std::cerr << "input recorder: can't open " << path << std::endl;
+        return;
+    }
+
+    InputLog::Header header;
+    std::fwrite(&header, sizeof(header), 1, m_File);
+
+    m_StartTime = hal::fpga_clock::now();
+    m_Dropped = 0;
+
+    m_Running = true;
+    m_Writer = std::thread(&InputRecorder::WriterThread, this);
+}
+
+void InputRecorder::Stop () {
+    if (nullptr == m_File) return;
+
+    m_Running = false;
+    m_Writer.join();
+
+    Drain();
+    std::fclose(m_File);
+    m_File = nullptr;
+
+    if (0 < m_Dropped) {
+        std::cerr << "input recorder: dropped " << m_Dropped << " loops" << std::endl;
+    }
+}
+
+void InputRecorder::Record (const InputSnapshot &input, InputLog::Mode mode) {
+    if (nullptr == m_File) return;
+
+    InputLog::Record record {};
+    record.timeMs = (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(hal::fpga_clock::now() - m_StartTime).count();
+    record.mode = mode;
+
+    for (int port = 0; port < InputSnapshot::kControllers; port++) {
+        record.controllers[port] = InputLog::pack(input[port].GetState());
+    }
+
+    if (!m_Queue.Push(record)) {
+        m_Dropped++;
+    }
+}
+
+std::size_t InputRecorder::Prefault () {
+    return Realtime::TouchPages(&m_Queue, sizeof(m_Queue));
+}
+
+void InputRecorder::WriterThread () {
+    while (m_Running) {
+        std::this_thread::sleep_for(kWriterPeriod);
+        Drain();
+    }
+}
+
+void InputRecorder::Drain () {
+    InputLog::Record record;
+    while (m_Queue.Pop(record)) {
+        std::fwrite(&record, sizeof(record), 1, m_File);
+    }
+    std::fflush(m_File);
+}
@@ -0,0 +1,21 @@
+#include "input/InputSource.h"
+
+#include <algorithm>
+
+#include <frc/DriverStation.h>
+
+void DriverStationInput::Read (int port, ControllerState &state) {
+    auto &ds = frc::DriverStation::GetInstance();
+
+    // Only ask for what is plugged in.  The Driver Station warns about every
+    // read of a missing axis or POV.
+    int axisCount = std::min(ds.GetStickAxisCount(port), ControllerState::kMaxAxes);
+
+    state.axes.fill(0.0f);
+    for (int axis = 0; axis < axisCount; axis++) {
+        state.axes[axis] = (float)ds.GetStickAxis(port, axis);
+    }
+
+    state.buttons = ds.GetStickButtons(port);
+    state.pov = 0 < ds.GetStickPOVCount(port) ? ds.GetStickPOV(port, 0) : -1;
+}
@@ -0,0 +1,53 @@
+#include "input/ReplayInput.h"
+
+#include <cstdio>
+#include <iostream>
+
+ReplayInput::ReplayInput (const std::string &path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (nullptr == file) {
+        std::cerr << "input replay: can't open " << path << std::endl;
+        return;
+    }
+
+    InputLog::Header header;
+    if (1 != std::fread(&header, sizeof(header), 1, file)
+            || InputLog::kMagic != header.magic
+            || InputLog::kVersion != header.version
+            || InputSnapshot::kControllers != header.controllers) {
+        std::cerr << "input replay: " << path << " is not a version " << InputLog::kVersion << " input log" << std::endl;
+        std::fclose(file);
+        return;
+    }
+
+    InputLog::Record record;
+    while (1 == std::fread(&record, sizeof(record), 1, file)) {
+        m_Records.push_back(record);
+    }
+
+    std::fclose(file);
+}
+
+void ReplayInput::NextLoop () {
+    // The first loop plays the first record.
+    if (!m_Started) {
+        m_Started = true;
+    } else if (!IsFinished()) {
+        m_Index++;
+    }
+}
+
+void ReplayInput::Read (int port, ControllerState &state) {
+    if (IsFinished() || port >= InputSnapshot::kControllers) {
+        state = ControllerState{};
+        return;
+    }
+
+    state = InputLog::unpack(m_Records[m_Index].controllers[port]);
+}
+
+InputLog::Mode ReplayInput::GetMode () {
+    if (IsFinished()) return InputLog::kDisabled;
+
+    return (InputLog::Mode)m_Records[m_Index].mode;
+}
@@ -0,0 +1,82 @@
+#include "instrumentation/AllocationTracking.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+// Allocating runs after the first are only reported this often.
+#define kReportEvery 250
+
+// Every allocation by this thread, and those already blamed on a region that
+// has ended, so an enclosing region doesn't count them again.
+static thread_local uint64_t allocations = 0;
+static thread_local uint64_t attributed = 0;
+
+namespace AllocationTracking {
+
+uint64_t GetCount () {
+    return allocations;
+}
+
+}
+
+void AllocationSite::Record (uint64_t count) {
+    if (m_Runs < kWarmUpRuns) {
+        m_Runs++;
+        return;
+    }
+
+    if (0 == count) return;
+
+    static const bool fail = nullptr != std::getenv("ALLOCATION_TRACKING") && 0 == std::strcmp(std::getenv("ALLOCATION_TRACKING"), "fail");
+
+    if (0 == m_AllocatingRuns++ % kReportEvery) {
+        std::cerr << "allocation tracking: " << m_Name << " made " << count << " allocations after warm-up ("
+            << m_AllocatingRuns << " such runs so far)" << std::endl;
+    }
+
+    if (fail) {
+        std::abort();
+    }
+}
+
+NoAllocRegion::NoAllocRegion (AllocationSite &site) : m_Site(site), m_Start(allocations), m_NestedStart(attributed) {}
+
+NoAllocRegion::~NoAllocRegion () {
+    uint64_t nested = attributed - m_NestedStart;
+    m_Site.Record(allocations - m_Start - nested);
+
+    // Everything since the start, including any report, is accounted for.
+    attributed = m_NestedStart + (allocations - m_Start);
+}
+
+#ifdef ALLOCATION_TRACKING
+
+void* operator new (std::size_t size) {
+    allocations++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[] (std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete (void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[] (void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete (void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[] (void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+#endif
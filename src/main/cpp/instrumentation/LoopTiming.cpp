@@ -0,0 +1,127 @@
+#include "instrumentation/LoopTiming.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <networktables/NetworkTable.h>
+#include <networktables/NetworkTableInstance.h>
+
+constexpr std::chrono::milliseconds kLoopPeriod(20);
+constexpr std::chrono::milliseconds kOverrunSlop(1);
+constexpr std::chrono::seconds kPublishPeriod(1);
+
+// Every histogram, so they can all be published together.  Only touched from
+// the main thread.
+static std::vector<TimingHistogram*>& histograms () {
+    static std::vector<TimingHistogram*> all;
+    return all;
+}
+
+TimingHistogram::TimingHistogram (std::string name) : m_Name(std::move(name)) {
+    histograms().push_back(this);
+}
+
+void TimingHistogram::Record (std::chrono::nanoseconds duration) {
+    uint32_t micros = (uint32_t)std::max<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count(), 0);
+
+    m_Counts[Bucket(micros)]++;
+    m_Total++;
+    m_MaxMicros = std::max(m_MaxMicros, (double)micros);
+}
+
+double TimingHistogram::GetPercentile (double fraction) {
+    if (0 == m_Total) return 0;
+
+    uint32_t wanted = (uint32_t)std::ceil(fraction * m_Total);
+    uint32_t seen = 0;
+
+    for (int i = 0; i < kBuckets; i++) {
+        seen += m_Counts[i];
+        if (seen >= wanted) {
+            return std::min(BucketLimit(i), m_MaxMicros);
+        }
+    }
+
+    return m_MaxMicros;
+}
+
+void TimingHistogram::Publish () {
+    if (!m_EntriesResolved) {
+        auto table = nt::NetworkTableInstance::GetDefault().GetTable("Timing")->GetSubTable(m_Name);
+        m_P50Entry = table->GetEntry("p50");
+        m_P99Entry = table->GetEntry("p99");
+        m_MaxEntry = table->GetEntry("max");
+        m_EntriesResolved = true;
+    }
+
+    m_P50Entry.SetDouble(GetPercentile(0.50) / 1000.0);
+    m_P99Entry.SetDouble(GetPercentile(0.99) / 1000.0);
+    m_MaxEntry.SetDouble(GetMax() / 1000.0);
+}
+
+void TimingHistogram::Reset () {
+    m_Counts.fill(0);
+    m_Total = 0;
+    m_MaxMicros = 0;
+}
+
+int TimingHistogram::Bucket (uint32_t micros) {
+    if (micros < 2) return 0;
+
+    // Octave from the top set bit, then the next two bits pick the quarter.
+    int octave = 31 - __builtin_clz(micros);
+    int quarter = (micros >> std::max(octave - 2, 0)) & (kBucketsPerOctave - 1);
+
+    return std::min(octave * kBucketsPerOctave + quarter, kBuckets - 1);
+}
+
+double TimingHistogram::BucketLimit (int bucket) {
+    int octave = bucket / kBucketsPerOctave;
+    int quarter = bucket % kBucketsPerOctave;
+
+    return std::ldexp(1.0 + (quarter + 1) / (double)kBucketsPerOctave, octave);
+}
+
+namespace LoopTiming {
+
+static TimingHistogram loopPeriod {"Loop"};
+static std::chrono::steady_clock::time_point lastLoop;
+static std::chrono::steady_clock::time_point lastPublish;
+static int overruns = 0;
+static nt::NetworkTableEntry overrunEntry;
+
+void StartLoop () {
+    auto now = std::chrono::steady_clock::now();
+
+    if (lastLoop.time_since_epoch().count() != 0) {
+        auto period = now - lastLoop;
+        loopPeriod.Record(period);
+
+        if (period > kLoopPeriod + kOverrunSlop) {
+            overruns++;
+        }
+    } else {
+        lastPublish = now;
+        overrunEntry = nt::NetworkTableInstance::GetDefault().GetTable("Timing")->GetEntry("overruns");
+    }
+
+    lastLoop = now;
+
+    if (now - lastPublish >= kPublishPeriod) {
+        Publish();
+        lastPublish = now;
+    }
+}
+
+void Publish () {
+    for (auto histogram : histograms()) {
+        histogram->Publish();
+        histogram->Reset();
+    }
+
+    // Running total, so nothing is missed between dashboard refreshes.
+    overrunEntry.SetDouble(overruns);
+}
+
+}
@@ -0,0 +1,66 @@
+#include "shooter/FlywheelObserver.h"
+
+#include <algorithm>
+#include <cmath>
+
+#define kNeverRecovers 1.0e3
+
+FlywheelObserver::FlywheelObserver (const Configuration &config) : config(config) {}
+
+void FlywheelObserver::Reset (double speed) {
+    m_Speed = speed;
+    m_Load = 0;
+    m_ShotCount = 0;
+    m_Recovering = false;
+
+    m_History.fill(speed);
+}
+
+void FlywheelObserver::Update (double dt, double voltage, double current, double encoderSpeed) {
+    if (dt <= 0) return;
+
+    // Predict from the voltage we applied.
+    double friction = std::fabs(m_Speed) > 1.0 ? std::copysign(config.ks, m_Speed) : 0.0;
+    double accel = (voltage - friction - config.kv * m_Speed) / config.ka - m_Load;
+    m_Speed += accel * dt;
+
+    // Back EMF is available right now.
+    double emfSpeed = (voltage - current * config.resistance) * config.motorKv * config.motorRatio;
+    double emfError = emfSpeed - m_Speed;
+
+    // The encoder is telling us about the past.
+    int lag = std::clamp((int)std::lround(config.encoderLag / dt), 0, kHistorySize - 1);
+    double pastSpeed = m_History[(m_HistoryHead + kHistorySize - lag) % kHistorySize];
+    double encoderError = encoderSpeed - pastSpeed;
+
+    double correction = config.emfGain * emfError + config.encoderGain * encoderError;
+    m_Speed += correction;
+
+    // Slower than predicted means something is dragging on the wheel.
+    m_Load -= config.loadGain * correction / dt;
+    m_Load = std::max(m_Load, 0.0);
+
+    m_HistoryHead = (m_HistoryHead + 1) % kHistorySize;
+    m_History[m_HistoryHead] = m_Speed;
+
+    // Count a shot on the way into a dip, and stay recovering until the load
+    // falls back to half the trigger level.
+    if (!m_Recovering && m_Load > config.dipLoad) {
+        m_Recovering = true;
+        m_ShotCount++;
+    } else if (m_Recovering && m_Load < config.dipLoad * 0.5) {
+        m_Recovering = false;
+    }
+}
+
+double FlywheelObserver::PredictRecoveryTime (double target, double voltage) {
+    if (m_Speed >= target) return 0;
+    if (config.kv <= 0) return kNeverRecovers;
+
+    // First order response toward the speed voltage can hold.
+    double finalSpeed = (voltage - config.ks) / config.kv;
+    if (finalSpeed <= target) return kNeverRecovers;
+
+    double timeConstant = config.ka / config.kv;
+    return timeConstant * std::log((finalSpeed - m_Speed) / (finalSpeed - target));
+}
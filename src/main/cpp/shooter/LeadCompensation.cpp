@@ -0,0 +1,33 @@
+#include "shooter/LeadCompensation.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Lead {
+
+Solution solve (double range, double bearing, double robotSpeed, double ballSpeed) {
+    if (ballSpeed <= 0 || range <= 0) {
+        return {0, range, 0};
+    }
+
+    // Split robot velocity along the line of sight (closing speed) and across it.
+    double closingSpeed = robotSpeed * std::cos(bearing);
+    double crossSpeed = -robotSpeed * std::sin(bearing);
+
+    // Turn the shot against the cross speed so the sideways drift cancels.
+    double aimOffset = -std::asin(std::clamp(crossSpeed / ballSpeed, -1.0, 1.0));
+
+    // Whatever is left of the ball speed, plus our closing speed, carries the
+    // cell down the line of sight.
+    double downRangeSpeed = ballSpeed * std::cos(aimOffset) + closingSpeed;
+    if (downRangeSpeed <= 0.1) {
+        // Running away from the target faster than we can shoot.  Don't lead.
+        return {0, range, range / ballSpeed};
+    }
+
+    double flightTime = range / downRangeSpeed;
+
+    return {aimOffset, ballSpeed * flightTime, flightTime};
+}
+
+}
@@ -0,0 +1,29 @@
+#include "shooter/SpinUpModel.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Weight of the newest spin-up, once a bucket has a few samples.
+#define kLearningRate 0.3
+
+double SpinUpModel::Predict (double target, double modelTime) {
+    return modelTime * m_Factor[Bucket(target)];
+}
+
+void SpinUpModel::Learn (double target, double modelTime, double actualTime) {
+    // Too short to say anything useful about the ratio.
+    if (modelTime < 0.02 || actualTime < 0.02) return;
+
+    int bucket = Bucket(target);
+    double ratio = std::clamp(actualTime / modelTime, 0.25, 8.0);
+
+    // Average the first few samples evenly, then start forgetting.
+    m_Samples[bucket]++;
+    double rate = std::max(1.0 / m_Samples[bucket], kLearningRate);
+
+    m_Factor[bucket] += rate * (ratio - m_Factor[bucket]);
+}
+
+int SpinUpModel::Bucket (double target) {
+    return std::clamp((int)(std::fabs(target) / kBucketWidth), 0, kBuckets - 1);
+}
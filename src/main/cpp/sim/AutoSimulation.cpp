@@ -0,0 +1,206 @@
+#include "sim/AutoSimulation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <sstream>
+
+#include <frc/simulation/DriverStationSim.h>
+#include <frc2/Timer.h>
+#include <frc2/command/CommandScheduler.h>
+
+#include "RobotContainer.h"
+
+// Loops to sit disabled before each routine.
+#define kSettleLoops 10
+
+// Length of the autonomous period, after which a routine has failed to finish.
+#define kMatchTime 15.0
+
+// The robot has started the routine once it is this far (m, radians) from
+// where it sat.
+#define kMovedDistance 0.001_m
+#define kMovedAngle 0.001
+
+// CPU time used by this thread, in seconds.
+static double ThreadTime () {
+    timespec time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return time.tv_sec + time.tv_nsec / 1.0e9;
+}
+
+AutoSimulation::AutoSimulation (RobotContainer &container, const std::string &routines) : m_Container(container) {
+    if ("all" == routines) {
+        m_Routines = m_Container.GetAutonomousNames();
+    } else if ("paths" == routines) {
+        for (auto &name : m_Container.GetAutonomousNames()) {
+            if (0 == name.compare(0, std::strlen(RobotContainer::kPathRoutinePrefix), RobotContainer::kPathRoutinePrefix)) {
+                m_Routines.push_back(name);
+            }
+        }
+    } else {
+        std::stringstream list {routines};
+        std::string name;
+        while (std::getline(list, name, ',')) {
+            if (!name.empty()) m_Routines.push_back(name);
+        }
+    }
+
+    std::cout << "auto sim: running " << m_Routines.size() << " routines" << std::endl;
+}
+
+bool AutoSimulation::Periodic () {
+    if (m_Current >= m_Routines.size()) {
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_Begin).count();
+        std::cout << "auto sim: finished " << m_Routines.size() << " routines in " << wall << " seconds" << std::endl;
+        return false;
+    }
+
+    if (!m_Running) {
+        if (0 == m_DisabledLoops) Start();
+
+        // Enabling takes effect next loop, where AutonomousInit schedules it.
+        if (++m_DisabledLoops >= kSettleLoops) {
+            m_Command = m_Container.GetAutonomousCommand();
+            m_Scheduled = false;
+            m_StartTime = frc2::Timer::GetFPGATimestamp().to<double>();
+            m_LastLoop = ThreadTime();
+            m_RoutineStart = std::chrono::steady_clock::now();
+            m_Running = true;
+
+            frc::sim::DriverStationSim::SetAutonomous(true);
+            frc::sim::DriverStationSim::SetEnabled(true);
+            frc::sim::DriverStationSim::NotifyNewData();
+        }
+        return true;
+    }
+
+    double now = ThreadTime();
+    double loop = now - m_LastLoop;
+    m_LastLoop = now;
+    m_Result.loops++;
+    m_Result.loopTotal += loop;
+    m_Result.loopMax = std::max(m_Result.loopMax, loop);
+
+    TrackStart();
+
+    bool scheduled = nullptr != m_Command && m_Command->IsScheduled();
+    m_Scheduled = m_Scheduled || scheduled;
+
+    double elapsed = frc2::Timer::GetFPGATimestamp().to<double>() - m_StartTime;
+    if (nullptr == m_Command || (m_Scheduled && !scheduled)) {
+        Finish(nullptr != m_Command);
+    } else if (elapsed >= kMatchTime) {
+        Finish(false);
+    }
+
+    return true;
+}
+
+void AutoSimulation::Start () {
+    const std::string &name = m_Routines[m_Current];
+
+    frc::sim::DriverStationSim::SetEnabled(false);
+    frc::sim::DriverStationSim::NotifyNewData();
+    frc2::CommandScheduler::GetInstance().CancelAll();
+
+    RobotSimulation* simulation = m_Container.m_Simulation;
+    simulation->Reset();
+    m_Container.m_Drivetrain->ResetPose();
+    m_Container.m_PowerCellCounter->SetCount(simulation->GetPreloadedCells());
+    m_Container.SelectAutonomous(name);
+
+    FollowPolybezier::TakeTrackingStats();
+
+    m_Result = Result{};
+    m_Result.name = name;
+
+    m_Started = false;
+    m_Moved = false;
+}
+
+void AutoSimulation::Finish (bool finished) {
+    if (nullptr != m_Command && m_Command->IsScheduled()) {
+        m_Command->Cancel();
+    }
+
+    RobotSimulation* simulation = m_Container.m_Simulation;
+    m_Result.matchTime = frc2::Timer::GetFPGATimestamp().to<double>() - m_StartTime;
+    m_Result.finished = finished;
+    m_Result.pickedUp = simulation->GetCellsPickedUp();
+    m_Result.shot = simulation->GetCellsShot();
+    m_Result.tracking = FollowPolybezier::TakeTrackingStats();
+    m_Result.drift = MeasureDrift();
+    m_Result.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_RoutineStart).count();
+
+    Report(m_Result);
+
+    frc::sim::DriverStationSim::SetEnabled(false);
+    frc::sim::DriverStationSim::NotifyNewData();
+
+    m_Running = false;
+    m_DisabledLoops = 0;
+    m_Current++;
+}
+
+void AutoSimulation::TrackStart () {
+    if (m_Moved) return;
+
+    frc::Pose2d truth = m_Container.m_Simulation->GetDrivetrain()->GetTruePose();
+
+    // Until the robot moves, odometry may still be reset to where the
+    // routine starts, so keep taking both poses.
+    if (m_Started && (truth.Translation().Distance(m_TrueStart.Translation()) > kMovedDistance
+            || std::fabs((truth.Rotation() - m_TrueStart.Rotation()).Radians().to<double>()) > kMovedAngle)) {
+        m_Moved = true;
+        return;
+    }
+
+    m_TrueStart = truth;
+    m_OdometryStart = m_Container.m_Drivetrain->GetPose();
+    m_Started = true;
+}
+
+double AutoSimulation::MeasureDrift () {
+    if (!m_Started) return 0;
+
+    // Each pose from where it started, in its own start frame.  The plant
+    // starts at the origin facing +x, wherever the routine told odometry it
+    // was, and only the travel since then should agree.
+    frc::Pose2d odometry = m_Container.m_Drivetrain->GetPose().RelativeTo(m_OdometryStart);
+    frc::Pose2d truth = m_Container.m_Simulation->GetDrivetrain()->GetTruePose().RelativeTo(m_TrueStart);
+
+    return odometry.Translation().Distance(truth.Translation()).to<double>();
+}
+
+void AutoSimulation::Report (const Result &result) {
+    std::cout << "auto sim: " << result.name << std::endl;
+
+    if (nullptr == m_Command) {
+        std::cout << "    no such routine" << std::endl;
+        return;
+    }
+
+    if (result.finished) {
+        std::cout << "    finished in " << result.matchTime << " s" << std::endl;
+    } else {
+        std::cout << "    timed out after " << result.matchTime << " s" << std::endl;
+    }
+
+    std::cout << "    cells: picked up " << result.pickedUp << ", shot " << result.shot << std::endl;
+
+    if (0 < result.tracking.samples) {
+        std::cout << "    cross-track error: mean " << result.tracking.total / result.tracking.samples
+            << " m, max " << result.tracking.max << " m" << std::endl;
+    }
+
+    std::cout << "    odometry drift: " << result.drift << " m" << std::endl;
+
+    if (0 < result.loops) {
+        std::cout << "    loop CPU: mean " << 1000.0 * result.loopTotal / result.loops
+            << " ms, max " << 1000.0 * result.loopMax << " ms" << std::endl;
+        std::cout << "    " << result.matchTime / result.wallTime << "x real time" << std::endl;
+    }
+}
@@ -0,0 +1,80 @@
+#include "sim/CellPlant.h"
+
+#include <cmath>
+
+// The intake reaches this far (m) ahead of the middle of the robot, and picks
+// up cells within this distance of that point.
+#define kIntakeReach 0.5
+#define kIntakeWidth 0.35
+
+// The hopper can't take more than this.
+#define kMaxCells 5
+
+static ConveyorModel::Configuration ReadConfiguration (std::shared_ptr<cpptoml::table> toml) {
+    ConveyorModel::Configuration config;
+    config.feederPosition    = toml->get_qualified_as<double>("feederPosition").value_or(0.0);
+    config.exitPosition      = toml->get_qualified_as<double>("exitPosition").value_or(0.0);
+    config.cellDiameter      = toml->get_qualified_as<double>("cellDiameter").value_or(0.178);
+    config.conveyorCellSpeed = toml->get_qualified_as<double>("cellSpeed.conveyor").value_or(0.0);
+    config.feederCellSpeed   = toml->get_qualified_as<double>("cellSpeed.feeder").value_or(0.0);
+    return config;
+}
+
+CellPlant::CellPlant (std::shared_ptr<cpptoml::table> toml, std::vector<frc::Translation2d> field)
+    : config(ReadConfiguration(toml)), m_Cells(config), m_Field(std::move(field)), m_OnField(m_Field.size(), true)
+{
+    UpdateBeams();
+}
+
+void CellPlant::Update (double dt, const frc::Pose2d &pose, Intake* intake, ShooterPlant* shooter) {
+    if (nullptr == intake) return;
+
+    int before = m_Cells.GetCount();
+    m_Cells.Update(dt, intake->GetConveyorSpeed(), intake->GetFeederSpeed());
+
+    // Cells only leave the front while feeding.
+    if (0 < intake->GetFeederSpeed()) {
+        for (int i = m_Cells.GetCount(); i < before; i++) {
+            m_Shot++;
+            shooter->OnShot();
+        }
+    }
+
+    // Intake rollers pull in at negative output.
+    if (intake->IsExtended() && intake->GetIntakeSpeed() < 0 && m_Cells.GetCount() < kMaxCells) {
+        frc::Translation2d reach = pose.Translation() + frc::Translation2d{units::meter_t{kIntakeReach}, pose.Rotation()};
+
+        for (size_t i = 0; i < m_Field.size(); i++) {
+            if (m_OnField[i] && reach.Distance(m_Field[i]) < units::meter_t{kIntakeWidth}) {
+                m_OnField[i] = false;
+                m_Cells.OnIntakeEdge();
+                m_PickedUp++;
+                break;
+            }
+        }
+    }
+
+    UpdateBeams();
+}
+
+void CellPlant::Reset (int count) {
+    m_Cells.Reset(count);
+    m_OnField.assign(m_Field.size(), true);
+    m_PickedUp = 0;
+    m_Shot = 0;
+
+    UpdateBeams();
+}
+
+bool CellPlant::IsBeamBroken (double position) {
+    for (int i = 0; i < m_Cells.GetCount(); i++) {
+        if (std::fabs(m_Cells.GetPosition(i) - position) < config.cellDiameter / 2.0) return true;
+    }
+    return false;
+}
+
+void CellPlant::UpdateBeams () {
+    m_InBeam.SetValue(IsBeamBroken(0.0));
+    m_OutBeam.SetValue(IsBeamBroken(config.exitPosition));
+    m_FeederBeam.SetValue(IsBeamBroken(config.feederPosition));
+}
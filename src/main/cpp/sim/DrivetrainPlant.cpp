@@ -0,0 +1,150 @@
+#include "sim/DrivetrainPlant.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Time constant (s) of the wheels stopping with the brake on.
+#define kBrakeLag 0.05
+
+// One NEO's winding resistance (ohms) and back EMF (V per m/s of wheel
+// speed), for current draw.
+#define kMotorResistance 0.114
+#define kBackEmf 2.82
+
+DrivetrainPlant::DrivetrainPlant (std::shared_ptr<cpptoml::table> toml, std::shared_ptr<cpptoml::table> sim) {
+    config.ks = toml->get_qualified_as<double>("kinematics.ks").value_or(0.0);
+    config.kv = toml->get_qualified_as<double>("kinematics.kv").value_or(0.0);
+    config.ka = toml->get_qualified_as<double>("kinematics.ka").value_or(0.0);
+
+    double kw = toml->get_qualified_as<double>("kinematics.kw").value_or(0.0);
+    config.trackWidth = 0 < config.kv ? 2.0 * kw / config.kv : 0.6;
+
+    config.noise = {0, 0, 0, 0, 1720};
+
+    if (sim) {
+        config.trackWidth      = sim->get_qualified_as<double>("trackWidth").value_or(config.trackWidth);
+        config.noise.slip      = sim->get_qualified_as<double>("noise.slip").value_or(0.0);
+        config.noise.velocity  = sim->get_qualified_as<double>("noise.velocity").value_or(0.0);
+        config.noise.gyro      = sim->get_qualified_as<double>("noise.gyro").value_or(0.0);
+        config.noise.gyroDrift = sim->get_qualified_as<double>("noise.gyroDrift").value_or(0.0);
+        config.noise.seed      = sim->get_qualified_as<unsigned int>("noise.seed").value_or(1720);
+    }
+
+    m_Random.seed(config.noise.seed);
+}
+
+void DrivetrainPlant::Set (double left, double right) {
+    Advance();
+    m_Left = std::clamp(left, -1.0, 1.0);
+    m_Right = std::clamp(right, -1.0, 1.0);
+}
+
+void DrivetrainPlant::SetBrake (bool on) {
+    Advance();
+    m_Brake = on;
+}
+
+double DrivetrainPlant::GetLeftPosition () {
+    Advance();
+    return m_LeftPosition;
+}
+
+double DrivetrainPlant::GetRightPosition () {
+    Advance();
+    return m_RightPosition;
+}
+
+void DrivetrainPlant::ResetPosition () {
+    Advance();
+    m_LeftPosition = 0;
+    m_RightPosition = 0;
+}
+
+double DrivetrainPlant::GetLeftVelocity () {
+    Advance();
+    return m_LeftSpeed + Noise(config.noise.velocity);
+}
+
+double DrivetrainPlant::GetRightVelocity () {
+    Advance();
+    return m_RightSpeed + Noise(config.noise.velocity);
+}
+
+double DrivetrainPlant::GetOutputCurrent () {
+    Advance();
+
+    double left = std::fabs(m_Left * kBusVoltage - kBackEmf * m_LeftSpeed) / kMotorResistance;
+    double right = std::fabs(m_Right * kBusVoltage - kBackEmf * m_RightSpeed) / kMotorResistance;
+    return (left + right) / 2.0;
+}
+
+units::degree_t DrivetrainPlant::GetGyroAngle () {
+    Advance();
+
+    // The navX reads clockwise positive.
+    units::degree_t angle = units::radian_t{-(m_Heading - m_GyroZero)};
+    return angle + units::degree_t{m_GyroDrift + Noise(config.noise.gyro)};
+}
+
+frc::Pose2d DrivetrainPlant::GetTruePose () {
+    Advance();
+    return frc::Pose2d{units::meter_t{m_X}, units::meter_t{m_Y}, frc::Rotation2d{units::radian_t{m_Heading}}};
+}
+
+void DrivetrainPlant::Reset (frc::Pose2d pose) {
+    Restart();
+
+    m_Random.seed(config.noise.seed);
+
+    m_Left = m_Right = 0;
+    m_X = pose.X().to<double>();
+    m_Y = pose.Y().to<double>();
+    m_Heading = pose.Rotation().Radians().to<double>();
+    m_LeftSpeed = m_RightSpeed = 0;
+    m_LeftPosition = m_RightPosition = 0;
+    m_GyroZero = m_Heading;
+    m_GyroDrift = 0;
+}
+
+void DrivetrainPlant::Step (double dt) {
+    if (m_Brake && 0 == m_Left && 0 == m_Right) {
+        m_LeftSpeed -= m_LeftSpeed * std::min(1.0, dt / kBrakeLag);
+        m_RightSpeed -= m_RightSpeed * std::min(1.0, dt / kBrakeLag);
+    } else {
+        m_LeftSpeed = StepSide(m_LeftSpeed, m_Left * kBusVoltage, dt);
+        m_RightSpeed = StepSide(m_RightSpeed, m_Right * kBusVoltage, dt);
+    }
+
+    double speed = (m_LeftSpeed + m_RightSpeed) / 2.0;
+
+    m_Heading += (m_RightSpeed - m_LeftSpeed) / config.trackWidth * dt;
+    m_X += speed * std::cos(m_Heading) * dt;
+    m_Y += speed * std::sin(m_Heading) * dt;
+
+    m_LeftPosition += m_LeftSpeed * dt * (1.0 + Noise(config.noise.slip));
+    m_RightPosition += m_RightSpeed * dt * (1.0 + Noise(config.noise.slip));
+    m_GyroDrift += config.noise.gyroDrift * dt;
+}
+
+double DrivetrainPlant::StepSide (double speed, double voltage, double dt) {
+    // Static friction holds a stopped wheel until the voltage beats it.
+    if (std::fabs(speed) < 1.0e-3 && std::fabs(voltage) <= config.ks) {
+        return 0;
+    }
+
+    double direction = std::fabs(speed) < 1.0e-3 ? std::copysign(1.0, voltage) : std::copysign(1.0, speed);
+    double a = (voltage - config.ks * direction - config.kv * speed) / config.ka;
+    double next = speed + a * dt;
+
+    // Friction stops the wheel, it doesn't reverse it.
+    if (0 != speed && std::signbit(next) != std::signbit(speed) && std::fabs(voltage) <= config.ks) {
+        return 0;
+    }
+    return next;
+}
+
+double DrivetrainPlant::Noise (double deviation) {
+    if (deviation <= 0) return 0;
+
+    return std::normal_distribution<double>{0.0, deviation}(m_Random);
+}
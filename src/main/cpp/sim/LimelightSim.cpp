@@ -0,0 +1,42 @@
+#include "sim/LimelightSim.h"
+
+#include <cmath>
+
+#include <networktables/NetworkTableInstance.h>
+
+// Half the Limelight 2's field of view, degrees.
+#define kHalfFovX 29.8
+#define kHalfFovY 24.85
+
+// LED mode the shooter sets for on.
+#define kLedOn 3
+
+LimelightSim::LimelightSim (std::shared_ptr<cpptoml::table> toml, frc::Translation2d target, units::degree_t turretZero)
+    : m_Target(target), m_TurretZero(turretZero)
+{
+    config.cameraHeight = toml->get_qualified_as<double>("vision.cameraHeight").value_or(0.56);
+    config.cameraPitch  = toml->get_qualified_as<double>("vision.cameraPitch").value_or(27.0);
+    config.targetHeight = toml->get_qualified_as<double>("vision.targetHeight").value_or(2.496);
+
+    m_Table = nt::NetworkTableInstance::GetDefault().GetTable("limelight-gears");
+    m_Table->PutNumber("tv", 0);
+}
+
+void LimelightSim::Update (const frc::Pose2d &pose, units::degree_t turretAngle) {
+    frc::Translation2d offset = m_Target - pose.Translation();
+    double distance = offset.Norm().to<double>();
+
+    // Both clockwise from where the camera points, like tx.
+    double bearing = -(std::atan2(offset.Y().to<double>(), offset.X().to<double>()) * 180.0 / M_PI - pose.Rotation().Degrees().to<double>());
+    double tx = std::remainder(bearing - (m_TurretZero + turretAngle).to<double>(), 360.0);
+    double ty = std::atan2(config.targetHeight - config.cameraHeight, distance) * 180.0 / M_PI - config.cameraPitch;
+
+    bool lit = kLedOn == (int)m_Table->GetNumber("ledMode", 0);
+    bool visible = lit && std::fabs(tx) < kHalfFovX && std::fabs(ty) < kHalfFovY;
+
+    m_Table->PutNumber("tv", visible ? 1 : 0);
+    if (visible) {
+        m_Table->PutNumber("tx", tx);
+        m_Table->PutNumber("ty", ty);
+    }
+}
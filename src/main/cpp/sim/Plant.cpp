@@ -0,0 +1,28 @@
+#include "sim/Plant.h"
+
+#include <algorithm>
+
+#include <frc2/Timer.h>
+
+// Seconds per physics step.  Small enough that a 20 ms loop never sees the
+// models go unstable.
+#define kPlantStep 0.001
+
+void Plant::Advance () {
+    double now = frc2::Timer::GetFPGATimestamp().to<double>();
+
+    if (m_Time < 0) {
+        m_Time = now;
+        return;
+    }
+
+    while (m_Time < now) {
+        double dt = std::min(kPlantStep, now - m_Time);
+        Step(dt);
+        m_Time += dt;
+    }
+}
+
+void Plant::Restart () {
+    m_Time = frc2::Timer::GetFPGATimestamp().to<double>();
+}
@@ -0,0 +1,52 @@
+#include "sim/RobotSimulation.h"
+
+#include <vector>
+
+#include <frc2/Timer.h>
+
+static frc::Translation2d ReadPoint (std::shared_ptr<cpptoml::table> table) {
+    return frc::Translation2d{
+        units::meter_t{table->get_as<double>("x").value_or(0.0)},
+        units::meter_t{table->get_as<double>("y").value_or(0.0)}
+    };
+}
+
+RobotSimulation::RobotSimulation (std::shared_ptr<cpptoml::table> robot, std::shared_ptr<cpptoml::table> field)
+    : m_Drivetrain(robot->get_table("drivetrain"), field->get_table("drivetrain")), m_Shooter(robot->get_table("shooter"))
+{
+    m_PreloadedCells = field->get_qualified_as<int>("robot.preloadedCells").value_or(3);
+    auto turretZero = units::degree_t{field->get_qualified_as<double>("robot.turretZero").value_or(0.0)};
+
+    frc::Translation2d target;
+    if (auto table = field->get_table("target")) {
+        target = ReadPoint(table);
+    }
+
+    std::vector<frc::Translation2d> cells;
+    if (auto tables = field->get_table_array("cell")) {
+        for (auto &table : *tables) {
+            cells.push_back(ReadPoint(table));
+        }
+    }
+
+    m_Cells = std::make_unique<CellPlant>(robot->get_table("conveyor"), cells);
+    m_Limelight = std::make_unique<LimelightSim>(robot->get_table("shooter"), target, turretZero);
+}
+
+void RobotSimulation::Reset () {
+    m_Drivetrain.Reset();
+    m_Shooter.Reset();
+    m_Cells->Reset(m_PreloadedCells);
+    m_Time = -1.0;
+}
+
+void RobotSimulation::Update () {
+    double now = frc2::Timer::GetFPGATimestamp().to<double>();
+    double dt = m_Time < 0 ? 0 : now - m_Time;
+    m_Time = now;
+
+    frc::Pose2d pose = m_Drivetrain.GetTruePose();
+
+    m_Cells->Update(dt, pose, m_Intake, &m_Shooter);
+    m_Limelight->Update(pose, m_Shooter.GetTurretAngle());
+}
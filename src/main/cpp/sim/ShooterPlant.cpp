@@ -0,0 +1,124 @@
+#include "sim/ShooterPlant.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Must match Shooter.cpp.  Motor rpm per wheel rpm, and encoder ticks per
+// turret revolution.
+#define kMotorRpmPerWheelRpm ((18.0 / 24.0) * (2700.0 / 1500.0))
+#define kTurretTicksPerRevolution (4096 * (20.0 / 3.0))
+
+// Fraction of its speed the flywheel gives up to a cell.
+#define kShotSpeedLoss 0.12
+
+// Time constant (s) of the turret reaching the speed it's given.
+#define kTurretLag 0.05
+
+ShooterPlant::ShooterPlant (std::shared_ptr<cpptoml::table> toml) {
+    config.ks         = toml->get_qualified_as<double>("flywheel.ks").value_or(0.12);
+    config.kv         = toml->get_qualified_as<double>("flywheel.kv").value_or(0.00285);
+    config.ka         = toml->get_qualified_as<double>("flywheel.ka").value_or(0.0021);
+    config.resistance = toml->get_qualified_as<double>("flywheel.resistance").value_or(0.114);
+    config.motorKv    = toml->get_qualified_as<double>("flywheel.motorKv").value_or(473.0);
+}
+
+void ShooterPlant::ConfigureFlywheel (const Gains &gains) {
+    Advance();
+    m_Gains = gains;
+}
+
+void ShooterPlant::SetFlywheelVelocity (double motorRpm) {
+    Advance();
+    if (motorRpm != m_Setpoint) {
+        m_Integral = 0;
+    }
+    m_Setpoint = motorRpm;
+}
+
+void ShooterPlant::StopFlywheel () {
+    Advance();
+    m_Setpoint = 0;
+    m_Integral = 0;
+}
+
+double ShooterPlant::GetFlywheelVelocity () {
+    Advance();
+    return m_WheelSpeed * kMotorRpmPerWheelRpm;
+}
+
+double ShooterPlant::GetFlywheelAppliedOutput () {
+    Advance();
+    return m_Output;
+}
+
+double ShooterPlant::GetFlywheelCurrent () {
+    Advance();
+
+    double backEmf = m_WheelSpeed * kMotorRpmPerWheelRpm / config.motorKv;
+    return std::fabs(m_Output * kBusVoltage - backEmf) / config.resistance;
+}
+
+void ShooterPlant::SetTurretVelocity (double ticksPer100ms) {
+    Advance();
+    m_TurretSetpoint = ticksPer100ms;
+}
+
+void ShooterPlant::StopTurret () {
+    Advance();
+    m_TurretSetpoint = 0;
+}
+
+double ShooterPlant::GetTurretPosition () {
+    Advance();
+    return m_TurretPosition;
+}
+
+units::degree_t ShooterPlant::GetTurretAngle () {
+    return units::degree_t{360.0 * GetTurretPosition() / kTurretTicksPerRevolution};
+}
+
+double ShooterPlant::GetWheelSpeed () {
+    Advance();
+    return m_WheelSpeed;
+}
+
+void ShooterPlant::OnShot () {
+    Advance();
+    m_WheelSpeed *= 1.0 - kShotSpeedLoss;
+}
+
+void ShooterPlant::Reset () {
+    Restart();
+
+    m_Setpoint = m_Integral = m_LastError = m_Output = 0;
+    m_WheelSpeed = 0;
+    m_TurretSetpoint = m_TurretVelocity = m_TurretPosition = 0;
+}
+
+void ShooterPlant::Step (double dt) {
+    // Spark MAX velocity loop, in motor rpm.  Stopped means coasting.
+    if (0 != m_Setpoint) {
+        double error = m_Setpoint - m_WheelSpeed * kMotorRpmPerWheelRpm;
+        m_Integral += error;
+        m_Output = m_Gains.f * m_Setpoint + m_Gains.p * error + m_Gains.i * m_Integral + m_Gains.d * (error - m_LastError);
+        m_Output = std::clamp(m_Output, -1.0, 1.0);
+        m_LastError = error;
+    } else {
+        m_Output = 0;
+        m_LastError = 0;
+    }
+
+    double voltage = m_Output * kBusVoltage;
+    double friction = 0 != m_WheelSpeed ? std::copysign(config.ks, m_WheelSpeed) : 0;
+    double next = m_WheelSpeed + (voltage - friction - config.kv * m_WheelSpeed) / config.ka * dt;
+
+    // Coasting to a stop, not through it.
+    if (0 == m_Output && std::signbit(next) != std::signbit(m_WheelSpeed)) {
+        next = 0;
+    }
+    m_WheelSpeed = next;
+
+    double turretTarget = m_TurretSetpoint * 10.0;
+    m_TurretVelocity += (turretTarget - m_TurretVelocity) * std::min(1.0, dt / kTurretLag);
+    m_TurretPosition += m_TurretVelocity * dt;
+}
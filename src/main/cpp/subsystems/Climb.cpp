@@ -1,18 +1,26 @@
 #include "subsystems/Climb.h"
 
+#include "instrumentation/AllocationTracking.h"
+#include "instrumentation/LoopTiming.h"
+
 #include <ctre/phoenix/motorcontrol/ControlMode.h>
-#include <frc/smartdashboard/SmartDashboard.h>
 
 #include <algorithm>
 
 #define MAX_WINCH_SPEED 1.0
 #define MIN_WINCH_SPEED 0.0
 
-Climb::Climb () {}
+// Nothing to do but report to the dashboard.
+#define kClimbPeriod 100_ms
+
+Climb::Climb () : MultiRateSubsystem(kClimbPeriod) {}
+
+void Climb::RatePeriodic () {
+    LOOP_TIMER("Climb.RatePeriodic");
+    NO_ALLOC_REGION("Climb.RatePeriodic");
 
-void Climb::Periodic () {
-    frc::SmartDashboard::PutBoolean("Winch Locked", m_IsWinchLocked);
-    frc::SmartDashboard::PutBoolean("Climb Piston Out", !m_IsPistonExtended);
+    m_Telemetry.winchLocked.Set(m_IsWinchLocked);
+    m_Telemetry.pistonOut.Set(!m_IsPistonExtended);
 }
 
 void Climb::PistonExtend () {
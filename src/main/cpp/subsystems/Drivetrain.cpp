@@ -1,11 +1,16 @@
 #include "subsystems/Drivetrain.h"
 
+#include "instrumentation/AllocationTracking.h"
+
 #include <iostream>
 #include <math.h>
 #include <algorithm>
+#include <frc/RobotBase.h>
 #include <frc/RobotController.h>
 
 #include "Robot.h"
+#include "util/RateScheduler.h"
+#include "util/Realtime.h"
 
 #define PI 3.14159265358979323846
 
@@ -15,43 +20,105 @@
 // half of the distance between the wheels in meters
 #define kHalfWheelBase 0.953125
 
-Drivetrain::Drivetrain (std::shared_ptr<cpptoml::table> toml) {
+// Control loop rate in Hz.  Slower and the corrections lag; faster and the
+// CAN bus can't keep up with the encoders anyway.
+#define kDefaultControlRate 200.0
+#define kMinControlRate 100.0
+#define kMaxControlRate 200.0
+
+Drivetrain::Drivetrain (std::shared_ptr<cpptoml::table> toml, DrivetrainIO* io) : io(io) {
     config.kinematics.ks = toml->get_qualified_as<double>("kinematics.ks").value_or(0.0);
     config.kinematics.kv = toml->get_qualified_as<double>("kinematics.kv").value_or(0.0);
     config.kinematics.ka = toml->get_qualified_as<double>("kinematics.ka").value_or(0.0);
     config.kinematics.kw = toml->get_qualified_as<double>("kinematics.kw").value_or(0.0);
 
-    static constexpr double metersPerMotorRotation = 0.04526269;
-
-    for (auto m : {&leftLeader, &leftFollower1, &leftFollower2, &rightLeader, &rightFollower1, &rightFollower2}) {
-        // Position in wheel angular displacement (rad)
-        m->GetEncoder().SetPositionConversionFactor(metersPerMotorRotation);
+    double rate = toml->get_qualified_as<double>("controlRate").value_or(kDefaultControlRate);
+    if (rate < kMinControlRate || rate > kMaxControlRate) {
+        std::cerr << "drivetrain: controlRate " << rate << " Hz is outside " << kMinControlRate << " to " << kMaxControlRate << " Hz, clamping" << std::endl;
+        rate = std::clamp(rate, kMinControlRate, kMaxControlRate);
+    }
+    config.controlPeriod = units::second_t{1.0 / rate};
 
-        // Velocity in wheel angular velocity (rad/s)
-        m->GetEncoder().SetVelocityConversionFactor(metersPerMotorRotation / 60);
+    ResetPose();
 
-        // Initial Position is 0
-        m->GetEncoder().SetPosition(0);
+    if (frc::RobotBase::IsReal()) {
+        notifier = std::make_unique<frc::Notifier>([this, first = true] () mutable {
+            if (first) {
+                Realtime::EnterThread(Realtime::Thread::kControl, "drivetrain control");
+                first = false;
+            }
+            ControlPeriodic();
+        });
+        notifier->StartPeriodic(config.controlPeriod);
+    } else {
+        RateScheduler::GetInstance().Schedule([this] { ControlPeriodic(); }, config.controlPeriod);
     }
+}
 
-    rightLeader.SetInverted(true);
-    rightFollower1.SetInverted(true);
-    rightFollower2.SetInverted(true);
+frc::Pose2d Drivetrain::GetPose () {
+    Status current = status.Read();
 
-    ResetPose();
+    // Until the loop has applied a reset, the pose is what it was reset to.
+    if (current.poseSequence != setpoint.poseSequence) {
+        return frc::Pose2d{units::meter_t{setpoint.poseX}, units::meter_t{setpoint.poseY}, frc::Rotation2d{units::radian_t{setpoint.poseAngle}}};
+    }
 
-    // Brake defaults to on
-    SetBrake(true);
+    return frc::Pose2d{units::meter_t{current.x}, units::meter_t{current.y}, frc::Rotation2d{units::radian_t{current.angle}}};
 }
 
-void Drivetrain::Periodic () {
+// Runs on the control loop.  LoopTiming isn't thread safe, so there's no
+// LOOP_TIMER here.
+void Drivetrain::ControlPeriodic () {
+    NO_ALLOC_REGION("Drivetrain.ControlPeriodic");
+
+    Setpoint target = setpoints.Read();
+
+    if (target.poseSequence != poseSequence) {
+        poseSequence = target.poseSequence;
+        io->ResetPosition();
+        odometry.ResetPosition(
+            frc::Pose2d{frc::Translation2d{units::meter_t{target.poseX}, units::meter_t{target.poseY}}, frc::Rotation2d{units::radian_t{target.poseAngle}}},
+            frc::Rotation2d{-io->GetGyroAngle()}
+        );
+    }
+
     UpdateOdometry();
 
-    if (frc::RobotController::IsSysActive() && !brakeOn && !oldDriving) {
-        UpdateVoltages();
-    } else if (!brakeOn && !oldDriving) {
-        SetBrake(true);
+    // Disabling stops closed loop driving until a command sets a new target.
+    if (!target.brakeOn && !target.oldDriving && !frc::RobotController::IsSysActive()) {
+        stoppedSequence = target.sequence;
     }
+    bool stopped = target.brakeOn || target.sequence == stoppedSequence;
+
+    ApplyBrake(stopped);
+
+    if (!stopped) {
+        if (target.oldDriving) {
+            io->Set(target.left, target.right);
+        } else {
+            UpdateVoltages(target);
+        }
+    }
+
+    auto pose = odometry.GetPose();
+
+    Status measured;
+    measured.x = pose.X().to<double>();
+    measured.y = pose.Y().to<double>();
+    measured.angle = pose.Rotation().Radians().to<double>();
+    measured.speed = (io->GetLeftVelocity() + io->GetRightVelocity()) / 2.0;
+    measured.voltageUsedWithoutAcceleration = voltageUsedWithoutAcceleration;
+    measured.poseSequence = poseSequence;
+    status.Write(measured);
+}
+
+void Drivetrain::ApplyBrake (bool on) {
+    if (on == brakeApplied) return;
+
+    brakeApplied = on;
+
+    io->SetBrake(on);
+    io->Set(0, 0);
 }
 
 // Calculate radius from x stick, and drive
@@ -109,61 +176,53 @@ void Drivetrain::RadiusDrive (double speed, double radius) {
     rightWheelSpeed *= speed;
 
     // Write to motors
-    leftGroup.Set(leftWheelSpeed);
-    rightGroup.Set(rightWheelSpeed);
+    setpoint.left = leftWheelSpeed;
+    setpoint.right = rightWheelSpeed;
+    Send();
 }
 
 void Drivetrain::SetBrake (bool on) {
-    if (on == brakeOn) return;
-
-    brakeOn = on;
+    if (on == setpoint.brakeOn) return;
 
-    auto mode = on ? rev::CANSparkMax::IdleMode::kBrake : rev::CANSparkMax::IdleMode::kCoast;
-
-    leftLeader.SetIdleMode(mode);
-    leftFollower1.SetIdleMode(mode);
-    leftFollower2.SetIdleMode(mode);
-    rightLeader.SetIdleMode(mode);
-    rightFollower1.SetIdleMode(mode);
-    rightFollower2.SetIdleMode(mode);
-
-    leftGroup.Set(0);
-    rightGroup.Set(0);
+    setpoint.brakeOn = on;
+    setpoint.left = 0;
+    setpoint.right = 0;
+    Send();
 }
 
+// The control loop does the reset, so the encoders and odometry are reset
+// together.
 void Drivetrain::SetPose (double x, double y, double angle) {
-    leftLeader.GetEncoder().SetPosition(0);
-    rightLeader.GetEncoder().SetPosition(0);
-    odometry.ResetPosition(
-        frc::Pose2d{frc::Translation2d{units::length::meter_t{x}, units::length::meter_t{y}}, frc::Rotation2d{units::radian_t{angle}}},
-        frc::Rotation2d{units::degree_t{-gyro.GetAngle()}}
-    );
+    setpoint.poseSequence++;
+    setpoint.poseX = x;
+    setpoint.poseY = y;
+    setpoint.poseAngle = angle;
+    Send();
 }
 
 void Drivetrain::UpdateOdometry () {
     odometry.Update(
-        frc::Rotation2d{units::degree_t{-gyro.GetAngle()}},
-        units::meter_t{leftLeader.GetEncoder().GetPosition()},
-        units::meter_t{rightLeader.GetEncoder().GetPosition()}
+        frc::Rotation2d{-io->GetGyroAngle()},
+        units::meter_t{io->GetLeftPosition()},
+        units::meter_t{io->GetRightPosition()}
     );
 
     // auto pose = odometry.GetPose();
     // std::cout << ", " << pose.Translation().X().to<double>() << ", " << pose.Translation().Y().to<double>() << ", " << pose.Rotation().Degrees().to<double>();
 }
 
-void Drivetrain::UpdateVoltages () {
-    double linearVoltage = GetLinearVoltage();
-    double rotationalVoltage = GetRotationalVoltage();
+void Drivetrain::UpdateVoltages (const Setpoint &target) {
+    double speed = (io->GetLeftVelocity() + io->GetRightVelocity()) / 2.0;
+    double linearVoltage = GetLinearVoltage(target, speed);
+    double rotationalVoltage = GetRotationalVoltage(target);
 
-    voltageUsedWithoutAcceleration = std::fabs(linearVoltage) + std::fabs(rotationalVoltage) - config.kinematics.ka*acceleration;
+    voltageUsedWithoutAcceleration = std::fabs(linearVoltage) + std::fabs(rotationalVoltage) - config.kinematics.ka*target.acceleration;
 
-    leftGroup.Set((linearVoltage-rotationalVoltage) / leftLeader.GetBusVoltage());
-    rightGroup.Set((linearVoltage+rotationalVoltage) / rightLeader.GetBusVoltage());
+    io->Set((linearVoltage-rotationalVoltage) / io->GetLeftBusVoltage(), (linearVoltage+rotationalVoltage) / io->GetRightBusVoltage());
 }
 
-double Drivetrain::GetLinearVoltage () {
-    double speed = GetSpeed();
-    double a = acceleration + GetAccelerationCorrection(speed);
+double Drivetrain::GetLinearVoltage (const Setpoint &target, double speed) {
+    double a = target.acceleration + GetAccelerationCorrection(target, speed);
     double s = std::fabs(speed) > 0.02 ? std::copysign(config.kinematics.ks, speed) : (std::fabs(a) > 0.05 ? std::copysign(config.kinematics.ks, a) : 0);
     double voltage = s + config.kinematics.kv*speed + config.kinematics.ka*a;
 
@@ -172,8 +231,8 @@ double Drivetrain::GetLinearVoltage () {
     return voltage;
 }
 
-double Drivetrain::GetRotationalVoltage () {
-    double w = angularVelocity + GetRotationalCorrection();
+double Drivetrain::GetRotationalVoltage (const Setpoint &target) {
+    double w = target.angularVelocity + GetRotationalCorrection(target);
     double voltage = config.kinematics.kw*w;
     // std::cout << ", " << w/90.0 << ", " << GetGyroAngle()/90.0;
     return voltage;
@@ -184,13 +243,13 @@ double Drivetrain::GetRotationalVoltage () {
 #define kACorrection 3.0
 #define aCorrectionMax 0.7
 
-double Drivetrain::GetAccelerationCorrection (double speed) {
-    double correction = kVCorrection * (targetSpeed - speed);
+double Drivetrain::GetAccelerationCorrection (const Setpoint &target, double speed) {
+    double correction = kVCorrection * (target.targetSpeed - speed);
     return std::clamp(correction, -vCorrectionMax, vCorrectionMax);
 }
 
-double Drivetrain::GetRotationalCorrection () {
+double Drivetrain::GetRotationalCorrection (const Setpoint &target) {
     double angle = odometry.GetPose().Rotation().Radians().to<double>();
-    double correction = kACorrection * (targetAngle - angle);
+    double correction = kACorrection * (target.targetAngle - angle);
     return std::clamp(correction, -aCorrectionMax, aCorrectionMax);
 }
@@ -0,0 +1,49 @@
+#include "subsystems/DrivetrainHardware.h"
+
+DrivetrainHardware::DrivetrainHardware () {
+    static constexpr double metersPerMotorRotation = 0.04526269;
+
+    for (auto m : {&leftLeader, &leftFollower1, &leftFollower2, &rightLeader, &rightFollower1, &rightFollower2}) {
+        // Position in wheel angular displacement (rad)
+        m->GetEncoder().SetPositionConversionFactor(metersPerMotorRotation);
+
+        // Velocity in wheel angular velocity (rad/s)
+        m->GetEncoder().SetVelocityConversionFactor(metersPerMotorRotation / 60);
+
+        // Initial Position is 0
+        m->GetEncoder().SetPosition(0);
+    }
+
+    rightLeader.SetInverted(true);
+    rightFollower1.SetInverted(true);
+    rightFollower2.SetInverted(true);
+}
+
+void DrivetrainHardware::Set (double left, double right) {
+    leftGroup.Set(left);
+    rightGroup.Set(right);
+}
+
+void DrivetrainHardware::SetBrake (bool on) {
+    auto mode = on ? rev::CANSparkMax::IdleMode::kBrake : rev::CANSparkMax::IdleMode::kCoast;
+
+    leftLeader.SetIdleMode(mode);
+    leftFollower1.SetIdleMode(mode);
+    leftFollower2.SetIdleMode(mode);
+    rightLeader.SetIdleMode(mode);
+    rightFollower1.SetIdleMode(mode);
+    rightFollower2.SetIdleMode(mode);
+}
+
+void DrivetrainHardware::ResetPosition () {
+    leftLeader.GetEncoder().SetPosition(0);
+    rightLeader.GetEncoder().SetPosition(0);
+}
+
+units::degree_t DrivetrainHardware::GetGyroAngle () {
+#ifdef __FRC_ROBORIO__
+    return units::degree_t{gyro.GetAngle()};
+#else
+    return 0_deg;
+#endif
+}
@@ -13,10 +13,12 @@ Intake::Intake (std::shared_ptr<cpptoml::table> toml) {
 void Intake::Periodic () {}
 
 void Intake::SetIntakeSpeed (double intakeSpeed) {
+    m_IntakeSpeed = intakeSpeed;
     m_IntakeMotor.Set(ctre::phoenix::motorcontrol::ControlMode::PercentOutput, intakeSpeed);
 }
 
 void Intake::SetConveyorSpeed (double conveyorSpeed) {
+    m_ConveyorSpeed = conveyorSpeed;
     m_ConveyorMotor.Set(ctre::phoenix::motorcontrol::ControlMode::PercentOutput, conveyorSpeed);
 }
 
@@ -81,5 +83,6 @@ bool Intake::IsPowerCellInFeeder() {
 }
 
 void Intake::SetFeederSpeed (double percentSpeed) {
+    m_FeederSpeed = percentSpeed;
     m_FeederMotor.Set(ctre::phoenix::motorcontrol::ControlMode::PercentOutput, -percentSpeed);
 }
@@ -0,0 +1,7 @@
+#include "subsystems/MultiRateSubsystem.h"
+
+#include "util/RateScheduler.h"
+
+MultiRateSubsystem::MultiRateSubsystem (units::second_t period) : m_Period(period) {
+    RateScheduler::GetInstance().Schedule([this] { RatePeriodic(); }, period);
+}
@@ -14,6 +14,12 @@ void Pixycam::Periodic () {}
 
 std::vector<PixyBlock> Pixycam::GetBlocks() {
     std::vector<PixyBlock> blockVector;
+    GetBlocks(blockVector);
+    return blockVector;
+}
+
+void Pixycam::GetBlocks(std::vector<PixyBlock> &blockVector) {
+    blockVector.clear();
 
     uint8_t getBlocksRequest[] = {
         0xae,
@@ -31,12 +37,12 @@ std::vector<PixyBlock> Pixycam::GetBlocks() {
 
     if (!WaitForSync()) {
         std::cerr << "pixycam: error response sync no found" << std::endl;
-        return blockVector;
+        return;
     }
 
     if (4 != m_Spi.Read(false, &recv[0], 4)) {
         std::cerr << "pixycam: error reading header" << std::endl;
-        return blockVector;
+        return;
     }
 
     uint8_t data_size = recv[1];
@@ -44,14 +50,12 @@ std::vector<PixyBlock> Pixycam::GetBlocks() {
 
     if (data_size != m_Spi.Read(false, &recv[4], data_size)) {
         std::cerr << "pixycam: error reading data" << std::endl;
-        return blockVector;
+        return;
     }
 
     for (int a = 0, b = 4; a < blocks_count; a++, b += 14) {
         blockVector.push_back(PixyBlock(&recv[b]));
     }
-
-    return blockVector;
 }
 
 bool Pixycam::WaitForSync() {
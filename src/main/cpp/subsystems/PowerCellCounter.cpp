@@ -1,33 +1,72 @@
 #include "subsystems/PowerCellCounter.h"
 
-#include <frc/smartdashboard/SmartDashboard.h>
+#include "instrumentation/AllocationTracking.h"
+#include "instrumentation/LoopTiming.h"
+#include "util/RateScheduler.h"
 
-#include <networktables/NetworkTableEntry.h>
-#include <networktables/NetworkTableInstance.h>
+#include <iostream>
 
-constexpr std::chrono::milliseconds debounceDelay(200);
+#include <frc/RobotBase.h>
 
-PowerCellCounter::PowerCellCounter () {
+#include "util/Realtime.h"
+
+// Edges closer than this to the last counted edge are the beam bouncing, not
+// a new cell.  Cells are one diameter apart at best, which takes longer than
+// this to pass the beam even at full intake speed.
+constexpr std::chrono::milliseconds debounceDelay(50);
+
+#define kDashboardPeriod 100_ms
+
+PowerCellCounter::PowerCellCounter (Intake* intake, std::shared_ptr<cpptoml::table> toml) {
     using WaitResult = frc::InterruptableSensorBase::WaitResult;
 
+    m_Intake = intake;
+
+    ConveyorModel::Configuration modelConfig;
+    modelConfig.feederPosition    = toml->get_qualified_as<double>("feederPosition").value_or(0.0);
+    modelConfig.exitPosition      = toml->get_qualified_as<double>("exitPosition").value_or(0.0);
+    modelConfig.cellDiameter      = toml->get_qualified_as<double>("cellDiameter").value_or(0.178);
+    modelConfig.conveyorCellSpeed = toml->get_qualified_as<double>("cellSpeed.conveyor").value_or(0.0);
+    modelConfig.feederCellSpeed   = toml->get_qualified_as<double>("cellSpeed.feeder").value_or(0.0);
+
+    m_Model = new ConveyorModel(modelConfig);
+    m_Model->Reset(m_Count);
+
     InitNetworkTables();
 
-    m_PowerCellInTimestamp = hal::fpga_clock::now();
-    m_PowerCellOutTimestamp = hal::fpga_clock::now();
-    
-    // Update counter when triggered
+    RateScheduler::GetInstance().Schedule([=] { DashboardPeriodic(); }, kDashboardPeriod);
+
+    m_PowerCellInTimestamp = hal::fpga_clock::now() - debounceDelay;
+    m_PowerCellOutTimestamp = hal::fpga_clock::now() - debounceDelay;
+
+    // The simulated beams change once a loop, on the stepped clock.  Polling
+    // them sees each edge in that loop, where the interrupt threads would
+    // race the next Periodic and make runs differ.
+    if (frc::RobotBase::IsSimulation()) {
+        m_PollBeams = true;
+        return;
+    }
+
+    // Queue every edge, so cells close together are not lost.  Each handler
+    // has its own thread, raised after its first edge is queued.
     m_PowerCellIn.RequestInterrupts(
-        [=](WaitResult res) {
-            if (WaitResult::kRisingEdge == res) {
-                m_PowerCellInTimestamp = hal::fpga_clock::now();
-                m_PowerCellInActive = true;
+        [=, first = true](WaitResult res) mutable {
+            if (WaitResult::kRisingEdge == res && !m_PowerCellInEdges.Push(hal::fpga_clock::now())) {
+                m_DroppedEdges++;
+            }
+            if (first) {
+                Realtime::EnterThread(Realtime::Thread::kAcquisition, "power cell in");
+                first = false;
             }
         });
     m_PowerCellOut.RequestInterrupts(
-        [=](WaitResult res) {
-            if (WaitResult::kRisingEdge == res) {
-                m_PowerCellOutTimestamp = hal::fpga_clock::now();
-                m_PowerCellOutActive = true;
+        [=, first = true](WaitResult res) mutable {
+            if (WaitResult::kRisingEdge == res && !m_PowerCellOutEdges.Push(hal::fpga_clock::now())) {
+                m_DroppedEdges++;
+            }
+            if (first) {
+                Realtime::EnterThread(Realtime::Thread::kAcquisition, "power cell out");
+                first = false;
             }
         });
 
@@ -46,42 +85,106 @@ int PowerCellCounter::GetCount () {
 
 void PowerCellCounter::SetCount (int count) {
     m_Count = count;
+    m_CountChanged = true;
+}
+
+bool PowerCellCounter::IsCellStaged () {
+    return m_Model->IsCellStaged();
+}
+
+bool PowerCellCounter::IsHopperEmpty () {
+    return m_Model->IsEmpty();
+}
+
+double PowerCellCounter::GetTimeUntilStaged () {
+    return m_Model->GetTimeUntilStaged(m_Intake->GetConveyorSpeed());
 }
 
 void PowerCellCounter::Periodic () {
-    auto now = hal::fpga_clock::now();
-
-    if (m_PowerCellInActive) {
-        auto diff = now - m_PowerCellInTimestamp;
-        auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(diff);
-        if (debounceDelay <= millis) {
-            m_Count++;
-            m_PowerCellInActive = false;
-        }
+    LOOP_TIMER("PowerCellCounter.Periodic");
+    NO_ALLOC_REGION("PowerCellCounter.Periodic");
+
+    if (m_PollBeams) PollBeams();
+
+    int cellsIn = CountEdges(m_PowerCellInEdges, m_PowerCellInTimestamp);
+    int cellsOut = CountEdges(m_PowerCellOutEdges, m_PowerCellOutTimestamp);
+
+    m_Count += cellsIn - cellsOut;
+
+    ModelPeriodic(cellsIn, cellsOut);
+
+    int dropped = m_DroppedEdges.exchange(0);
+    if (0 < dropped) {
+        std::cerr << "power cell counter: dropped " << dropped << " beam edges" << std::endl;
     }
+}
+
+void PowerCellCounter::DashboardPeriodic () {
+    m_Telemetry.cellCount.Set(m_Count);
+}
+
+void PowerCellCounter::PollBeams () {
+    hal::fpga_clock::time_point now = hal::fpga_clock::now();
+
+    bool in = m_PowerCellIn.Get();
+    if (in && !m_PowerCellInBroken && !m_PowerCellInEdges.Push(now)) {
+        m_DroppedEdges++;
+    }
+    m_PowerCellInBroken = in;
+
+    bool out = m_PowerCellOut.Get();
+    if (out && !m_PowerCellOutBroken && !m_PowerCellOutEdges.Push(now)) {
+        m_DroppedEdges++;
+    }
+    m_PowerCellOutBroken = out;
+}
 
-    if (m_PowerCellOutActive) {
-        auto diff = now - m_PowerCellOutTimestamp;
-        auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(diff);
-        if (debounceDelay <= millis) {
-            m_Count--;
-            m_PowerCellOutActive = false;
+int PowerCellCounter::CountEdges (EdgeQueue &edges, hal::fpga_clock::time_point &lastEdge) {
+    int count = 0;
+
+    hal::fpga_clock::time_point edge;
+    while (edges.Pop(edge)) {
+        if (debounceDelay <= edge - lastEdge) {
+            count++;
+            lastEdge = edge;
         }
     }
 
-    m_Table->GetEntry("cell count").SetDouble(m_Count);
+    return count;
 }
 
-void PowerCellCounter::InitNetworkTables () {
-    m_Table = nt::NetworkTableInstance::GetDefault().GetTable("SmartDashboard");
+void PowerCellCounter::ModelPeriodic (int cellsIn, int cellsOut) {
+    hal::fpga_clock::time_point now = hal::fpga_clock::now();
+    double dt = std::chrono::duration_cast<std::chrono::microseconds>(now - m_ModelTimestamp).count() / 1000000.0;
+    m_ModelTimestamp = now;
+
+    if (m_CountChanged.exchange(false)) {
+        m_Model->Reset(m_Count);
+    }
+
+    m_Model->Update(dt, m_Intake->GetConveyorSpeed(), m_Intake->GetFeederSpeed());
 
-    auto entryCellCount = m_Table->GetEntry("cell count");
+    for (int i = 0; i < cellsIn; i++) m_Model->OnIntakeEdge();
+    for (int i = 0; i < cellsOut; i++) m_Model->OnExitEdge();
+
+    // Feeder beam is polled.  Cells sit in it for far longer than a loop.
+    bool feederBeamBroken = m_Intake->IsPowerCellInFeeder();
+    if (feederBeamBroken && !m_FeederBeamBroken) {
+        m_Model->OnFeederEdge();
+    }
+    m_FeederBeamBroken = feederBeamBroken;
+}
+
+void PowerCellCounter::InitNetworkTables () {
+    auto entryCellCount = m_Telemetry.cellCount.GetEntry();
 
+    // Written straight away, not at the next flush, so the listener only
+    // hears about changes made on the dashboard.
     entryCellCount.SetDouble(m_Count);
     entryCellCount.AddListener(
         [=](auto event) {
-            if (event.value->IsDouble()) {
-                m_Count = (int)event.value->GetDouble();
+            if (event.value->IsDouble() && (int)event.value->GetDouble() != m_Count) {
+                SetCount((int)event.value->GetDouble());
             }
         },
         NT_NOTIFY_NEW | NT_NOTIFY_UPDATE
@@ -1,5 +1,8 @@
 #include "subsystems/Shooter.h"
 
+#include "instrumentation/AllocationTracking.h"
+#include "instrumentation/LoopTiming.h"
+
 #include <algorithm>
 #include <cmath>
 #include <iostream>
@@ -7,9 +10,8 @@
 #include <frc/smartdashboard/SmartDashboard.h>
 
 #include "Robot.h"
-
-#define SetPIDF(motor, vals) SetPIDFSlot(motor, vals.p, vals.i, vals.d, vals.f, 0)
-#define SetPIDFSlot(motor, P, I, D, F, slot) motor.SetP(P, slot); motor.SetI(I, slot); motor.SetD(D, slot); motor.SetFF(F, slot)
+#include "shooter/LeadCompensation.h"
+#include "util/RateScheduler.h"
 
 #define kShooterGearRatio (18.0 / 24.0)
 #define kShooterCorrectionFactor (2700.0 / 1500.0) // 2700 rpm encoder / 1500 rpm tachometer
@@ -19,7 +21,18 @@
 
 #define kMaxTurretVelocity 20_rpm
 
-Shooter::Shooter (std::shared_ptr<cpptoml::table> toml) {
+#define kTurretTicksPerRevolution (4096 * kTurretGearRatio)
+
+// Flywheel has to be going at least this fast before we feed the next one.
+#define kShooterReadyFraction 0.95
+
+// Setpoint changes smaller than this (lead compensation) don't restart timing
+// a spin-up.
+#define kSpinUpSetpointTolerance 100.0
+
+#define kDashboardPeriod 100_ms
+
+Shooter::Shooter (std::shared_ptr<cpptoml::table> toml, ShooterIO* io) : m_IO(io) {
     config.turretVelocity.p = toml->get_qualified_as<double>("turretVelocity.p").value_or(0.0);
     config.turretVelocity.i = toml->get_qualified_as<double>("turretVelocity.i").value_or(0.0);
     config.turretVelocity.d = toml->get_qualified_as<double>("turretVelocity.d").value_or(0.0);
@@ -28,6 +41,8 @@ Shooter::Shooter (std::shared_ptr<cpptoml::table> toml) {
     config.turretPosition.p = toml->get_qualified_as<double>("turretPosition.p").value_or(0.0);
     config.turretPosition.i = toml->get_qualified_as<double>("turretPosition.i").value_or(0.0);
     config.turretPosition.d = toml->get_qualified_as<double>("turretPosition.d").value_or(0.0);
+
+    config.turretStartAngle = toml->get_qualified_as<double>("turretStartAngle").value_or(180.0);
     
     config.shooterVelocity.p = toml->get_qualified_as<double>("shooterVelocity.p").value_or(0.0);
     config.shooterVelocity.i = toml->get_qualified_as<double>("shooterVelocity.i").value_or(0.0);
@@ -37,66 +52,91 @@ Shooter::Shooter (std::shared_ptr<cpptoml::table> toml) {
     config.shootingSpeed.near = units::angular_velocity::revolutions_per_minute_t{toml->get_qualified_as<double>("shootingSpeed.near").value_or(0.0)};
     config.shootingSpeed.far  = units::angular_velocity::revolutions_per_minute_t{toml->get_qualified_as<double>("shootingSpeed.far").value_or(0.0)};
 
-    // Setup shooter motors
-    SetPIDF(m_ShooterMotor1.GetPIDController(), config.shooterVelocity);
-    SetPIDF(m_ShooterMotor2.GetPIDController(), config.shooterVelocity);
+    config.vision.cameraHeight = toml->get_qualified_as<double>("vision.cameraHeight").value_or(0.0);
+    config.vision.cameraPitch  = toml->get_qualified_as<double>("vision.cameraPitch").value_or(0.0);
+    config.vision.targetHeight = toml->get_qualified_as<double>("vision.targetHeight").value_or(0.0);
 
-    m_ShooterMotor1.SetIdleMode(rev::CANSparkMax::IdleMode::kBrake);
-    m_ShooterMotor2.SetIdleMode(rev::CANSparkMax::IdleMode::kBrake);
+    config.lead.ballSpeed   = toml->get_qualified_as<double>("lead.ballSpeed").value_or(0.0);
+    config.lead.rpmPerMeter = toml->get_qualified_as<double>("lead.rpmPerMeter").value_or(0.0);
 
-    m_ShooterMotor1.SetInverted(false);
-    m_ShooterMotor2.Follow(m_ShooterMotor1, true);
+    config.flywheel.feedLeadTime = toml->get_qualified_as<double>("flywheel.feedLeadTime").value_or(0.0);
+
+    config.idleSpeed = units::angular_velocity::revolutions_per_minute_t{toml->get_qualified_as<double>("idleSpeed").value_or(0.0)};
+    config.autoSpeed = units::angular_velocity::revolutions_per_minute_t{toml->get_qualified_as<double>("autoSpeed").value_or(3750.0)};
+
+    FlywheelObserver::Configuration observerConfig;
+    observerConfig.ks          = toml->get_qualified_as<double>("flywheel.ks").value_or(0.0);
+    observerConfig.kv          = toml->get_qualified_as<double>("flywheel.kv").value_or(0.0);
+    observerConfig.ka          = toml->get_qualified_as<double>("flywheel.ka").value_or(1.0);
+    observerConfig.resistance  = toml->get_qualified_as<double>("flywheel.resistance").value_or(0.0);
+    observerConfig.motorKv     = toml->get_qualified_as<double>("flywheel.motorKv").value_or(0.0);
+    observerConfig.motorRatio  = 1.0 / kShooterGearRatio / kShooterCorrectionFactor;
+    observerConfig.emfGain     = toml->get_qualified_as<double>("flywheel.emfGain").value_or(0.0);
+    observerConfig.encoderGain = toml->get_qualified_as<double>("flywheel.encoderGain").value_or(1.0);
+    observerConfig.loadGain    = toml->get_qualified_as<double>("flywheel.loadGain").value_or(0.0);
+    observerConfig.encoderLag  = toml->get_qualified_as<double>("flywheel.encoderLag").value_or(0.0);
+    observerConfig.dipLoad     = toml->get_qualified_as<double>("flywheel.dipLoad").value_or(1.0e9);
+
+    m_FlywheelObserver = new FlywheelObserver(observerConfig);
+
+    // Setup shooter motors
+    m_IO->ConfigureFlywheel({config.shooterVelocity.p, config.shooterVelocity.i, config.shooterVelocity.d, config.shooterVelocity.f});
 
     // Setup vision NT
     m_VisionTable = nt::NetworkTableInstance::GetDefault().GetTable("limelight-gears");
 
     // Set up turret motor velocity PIDF
-    ctre::phoenix::motorcontrol::can::TalonSRXPIDSetConfiguration turretMotorPIDConfig {ctre::phoenix::motorcontrol::FeedbackDevice::CTRE_MagEncoder_Relative};
-    m_TurretMotor.ConfigurePID(turretMotorPIDConfig);
-    m_TurretMotor.SetInverted(true);
-    m_TurretMotor.SetNeutralMode(ctre::phoenix::motorcontrol::NeutralMode::Brake);
-    m_TurretMotor.ConfigSelectedFeedbackSensor(ctre::phoenix::motorcontrol::TalonSRXFeedbackDevice::CTRE_MagEncoder_Relative);
-    m_TurretMotor.SetSensorPhase(true);
-    m_TurretMotor.Config_kP(0, config.turretVelocity.p);
-    m_TurretMotor.Config_kI(0, config.turretVelocity.i);
-    m_TurretMotor.Config_kD(0, config.turretVelocity.d);
-    m_TurretMotor.Config_kF(0, config.turretVelocity.f);
+    m_IO->ConfigureTurret({config.turretVelocity.p, config.turretVelocity.i, config.turretVelocity.d, config.turretVelocity.f});
 
     // Set up turret motor position PID
     m_TurretPID = new frc2::PIDController(config.turretPosition.p, config.turretPosition.i, config.turretPosition.d);
 
-    frc::SmartDashboard::PutNumber("Shooter P", config.shooterVelocity.p);
-    frc::SmartDashboard::PutNumber("Shooter D", config.shooterVelocity.d);
-    frc::SmartDashboard::PutNumber("Shooter F", config.shooterVelocity.f);
+    m_Telemetry.shooterP.Set(config.shooterVelocity.p);
+    m_Telemetry.shooterD.Set(config.shooterVelocity.d);
+    m_Telemetry.shooterF.Set(config.shooterVelocity.f);
 
     // Light should start off
     SetLimelightLight(false);
+
+    RateScheduler::GetInstance().Schedule([=] { DashboardPeriodic(); }, kDashboardPeriod);
 }
 
 void Shooter::Periodic () {
-    // double factor = 1 / kShooterGearRatio;
-
-    frc::SmartDashboard::PutNumber("Shooter Motor 1", MeasureShooterMotorSpeed1());
-    frc::SmartDashboard::PutNumber("Shooter Motor 2", MeasureShooterMotorSpeed2());
-    
-    // frc::SmartDashboard::PutNumber("Turret Speed Read (RPM)", units::unit_cast<double>(m_TurretMotor.GetSelectedSensorVelocity() / kTurretGearRatio / kMotorRPMtoEncoderVelocity));
+    LOOP_TIMER("Shooter.Periodic");
+    NO_ALLOC_REGION("Shooter.Periodic");
 
     // config.shooterVelocity.p = frc::SmartDashboard::GetNumber("Shooter P", config.shooterVelocity.p);
     // config.shooterVelocity.d = frc::SmartDashboard::GetNumber("Shooter D", config.shooterVelocity.d);
     // config.shooterVelocity.f = frc::SmartDashboard::GetNumber("Shooter F", config.shooterVelocity.f);
 
-    // SetPIDF(m_ShooterMotor1.GetPIDController(), config.shooterVelocity);
-    // SetPIDF(m_ShooterMotor2.GetPIDController(), config.shooterVelocity);
+    // m_IO->ConfigureFlywheel({config.shooterVelocity.p, config.shooterVelocity.i, config.shooterVelocity.d, config.shooterVelocity.f});
 
+    ObserverPeriodic();
+    SpinUpPeriodic();
     TrackingPeriodic(m_TrackingMode);
 }
 
 void Shooter::SetShooterMotorSpeed (units::angular_velocity::revolutions_per_minute_t speed) {
+    double setpoint = units::unit_cast<double>(speed);
+
+    // Time spin-ups, but not small corrections or slowing down.
+    if (std::fabs(setpoint - m_SpinUp.target) > kSpinUpSetpointTolerance) {
+        m_SpinUp.target = 0.0;
+
+        double ready = kShooterReadyFraction * setpoint;
+        if (m_FlywheelObserver->GetSpeed() < ready) {
+            m_SpinUp.target = setpoint;
+            m_SpinUp.modelTime = m_FlywheelObserver->PredictRecoveryTime(ready, m_IO->GetFlywheelBusVoltage());
+            m_SpinUp.start = hal::fpga_clock::now();
+        }
+    }
+
     if (units::math::fabs(speed) > 50_rpm) {
         double motorSpeed = kShooterGearRatio * kShooterCorrectionFactor * units::unit_cast<double>(speed);
-        m_ShooterMotor1.GetPIDController().SetReference(motorSpeed, rev::kVelocity);
+        m_IO->SetFlywheelVelocity(motorSpeed);
     } else {
-        m_ShooterMotor1.Set(0);
+        m_IO->StopFlywheel();
+        m_FlywheelObserver->Reset(MeasureShooterMotorSpeed1());
     }
 }
 
@@ -104,11 +144,31 @@ units::angular_velocity::revolutions_per_minute_t Shooter::GetShooterMotorSpeed
     return units::angular_velocity::revolutions_per_minute_t(MeasureShooterMotorSpeed1());
 }
 
+units::angular_velocity::revolutions_per_minute_t Shooter::GetEstimatedShooterSpeed () {
+    return units::angular_velocity::revolutions_per_minute_t(m_FlywheelObserver->GetSpeed());
+}
+
+int Shooter::GetShotCount () {
+    return m_FlywheelObserver->GetShotCount();
+}
+
+bool Shooter::IsReadyToFeed (units::angular_velocity::revolutions_per_minute_t speed) {
+    return GetTimeUntilReady(speed) <= config.flywheel.feedLeadTime;
+}
+
+double Shooter::GetTimeUntilReady (units::angular_velocity::revolutions_per_minute_t speed) {
+    double target = units::unit_cast<double>(speed);
+    double modelTime = m_FlywheelObserver->PredictRecoveryTime(kShooterReadyFraction * target, m_IO->GetFlywheelBusVoltage());
+
+    return m_SpinUpModel.Predict(target, modelTime);
+}
+
 void Shooter::SetTrackingMode (TrackingMode mode) {
     m_TrackingMode = mode;
 
     if (mode == TrackingMode::Off) {
         SetTurretSpeed(0_rpm);
+        SetAimOffset(0_deg);
     }
     
     if (mode == TrackingMode::CameraTracking) {
@@ -119,12 +179,12 @@ void Shooter::SetTrackingMode (TrackingMode mode) {
 }
 
 void Shooter::SetTurretSpeed (units::angular_velocity::revolutions_per_minute_t speed) {
-    frc::SmartDashboard::PutNumber("Turret Speed Setpoint (RPM)", units::unit_cast<double>(speed));
+    m_Telemetry.turretSetpoint.Set(units::unit_cast<double>(speed));
     
     // std::cout << speed << " ";
     
     if (units::math::fabs(speed) < 1_deg_per_s) {
-        m_TurretMotor.Set(ctre::phoenix::motorcontrol::ControlMode::PercentOutput, 0);
+        m_IO->StopTurret();
         return;
     }
 
@@ -132,7 +192,7 @@ void Shooter::SetTurretSpeed (units::angular_velocity::revolutions_per_minute_t
     
     // std::cout << motorSpeed << std::endl;
 
-    m_TurretMotor.Set(ctre::phoenix::motorcontrol::ControlMode::Velocity, motorSpeed);
+    m_IO->SetTurretVelocity(motorSpeed);
 }
 
 void Shooter::SetTurretSpeed (double percentSpeed) {
@@ -157,22 +217,97 @@ int Shooter::GetTargetCount () {
     return m_TargetCount;
 }
 
+bool Shooter::HasTarget () {
+    // Read directly, since m_TargetCount only updates while camera tracking.
+    return 0 < m_VisionTable->GetNumber("tv", 0);
+}
+
 bool Shooter::IsOnTarget () {
-    return 0 < m_TargetCount && 0.5 > std::fabs(m_TargetErrorX);
+    return 0 < m_TargetCount && 0.5 > std::fabs(m_TargetErrorX + m_AimOffset);
+}
+
+units::length::meter_t Shooter::GetTargetDistance () {
+    // m_TargetErrorY is the negated limelight ty, so subtract it.
+    double angle = (config.vision.cameraPitch - m_TargetErrorY) * M_PI / 180.0;
+    double height = config.vision.targetHeight - config.vision.cameraHeight;
+
+    // Target at or below the horizon is nonsense, treat it as very far away.
+    if (angle <= 0.01) {
+        return units::length::meter_t{height / std::tan(0.01)};
+    }
+
+    return units::length::meter_t{height / std::tan(angle)};
+}
+
+units::angle::degree_t Shooter::GetTurretAngle () {
+    // Relative encoder, counting from where the turret pointed at power on.
+    return units::angle::degree_t{config.turretStartAngle + 360.0 * m_IO->GetTurretPosition() / kTurretTicksPerRevolution};
+}
+
+void Shooter::SetAimOffset (units::angle::degree_t offset) {
+    m_AimOffset = units::unit_cast<double>(offset);
+}
+
+units::angular_velocity::revolutions_per_minute_t Shooter::CompensateForMotion (units::angular_velocity::revolutions_per_minute_t speed, double robotSpeed) {
+    if (m_TargetCount <= 0 || config.lead.ballSpeed <= 0) {
+        SetAimOffset(0_deg);
+        return speed;
+    }
+
+    double range = units::unit_cast<double>(GetTargetDistance());
+
+    // Camera rides on the turret.  Both the turret angle and tx are clockwise
+    // positive; m_TargetErrorX is -tx.
+    double bearing = -units::unit_cast<double>(units::angle::radian_t{GetTurretAngle()}) + m_TargetErrorX * M_PI / 180.0;
+
+    Lead::Solution solution = Lead::solve(range, bearing, robotSpeed, config.lead.ballSpeed);
+
+    SetAimOffset(units::angle::radian_t{solution.aimOffset});
+
+    return speed + units::angular_velocity::revolutions_per_minute_t{config.lead.rpmPerMeter * (solution.effectiveRange - range)};
 }
 
 double Shooter::MeasureShooterMotorSpeed1 () {
-    return m_ShooterMotor1.GetEncoder().GetVelocity() / kShooterGearRatio / kShooterCorrectionFactor;
+    return m_IO->GetFlywheelVelocity() / kShooterGearRatio / kShooterCorrectionFactor;
 }
 
 double Shooter::MeasureShooterMotorSpeed2 () {
-    return m_ShooterMotor2.GetEncoder().GetVelocity() / kShooterGearRatio / kShooterCorrectionFactor;
+    return m_IO->GetFollowerVelocity() / kShooterGearRatio / kShooterCorrectionFactor;
 }
 
 void Shooter::SetLimelightLight (bool on) {
     m_VisionTable->PutNumber("ledMode", on ? 3 : 1);
 }
 
+void Shooter::DashboardPeriodic () {
+    LOOP_TIMER("Shooter.DashboardPeriodic");
+
+    m_Telemetry.motor1Speed.Set(MeasureShooterMotorSpeed1());
+    m_Telemetry.motor2Speed.Set(MeasureShooterMotorSpeed2());
+}
+
+void Shooter::ObserverPeriodic () {
+    hal::fpga_clock::time_point now = hal::fpga_clock::now();
+    double dt = std::chrono::duration_cast<std::chrono::microseconds>(now - m_ObserverTimestamp).count() / 1000000.0;
+    m_ObserverTimestamp = now;
+
+    double voltage = m_IO->GetFlywheelAppliedOutput() * m_IO->GetFlywheelBusVoltage();
+
+    m_FlywheelObserver->Update(dt, voltage, m_IO->GetFlywheelCurrent(), MeasureShooterMotorSpeed1());
+}
+
+void Shooter::SpinUpPeriodic () {
+    if (m_SpinUp.target <= 0.0) return;
+
+    if (m_FlywheelObserver->GetSpeed() >= kShooterReadyFraction * m_SpinUp.target) {
+        auto elapsed = hal::fpga_clock::now() - m_SpinUp.start;
+        double actualTime = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() / 1000000.0;
+
+        m_SpinUpModel.Learn(m_SpinUp.target, m_SpinUp.modelTime, actualTime);
+        m_SpinUp.target = 0.0;
+    }
+}
+
 void Shooter::TrackingPeriodic (TrackingMode mode) {
     if (mode == TrackingMode::CameraTracking) {
         double speed = 0;
@@ -181,29 +316,30 @@ void Shooter::TrackingPeriodic (TrackingMode mode) {
 
         if (m_TargetCount > 0) {
             // std::cout << "Count: " << m_TargetCount << std::endl;
-            frc::SmartDashboard::PutBoolean("Limelight Has Target", true);
+            m_Telemetry.hasTarget.Set(true);
 
             m_TargetErrorX = -m_VisionTable->GetNumber("tx", 0);
             m_TargetErrorY = -m_VisionTable->GetNumber("ty", 0);
             // std::cout << "m_TargetErrorX: " << m_TargetErrorX << std::endl;
             // std::cout << "m_TargetErrorY: " << m_TargetErrorY << std::endl;
 
-            frc::SmartDashboard::PutNumber("Turret Error X", m_TargetErrorX);
-            frc::SmartDashboard::PutNumber("Turret Error Y", m_TargetErrorY);
+            m_Telemetry.targetErrorX.Set(m_TargetErrorX);
+            m_Telemetry.targetErrorY.Set(m_TargetErrorY);
 
-            speed = m_TurretPID->Calculate(m_TargetErrorX);
+            speed = m_TurretPID->Calculate(m_TargetErrorX + m_AimOffset);
         } else if (m_TargetCount == 0) {
             // std::cout << "No objects detected" << std::endl;
-            frc::SmartDashboard::PutBoolean("Limelight Has Target", false);
+            m_Telemetry.hasTarget.Set(false);
         } else {
             // std::cout << "Variable tv does not exist in table limelight-gears" << std::endl;
-            frc::SmartDashboard::PutBoolean("Limelight Has Target", false);
+            m_Telemetry.hasTarget.Set(false);
         }
 
         SetTurretSpeed(speed);
     } else {
-        frc::SmartDashboard::PutBoolean("Limelight Has Target", false);
-        SetLimelightLight(false);
+        // SetTrackingMode turned the light off.  Leave it alone here, so a
+        // search for the target can turn it on without tracking.
+        m_Telemetry.hasTarget.Set(false);
         return;
     }
 }
@@ -0,0 +1,49 @@
+#include "subsystems/ShooterHardware.h"
+
+#define SetPIDF(motor, vals) SetPIDFSlot(motor, vals.p, vals.i, vals.d, vals.f, 0)
+#define SetPIDFSlot(motor, P, I, D, F, slot) motor.SetP(P, slot); motor.SetI(I, slot); motor.SetD(D, slot); motor.SetFF(F, slot)
+
+ShooterHardware::ShooterHardware () {
+    // Setup shooter motors
+    m_ShooterMotor1.SetIdleMode(rev::CANSparkMax::IdleMode::kBrake);
+    m_ShooterMotor2.SetIdleMode(rev::CANSparkMax::IdleMode::kBrake);
+
+    m_ShooterMotor1.SetInverted(false);
+    m_ShooterMotor2.Follow(m_ShooterMotor1, true);
+
+    // Set up turret motor velocity PIDF
+    ctre::phoenix::motorcontrol::can::TalonSRXPIDSetConfiguration turretMotorPIDConfig {ctre::phoenix::motorcontrol::FeedbackDevice::CTRE_MagEncoder_Relative};
+    m_TurretMotor.ConfigurePID(turretMotorPIDConfig);
+    m_TurretMotor.SetInverted(true);
+    m_TurretMotor.SetNeutralMode(ctre::phoenix::motorcontrol::NeutralMode::Brake);
+    m_TurretMotor.ConfigSelectedFeedbackSensor(ctre::phoenix::motorcontrol::TalonSRXFeedbackDevice::CTRE_MagEncoder_Relative);
+    m_TurretMotor.SetSensorPhase(true);
+}
+
+void ShooterHardware::ConfigureFlywheel (const Gains &gains) {
+    SetPIDF(m_ShooterMotor1.GetPIDController(), gains);
+    SetPIDF(m_ShooterMotor2.GetPIDController(), gains);
+}
+
+void ShooterHardware::ConfigureTurret (const Gains &gains) {
+    m_TurretMotor.Config_kP(0, gains.p);
+    m_TurretMotor.Config_kI(0, gains.i);
+    m_TurretMotor.Config_kD(0, gains.d);
+    m_TurretMotor.Config_kF(0, gains.f);
+}
+
+void ShooterHardware::SetFlywheelVelocity (double motorRpm) {
+    m_ShooterMotor1.GetPIDController().SetReference(motorRpm, rev::kVelocity);
+}
+
+void ShooterHardware::StopFlywheel () {
+    m_ShooterMotor1.Set(0);
+}
+
+void ShooterHardware::SetTurretVelocity (double ticksPer100ms) {
+    m_TurretMotor.Set(ctre::phoenix::motorcontrol::ControlMode::Velocity, ticksPer100ms);
+}
+
+void ShooterHardware::StopTurret () {
+    m_TurretMotor.Set(ctre::phoenix::motorcontrol::ControlMode::PercentOutput, 0);
+}
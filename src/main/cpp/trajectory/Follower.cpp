@@ -0,0 +1,8 @@
+#include "trajectory/Follower.h"
+
+std::optional<Follower::Kind> Follower::ParseKind (const std::string &name) {
+    if (name == "legacy") return Kind::kLegacy;
+    if (name == "ramsete") return Kind::kRamsete;
+    if (name == "purePursuit") return Kind::kPurePursuit;
+    return std::nullopt;
+}
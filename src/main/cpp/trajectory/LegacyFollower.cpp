@@ -0,0 +1,283 @@
+#include "trajectory/LegacyFollower.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <frc/RobotController.h>
+
+// How far (m) ahead of the last progress to look for the robot.  More than it
+// can drive in a loop, and less than the gap between passes where a path
+// crosses itself.
+#define kSearchAhead 1.0
+
+// Done within this far (m) of the end.
+#define kEndTolerance 0.05
+
+// Heading correction for cross-track error: atan(gain * error) radians.
+#define kCrossTrackGain 1.5
+
+LegacyFollower::LegacyFollower (Drivetrain *drivetrain, const FollowPolybezier::Path &path, const Trajectory &trajectory,
+    FollowPolybezier::Configuration configuration, bool backwards) :
+    drivetrain(drivetrain), config(configuration), backwards(backwards), polybezier(path), trajectory(trajectory)
+{}
+
+void LegacyFollower::Start (const frc::Pose2d &pose) {
+    curveStart.clear();
+    double start = 0;
+    size_t vertices = 0;
+    for (auto &curve : polybezier) {
+        curveStart.push_back(start);
+        start += curve.samples.back().d;
+        vertices += curve.samples.size();
+    }
+
+    // Lookahead never passes more vertices than the path has, so it won't
+    // grow while following.
+    lookahead.reserve(vertices);
+
+    currentBezier = 0;
+    progress = 0;
+    ResetCurveProgress();
+
+    velocity = 0;
+    acceleration = 0;
+    lastTime = frc::RobotController::GetFPGATime();
+}
+
+bool LegacyFollower::Update (const frc::Pose2d &pose, double time, Output &output) {
+    // Where the robot really is along the path, only looking ahead of where
+    // it was, so slip and drifting off the line don't build up.
+    // Not past the next cusp until the robot gets there, since the path
+    // comes back over itself after it.
+    double stop = trajectory.NextStop(progress);
+    PathIndex::Projection projection = trajectory.Project(pose.X().to<double>(), pose.Y().to<double>(), progress, std::min(progress + kSearchAhead, stop));
+    progress = projection.distance;
+
+    if (stop - progress < kEndTolerance) {
+        if (stop >= trajectory.GetLength()) {
+            return false;
+        }
+
+        // Stopped at a cusp.  Carry on the other way from rest, without
+        // the command stopping and starting again.
+        progress = stop;
+        velocity = 0;
+        acceleration = 0;
+        projection = trajectory.Project(pose.X().to<double>(), pose.Y().to<double>(), progress, progress);
+    }
+
+    // Curves meet at a cusp, so allow for rounding.
+    while (currentBezier + 1 < polybezier.size() && progress >= curveStart[currentBezier + 1] - 1e-6) {
+        currentBezier++;
+        ResetCurveProgress();
+    }
+
+    distanceTraveled = std::max(0.0, progress - curveStart[currentBezier]);
+
+    auto &vertices = polybezier[currentBezier].samples;
+    while (prevVertex + 1 < vertices.size() && distanceTraveled >= vertices[prevVertex+1].d) {
+        prevVertex++;
+        if (prevVertex + 1 >= vertices.size() && currentBezier + 1 >= polybezier.size()) { // past the last vertex
+            return false;
+        }
+    }
+    prevVertex = std::min<unsigned int>(prevVertex, vertices.size() - 2);
+
+    Trajectory::Sample setpoint = trajectory.AtDistance(progress);
+
+    double v = drivetrain->GetSpeed();
+    double w = v*setpoint.curvature; // get the angular velocity needed to drive in a circle of radius r at velocity v
+
+    // The tangent at the current point, turned back toward the path the
+    // further off it the robot is.  Backwards trajectories already face the
+    // other way, and cross-track error is to the side of the direction of
+    // travel, so this works either way.
+    double angle = setpoint.heading - std::atan(kCrossTrackGain * projection.crossTrack);
+
+    bool reversed = backwards != polybezier[currentBezier].backwards;
+    if (reversed) {
+        w *= -1;
+    }
+
+    auto accel = CalculateAcceleration();
+
+    if (reversed) {
+        output.acceleration = -accel.first;
+        output.targetSpeed = -accel.second;
+    } else {
+        output.acceleration = accel.first;
+        output.targetSpeed = accel.second;
+    }
+
+    output.angularVelocity = w;
+    output.targetAngle = angle;
+    output.reference = setpoint;
+
+    return true;
+}
+
+std::pair<double, double> LegacyFollower::CalculateAcceleration () {
+    // get time since last execution
+    uint64_t currentTime = frc::RobotController::GetFPGATime();
+    double dt = (currentTime - lastTime) / 1'000'000.0;
+    lastTime = currentTime;
+
+    // compute velocity change since last execution
+    velocity += acceleration * dt;
+
+    double cVelocity = velocity;
+    double cAcceleration = acceleration;
+    unsigned int cBezier = currentBezier;
+    unsigned int cVertex = prevVertex;
+
+    std::pair<double, std::pair<unsigned int, unsigned int>> leastMargin = {cVelocity+1, {0, 0}};
+
+    // Reuses the last call's storage, since this runs every loop.
+    std::vector<LookaheadPoint> &points = lookahead;
+    points.clear();
+
+    while (cVelocity > 0) {
+        cVertex++;
+        if (cVertex >= polybezier[cBezier].samples.size()) {
+            cVertex = 0;
+            cBezier++;
+            // The end, or a cusp, where it has to stop too.
+            if (cBezier >= polybezier.size() || polybezier[cBezier].backwards != polybezier[currentBezier].backwards) {
+                double endMargin = -cVelocity; // add 0.2 for bounce
+                if (-cVelocity < leastMargin.first) leastMargin = {endMargin, {cBezier-1, polybezier[cBezier-1].samples.size()-1}};
+                break;
+            }
+        }
+
+        auto *currentApproximation = &polybezier[cBezier].samples;
+
+        double distTraveled;
+        if (cVertex == 0) {
+            distTraveled = 0;
+        } else if (cBezier == currentBezier && cVertex == prevVertex+1) {
+            distTraveled = (*currentApproximation)[cVertex].d - distanceTraveled;
+        } else {
+            distTraveled = (*currentApproximation)[cVertex].d - (*currentApproximation)[cVertex-1].d;
+        }
+
+        // compute change in acceleration and velocity over distTraveled
+        double vSquared = cVelocity*cVelocity + 2*cAcceleration*distTraveled;
+        double newVelocity = vSquared > 0 ? std::sqrt(vSquared) : 0;
+        double dt = (newVelocity - cVelocity) / cAcceleration;
+        cAcceleration -= config.maximumJerk * dt;
+        cAcceleration = cAcceleration < -config.maximumReverseAcceleration ? -config.maximumReverseAcceleration : cAcceleration;
+        cVelocity = newVelocity;
+
+        points.push_back({{cBezier, cVertex}, distTraveled, cVelocity, cAcceleration});
+
+        double margin = polybezier[cBezier].samples[cVertex].maxV - cVelocity;
+        if (margin < leastMargin.first) leastMargin = {margin, {cBezier, cVertex}};
+    }
+
+    // limit based on point past min
+    if (leastMargin.second.first > nextMin.first || (leastMargin.second.first == nextMin.first && leastMargin.second.second > nextMin.second)) {
+        // act like normal
+    } else {
+        // calculate margin for min:
+        // get min distance
+        auto minPoint = polybezier[nextMin.first].samples[nextMin.second];
+        double mDistance = minPoint.d; // add distance from beginning of bezier with nextMin to nextMin
+        mDistance -= polybezier[cBezier].samples[cVertex].d; // remove distance from beginning of current bezier to current point
+
+        if (cBezier < nextMin.first) { // if nextMin is in a later bezier curve
+            int nB = cBezier-1;
+            while (++nB < nextMin.first) {
+                mDistance += polybezier[nB].samples.back().d;
+            }
+        }
+
+        // find d
+        double v = velocity;
+        double q1 = (1.0/3.0)/(config.maximumJerk*config.maximumJerk) * acceleration*acceleration;
+        double q2 = (1.0/config.maximumJerk)*v;
+        double d = (q1-q2) * acceleration;
+
+        // check if we need to start reducing acceleration
+        if (mDistance < d + 0.05 && acceleration < 0) {
+            // bring acceleration to 0
+            leastMargin.first = 0.2; // override margin
+        } else {
+            // calculate margin and adjust leastMargin appropriately
+            double tD = 0;
+            int index = -2;
+            for (int i = 0; i < points.size(); i++) {
+                tD += std::get<1>(points[i]);
+                double v = std::get<2>(points[i]);
+                double a = std::get<3>(points[i]);
+
+                double q1 = (1.0/3.0)/(config.maximumJerk*config.maximumJerk) * a*a;
+                double q2 = (1.0/config.maximumJerk)*v;
+                double d = (q1-q2) * a;
+
+                if (mDistance - tD < d) {
+                    index = i-1;
+                    break;
+                }
+            }
+            if (index > -2) { 
+                if (index == -1) index = 0;
+                double v = std::get<2>(points[index]);
+                double a = std::get<3>(points[index]);
+                double t = -a/config.maximumJerk;
+                double dv = (a + t*config.maximumJerk/2)*t;
+                v += dv;
+                double margin = minPoint.maxV - v;
+                if (margin < leastMargin.first) leastMargin.first = margin;
+            }
+        }
+    }
+
+    // set acceleration
+    if (leastMargin.first < 0.05) {
+        acceleration -= config.maximumJerk*dt;
+    } else if (leastMargin.first < 0.1) {
+        // do nothing
+    } else {
+        acceleration += config.maximumJerk*dt;
+    }
+
+    acceleration = std::clamp(acceleration, -config.maximumReverseAcceleration, std::min(drivetrain->GetMaxAvailableAcceleration(), 1.0));
+
+    double targetVelocity = velocity + 0.5*acceleration*dt;
+
+    return {acceleration, targetVelocity};
+}
+
+void LegacyFollower::SetNextMin () {
+    unsigned int cBezier = currentBezier;
+    unsigned int cVertex = prevVertex;
+
+    while (true) {
+        if (cVertex >= polybezier[cBezier].samples.size()) {
+            cVertex = 0;
+            cBezier++;
+            if (cBezier >= polybezier.size()) {
+                nextMin = {cBezier,cVertex};
+                break;
+            }
+            // A cusp, where planning stops for now.
+            if (polybezier[cBezier].backwards != polybezier[currentBezier].backwards) {
+                nextMin = {cBezier-1, polybezier[cBezier-1].samples.size()-1};
+                break;
+            }
+        }
+        if (polybezier[cBezier].samples[cVertex].minimum) {
+            nextMin = {cBezier,cVertex};
+            break;
+        }
+        cVertex++;
+    }
+}
+
+void LegacyFollower::ResetCurveProgress () {
+    // reset the variables that track progress along the curve
+    prevVertex = 0;
+    distanceTraveled = 0;
+
+    SetNextMin();
+}
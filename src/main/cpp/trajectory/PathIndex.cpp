@@ -0,0 +1,142 @@
+#include "trajectory/PathIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+PathIndex::PathIndex (const std::vector<double> &xs, const std::vector<double> &ys, const std::vector<double> &distances) :
+    m_X(xs), m_Y(ys), m_Distance(distances)
+{
+    if (IsEmpty()) return;
+
+    auto [minimumX, maximumX] = std::minmax_element(m_X.begin(), m_X.end());
+    auto [minimumY, maximumY] = std::minmax_element(m_Y.begin(), m_Y.end());
+
+    m_MinimumX = *minimumX;
+    m_MinimumY = *minimumY;
+    m_Columns = (int)((*maximumX - m_MinimumX) / kCellSize) + 1;
+    m_Rows = (int)((*maximumY - m_MinimumY) / kCellSize) + 1;
+
+    // Calls back for every cell segment i's bounding box touches.
+    auto forEachCell = [&](std::size_t i, auto &&visit) {
+        int firstColumn = (int)((std::min(m_X[i], m_X[i+1]) - m_MinimumX) / kCellSize);
+        int lastColumn = (int)((std::max(m_X[i], m_X[i+1]) - m_MinimumX) / kCellSize);
+        int firstRow = (int)((std::min(m_Y[i], m_Y[i+1]) - m_MinimumY) / kCellSize);
+        int lastRow = (int)((std::max(m_Y[i], m_Y[i+1]) - m_MinimumY) / kCellSize);
+
+        for (int row = firstRow; row <= lastRow; row++) {
+            for (int column = firstColumn; column <= lastColumn; column++) {
+                visit(row * m_Columns + column);
+            }
+        }
+    };
+
+    // Counted first, so every cell's list goes in one array.
+    std::size_t segments = m_X.size() - 1;
+    m_CellStart.assign(m_Columns * m_Rows + 1, 0);
+    for (std::size_t i = 0; i < segments; i++) {
+        forEachCell(i, [&](int cell) { m_CellStart[cell + 1]++; });
+    }
+    for (std::size_t cell = 1; cell < m_CellStart.size(); cell++) {
+        m_CellStart[cell] += m_CellStart[cell - 1];
+    }
+
+    m_CellSegments.resize(m_CellStart.back());
+    std::vector<uint32_t> filled(m_CellStart.begin(), m_CellStart.end() - 1);
+    for (std::size_t i = 0; i < segments; i++) {
+        forEachCell(i, [&](int cell) { m_CellSegments[filled[cell]++] = i; });
+    }
+}
+
+double PathIndex::ProjectOnto (std::size_t i, double x, double y, double from, double to, Projection &projection) const {
+    double dx = m_X[i+1] - m_X[i];
+    double dy = m_Y[i+1] - m_Y[i];
+    double length = std::hypot(dx, dy);
+    double span = m_Distance[i+1] - m_Distance[i];
+
+    double t = length > 0 ? std::clamp(((x - m_X[i])*dx + (y - m_Y[i])*dy) / (length*length), 0.0, 1.0) : 0;
+    double distance = std::clamp(m_Distance[i] + t*span, from, to);
+    t = span > 0 ? std::clamp((distance - m_Distance[i]) / span, 0.0, 1.0) : 0;
+
+    projection.distance = distance;
+    projection.x = m_X[i] + t*dx;
+    projection.y = m_Y[i] + t*dy;
+    projection.crossTrack = length > 0 ? (dx*(y - m_Y[i]) - dy*(x - m_X[i])) / length : 0;
+
+    double ex = x - projection.x;
+    double ey = y - projection.y;
+    return ex*ex + ey*ey;
+}
+
+PathIndex::Projection PathIndex::Scan (double x, double y, double from, double to) const {
+    Projection best {}, candidate;
+    double bestSquared = std::numeric_limits<double>::infinity();
+
+    // The segment ending at or after from.
+    std::size_t first = std::lower_bound(m_Distance.begin(), m_Distance.end(), from) - m_Distance.begin();
+    first = first > 0 ? first - 1 : 0;
+
+    for (std::size_t i = first; i + 1 < m_X.size() && m_Distance[i] <= to; i++) {
+        double squared = ProjectOnto(i, x, y, from, to, candidate);
+        if (squared < bestSquared) {
+            bestSquared = squared;
+            best = candidate;
+        }
+    }
+
+    return best;
+}
+
+PathIndex::Projection PathIndex::Project (double x, double y, double from, double to) const {
+    if (IsEmpty()) return Projection{};
+
+    to = std::clamp(to, 0.0, m_Distance.back());
+    from = std::clamp(from, 0.0, to);
+
+    int column = (int)std::floor((x - m_MinimumX) / kCellSize);
+    int row = (int)std::floor((y - m_MinimumY) / kCellSize);
+    if (column < 0 || column >= m_Columns || row < 0 || row >= m_Rows) {
+        return Scan(x, y, from, to);
+    }
+
+    Projection best {}, candidate;
+    double bestSquared = std::numeric_limits<double>::infinity();
+
+    auto search = [&](int c, int r) {
+        if (c < 0 || c >= m_Columns || r < 0 || r >= m_Rows) return;
+
+        int cell = r * m_Columns + c;
+        for (uint32_t k = m_CellStart[cell]; k < m_CellStart[cell + 1]; k++) {
+            uint32_t i = m_CellSegments[k];
+            if (m_Distance[i+1] < from || m_Distance[i] > to) continue;
+
+            double squared = ProjectOnto(i, x, y, from, to, candidate);
+            if (squared < bestSquared) {
+                bestSquared = squared;
+                best = candidate;
+            }
+        }
+    };
+
+    // Everything outside ring r is at least r cells away.
+    int rings = std::max(m_Columns, m_Rows);
+    for (int ring = 0; ring <= rings; ring++) {
+        if (ring == 0) {
+            search(column, row);
+        } else {
+            for (int d = -ring; d <= ring; d++) {
+                search(column + d, row - ring);
+                search(column + d, row + ring);
+            }
+            for (int d = -ring + 1; d < ring; d++) {
+                search(column - ring, row + d);
+                search(column + ring, row + d);
+            }
+        }
+
+        double reach = ring * kCellSize;
+        if (bestSquared <= reach*reach) return best;
+    }
+
+    return std::isinf(bestSquared) ? Scan(x, y, from, to) : best;
+}
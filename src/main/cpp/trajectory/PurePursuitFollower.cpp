@@ -0,0 +1,85 @@
+#include "trajectory/PurePursuitFollower.h"
+
+#include <algorithm>
+#include <cmath>
+
+constexpr double PI = 3.1415926535897932;
+
+// Speed (m/s) to creep at where the profile starts from rest, or the robot
+// would never move off the first point, or out of a cusp.  Only over the
+// first half of each stretch, so it still stops at the end of it.
+#define kStartSpeed 0.3
+
+// Done within this far (m) of the end, or of a cusp.
+#define kEndTolerance 0.05
+
+// Gives up this long (s) after the trajectory should have finished.
+#define kTimeout 2.0
+
+void PurePursuitFollower::Start (const frc::Pose2d &pose) {
+    m_Progress = 0;
+    StartStretch();
+}
+
+void PurePursuitFollower::StartStretch () {
+    m_StretchStart = m_Progress;
+    m_Stop = m_Trajectory.NextStop(m_Progress);
+    m_Direction = m_Trajectory.AtDistance((m_StretchStart + m_Stop) / 2).velocity < 0 ? -1 : 1;
+}
+
+bool PurePursuitFollower::Update (const frc::Pose2d &pose, double time, Output &output) {
+    if (m_Trajectory.IsEmpty() || time > m_Trajectory.GetDuration() + kTimeout) return false;
+
+    double x = pose.X().to<double>();
+    double y = pose.Y().to<double>();
+    double angle = pose.Rotation().Radians().to<double>();
+
+    // Only forward, only as far as the lookahead could reach, and not past
+    // the next cusp, where the path comes back over itself.
+    m_Progress = m_Trajectory.Project(x, y, m_Progress, std::min(m_Progress + m_Lookahead.maximum, m_Stop)).distance;
+
+    if (m_Stop - m_Progress < kEndTolerance) {
+        if (m_Stop >= m_Trajectory.GetLength()) return false;
+
+        m_Progress = m_Stop;
+        StartStretch();
+    }
+
+    Trajectory::Sample closest = m_Trajectory.AtDistance(m_Progress);
+
+    double v = closest.velocity;
+    if (std::fabs(v) < kStartSpeed && closest.distance - m_StretchStart < (m_Stop - m_StretchStart) / 2) {
+        v = m_Direction * kStartSpeed;
+    }
+
+    double lookahead = std::clamp(m_Lookahead.gain * std::fabs(v), m_Lookahead.minimum, m_Lookahead.maximum);
+
+    // Past the end or a cusp, carries on straight, so the robot lines up
+    // with the last stretch instead of turning in on the point it stops at.
+    double goalDistance = closest.distance + lookahead;
+    Trajectory::Sample goal = m_Trajectory.AtDistance(std::min(goalDistance, m_Stop));
+    if (goalDistance > m_Stop) {
+        double travel = goal.heading + (m_Direction < 0 ? PI : 0);
+        goal.x += (goalDistance - m_Stop) * std::cos(travel);
+        goal.y += (goalDistance - m_Stop) * std::sin(travel);
+    }
+
+    // The goal in the robot's frame, and the arc to it, tangent to the
+    // robot.  With v signed, the same arc works backing up.
+    double dx = goal.x - x;
+    double dy = goal.y - y;
+    double goalX = std::cos(angle)*dx + std::sin(angle)*dy;
+    double goalY = -std::sin(angle)*dx + std::cos(angle)*dy;
+    double squared = goalX*goalX + goalY*goalY;
+    double curvature = squared > 1e-9 ? 2*goalY / squared : 0;
+
+    output.acceleration = closest.acceleration;
+    output.targetSpeed = v;
+    output.angularVelocity = v * curvature;
+    // Facing the goal, so the drivetrain's heading hold turns the same way
+    // as the arc, rather than back toward the path's tangent.
+    output.targetAngle = angle + (m_Direction < 0 ? std::atan2(-goalY, -goalX) : std::atan2(goalY, goalX));
+    output.reference = closest;
+
+    return true;
+}
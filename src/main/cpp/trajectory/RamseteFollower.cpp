@@ -0,0 +1,52 @@
+#include "trajectory/RamseteFollower.h"
+
+#include <cmath>
+
+constexpr double PI = 3.1415926535897932;
+
+// Into (-pi, pi].
+static double wrapAngle (double angle) {
+    angle = std::remainder(angle, 2*PI);
+    return angle <= -PI ? angle + 2*PI : angle;
+}
+
+// sin(x)/x, without dividing by zero.
+static double sinc (double x) {
+    return std::fabs(x) < 1e-9 ? 1.0 - x*x/6.0 : std::sin(x) / x;
+}
+
+void RamseteFollower::Start (const frc::Pose2d &pose) {}
+
+bool RamseteFollower::Update (const frc::Pose2d &pose, double time, Output &output) {
+    if (m_Trajectory.IsEmpty() || time >= m_Trajectory.GetDuration()) return false;
+
+    Trajectory::Sample reference = m_Trajectory.AtTime(time);
+
+    double x = pose.X().to<double>();
+    double y = pose.Y().to<double>();
+    double angle = pose.Rotation().Radians().to<double>();
+
+    // Error in the robot's frame: ahead, to the left, and turned.
+    double dx = reference.x - x;
+    double dy = reference.y - y;
+    double errorX = std::cos(angle)*dx + std::sin(angle)*dy;
+    double errorY = -std::sin(angle)*dx + std::cos(angle)*dy;
+    double errorAngle = wrapAngle(reference.heading - angle);
+
+    // Velocity is signed, so this works the same driving backwards.
+    double v = reference.velocity;
+    double w = reference.angularVelocity;
+
+    double k = 2*m_Gains.zeta*std::sqrt(w*w + m_Gains.b*v*v);
+
+    output.acceleration = reference.acceleration;
+    output.targetSpeed = v*std::cos(errorAngle) + k*errorX;
+    output.angularVelocity = w + k*errorAngle + m_Gains.b*v*sinc(errorAngle)*errorY;
+    // The heading error is already in angularVelocity.  Aiming the
+    // drivetrain's own heading correction at the reference too would count it
+    // twice, so it's given where the robot already points.
+    output.targetAngle = angle;
+    output.reference = reference;
+
+    return true;
+}
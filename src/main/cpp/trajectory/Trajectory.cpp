@@ -0,0 +1,217 @@
+#include "trajectory/Trajectory.h"
+
+#include <algorithm>
+#include <cmath>
+
+constexpr double PI = 3.1415926535897932;
+
+// Longest stretch (m) of the polyline profiled as one piece of constant
+// acceleration.  Longer ones are split, so there's room to speed up and slow
+// down even on a path of one straight line.
+#define kMaximumSpacing 0.05
+
+// Into (-pi, pi].
+static double wrapAngle (double angle) {
+    angle = std::remainder(angle, 2*PI);
+    return angle <= -PI ? angle + 2*PI : angle;
+}
+
+Trajectory::Trajectory (const std::vector<Waypoint> &waypoints, const Constraints &constraints, bool backwards) {
+    if (waypoints.size() < 2) return;
+
+    // Which way the robot faces at a point: headings from here on are the
+    // robot's, not the direction of travel.
+    auto facing = [&](const Waypoint &waypoint) {
+        Waypoint point = waypoint;
+        point.backwards = waypoint.backwards != backwards;
+        point.heading = wrapAngle(waypoint.heading + (point.backwards ? PI : 0));
+        return point;
+    };
+
+    // The polyline, no more than kMaximumSpacing apart, with the distance to
+    // each point.  Each piece is driven the way of the point it ends at, so a
+    // cusp's point is still driven the old way.
+    std::vector<Waypoint> points {facing(waypoints[0])};
+    std::vector<double> distance {0.0};
+    for (std::size_t i = 1; i < waypoints.size(); i++) {
+        const Waypoint a = facing(waypoints[i-1]);
+        const Waypoint b = facing(waypoints[i]);
+
+        double length = std::hypot(b.x - a.x, b.y - a.y);
+        if (length <= 0) continue;
+
+        int pieces = std::max(1, (int)std::ceil(length / kMaximumSpacing));
+        double turn = wrapAngle(b.heading - a.heading);
+        for (int piece = 1; piece <= pieces; piece++) {
+            double f = (double)piece / pieces;
+            points.push_back({
+                a.x + f*(b.x - a.x),
+                a.y + f*(b.y - a.y),
+                wrapAngle(a.heading + f*turn),
+                a.curvature + f*(b.curvature - a.curvature),
+                b.backwards
+            });
+            distance.push_back(distance.back() + length / pieces);
+        }
+    }
+
+    std::size_t n = points.size();
+    if (n < 2) return;
+
+    // The fastest each point can be taken through its bend.
+    std::vector<double> velocity(n);
+    for (std::size_t i = 0; i < n; i++) {
+        velocity[i] = constraints.maximumVelocity;
+        if (std::fabs(points[i].curvature) > 1e-9) {
+            velocity[i] = std::min(velocity[i], std::sqrt(constraints.maximumRadialAcceleration / std::fabs(points[i].curvature)));
+        }
+    }
+    velocity[0] = 0;
+    velocity[n-1] = 0;
+
+    // Stopped, to change direction.
+    for (std::size_t i = 1; i + 1 < n; i++) {
+        if (points[i].backwards != points[i+1].backwards) {
+            velocity[i] = 0;
+            m_Cusps.push_back(distance[i]);
+        }
+    }
+
+    // Then no faster than it can speed up to from the start, or brake from
+    // in time for the end and every bend.
+    for (std::size_t i = 1; i < n; i++) {
+        double ds = distance[i] - distance[i-1];
+        velocity[i] = std::min(velocity[i], std::sqrt(velocity[i-1]*velocity[i-1] + 2*constraints.maximumAcceleration*ds));
+    }
+    for (std::size_t i = n-1; i-- > 0;) {
+        double ds = distance[i+1] - distance[i];
+        velocity[i] = std::min(velocity[i], std::sqrt(velocity[i+1]*velocity[i+1] + 2*constraints.maximumDeceleration*ds));
+    }
+
+    // Time to reach each point, accelerating steadily between them.
+    std::vector<double> time(n, 0.0);
+    for (std::size_t i = 1; i < n; i++) {
+        double ds = distance[i] - distance[i-1];
+        double speed = velocity[i-1] + velocity[i];
+        time[i] = time[i-1] + (speed > 0 ? 2*ds/speed : 0);
+    }
+
+    // Resample evenly in time.
+    double duration = time[n-1];
+    std::size_t count = (std::size_t)std::ceil(duration / kStep) + 1;
+
+    for (auto vector : {&m_Time, &m_Distance, &m_X, &m_Y, &m_Heading, &m_Velocity, &m_Acceleration, &m_AngularVelocity, &m_Curvature}) {
+        vector->reserve(count);
+    }
+
+    std::size_t i = 1;
+    for (std::size_t sample = 0; sample < count; sample++) {
+        double t = std::min(sample * kStep, duration);
+        while (i < n-1 && time[i] < t) i++;
+
+        double dt = time[i] - time[i-1];
+        double ds = distance[i] - distance[i-1];
+        double a = dt > 0 ? (velocity[i] - velocity[i-1]) / dt : 0;
+
+        double elapsed = t - time[i-1];
+        double v = velocity[i-1] + a*elapsed;
+        double s = distance[i-1] + velocity[i-1]*elapsed + 0.5*a*elapsed*elapsed;
+        double f = ds > 0 ? std::clamp((s - distance[i-1]) / ds, 0.0, 1.0) : 0;
+
+        const Waypoint &from = points[i-1];
+        const Waypoint &to = points[i];
+        double heading = wrapAngle(from.heading + f*wrapAngle(to.heading - from.heading));
+        double curvature = from.curvature + f*(to.curvature - from.curvature);
+
+        double direction = to.backwards ? -1 : 1;
+        Add(t, s, from.x + f*(to.x - from.x), from.y + f*(to.y - from.y), heading, direction*v, direction*a, curvature);
+    }
+
+    // The last sample at or before every kDistanceStep.
+    std::size_t steps = (std::size_t)(GetLength() / kDistanceStep) + 1;
+    m_DistanceIndex.reserve(steps);
+
+    uint32_t index = 0;
+    for (std::size_t step = 0; step < steps; step++) {
+        double d = step * kDistanceStep;
+        while (index + 1 < m_Distance.size() && m_Distance[index + 1] <= d) index++;
+        m_DistanceIndex.push_back(index);
+    }
+
+    // Evenly spaced by distance, since samples bunch up where it's slow.
+    std::vector<double> xs, ys, distances;
+    std::size_t vertices = (std::size_t)std::ceil(GetLength() / kIndexStep) + 1;
+    for (std::size_t vertex = 0; vertex < vertices; vertex++) {
+        Sample sample = AtDistance(std::min(vertex * kIndexStep, GetLength()));
+        xs.push_back(sample.x);
+        ys.push_back(sample.y);
+        distances.push_back(sample.distance);
+    }
+    m_Index = PathIndex{xs, ys, distances};
+}
+
+void Trajectory::Add (double time, double distance, double x, double y, double heading, double velocity, double acceleration, double curvature) {
+    m_Time.push_back(time);
+    m_Distance.push_back(distance);
+    m_X.push_back(x);
+    m_Y.push_back(y);
+    m_Heading.push_back(heading);
+    m_Velocity.push_back(velocity);
+    m_Acceleration.push_back(acceleration);
+    // The robot turns with the path, whichever way it faces.
+    m_AngularVelocity.push_back(std::fabs(velocity) * curvature);
+    m_Curvature.push_back(curvature);
+}
+
+Trajectory::Sample Trajectory::GetSample (std::size_t index) const {
+    return {
+        m_Time[index], m_Distance[index], m_X[index], m_Y[index], m_Heading[index],
+        m_Velocity[index], m_Acceleration[index], m_AngularVelocity[index], m_Curvature[index]
+    };
+}
+
+Trajectory::Sample Trajectory::Interpolate (std::size_t index, double f) const {
+    if (index + 1 >= m_Time.size()) return GetSample(m_Time.size() - 1);
+
+    std::size_t next = index + 1;
+    auto lerp = [&](const std::vector<double> &v) { return v[index] + f*(v[next] - v[index]); };
+
+    return {
+        lerp(m_Time), lerp(m_Distance), lerp(m_X), lerp(m_Y),
+        wrapAngle(m_Heading[index] + f*wrapAngle(m_Heading[next] - m_Heading[index])),
+        lerp(m_Velocity), lerp(m_Acceleration), lerp(m_AngularVelocity), lerp(m_Curvature)
+    };
+}
+
+Trajectory::Sample Trajectory::AtTime (double time) const {
+    if (m_Time.empty()) return Sample{};
+
+    time = std::clamp(time, 0.0, GetDuration());
+
+    std::size_t index = std::min((std::size_t)(time / kStep), m_Time.size() - 1);
+    if (index + 1 >= m_Time.size()) return GetSample(index);
+
+    double span = m_Time[index + 1] - m_Time[index];
+    return Interpolate(index, span > 0 ? (time - m_Time[index]) / span : 0);
+}
+
+// The table lands on the sample just before, and slow stretches have a few
+// samples per step to walk past.
+Trajectory::Sample Trajectory::AtDistance (double distance) const {
+    if (m_Time.empty()) return Sample{};
+
+    distance = std::clamp(distance, 0.0, GetLength());
+
+    std::size_t step = std::min((std::size_t)(distance / kDistanceStep), m_DistanceIndex.size() - 1);
+    std::size_t index = m_DistanceIndex[step];
+    while (index + 1 < m_Distance.size() && m_Distance[index + 1] <= distance) index++;
+    if (index + 1 >= m_Time.size()) return GetSample(index);
+
+    double span = m_Distance[index + 1] - m_Distance[index];
+    return Interpolate(index, span > 0 ? (distance - m_Distance[index]) / span : 0);
+}
+
+double Trajectory::NextStop (double distance) const {
+    auto cusp = std::upper_bound(m_Cusps.begin(), m_Cusps.end(), distance);
+    return cusp == m_Cusps.end() ? GetLength() : *cusp;
+}
@@ -0,0 +1,42 @@
+#include "util/Deploy.h"
+
+#include <algorithm>
+#include <iostream>
+#include <system_error>
+
+#include <frc/Filesystem.h>
+#include <wpi/FileSystem.h>
+#include <wpi/Path.h>
+#include <wpi/SmallString.h>
+
+namespace Deploy {
+
+std::string path (const std::string &relative) {
+    wpi::SmallString<128> directory;
+    frc::filesystem::GetDeployDirectory(directory);
+
+    return std::string(directory.str()) + "/" + relative;
+}
+
+std::vector<std::string> listPaths (const std::string &directory) {
+    std::vector<std::string> names;
+
+    std::error_code error;
+    wpi::sys::fs::directory_iterator entry {directory, error}, end;
+    for (; !error && entry != end; entry.increment(error)) {
+        wpi::StringRef name = wpi::sys::path::filename(entry->path());
+        if (name.size() > 5 && name.endswith(".json")) {
+            names.push_back(name.str());
+        }
+    }
+
+    if (error) {
+        std::cerr << "Unable to list paths in " << directory << ": " << error.message() << std::endl;
+    }
+
+    // The directory's order is whatever the filesystem's is.
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+}
@@ -0,0 +1,74 @@
+#include "util/RateScheduler.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#define kRobotLoopPeriod 20_ms
+
+RateScheduler& RateScheduler::GetInstance () {
+    static RateScheduler instance;
+    return instance;
+}
+
+RateScheduler::RateScheduler () : m_FastestPeriod(kRobotLoopPeriod) {}
+
+void RateScheduler::Schedule (std::function<void()> task, units::second_t period) {
+    if (period < kRobotLoopPeriod) {
+        m_FastestPeriod = std::min(m_FastestPeriod, period);
+
+        if (nullptr == m_Robot) {
+            m_PendingFastTasks.emplace_back(std::move(task), period);
+        } else {
+            m_Robot->AddPeriodic(std::move(task), period, period / 2);
+        }
+        return;
+    }
+
+    int divisor = std::max((int)std::lround(units::unit_cast<double>(period / kRobotLoopPeriod)), 1);
+
+    m_Tasks.push_back({std::move(task), divisor, PickPhase(divisor)});
+}
+
+void RateScheduler::Install (frc::TimedRobot* robot) {
+    m_Robot = robot;
+
+    for (auto &[task, period] : m_PendingFastTasks) {
+        m_Robot->AddPeriodic(std::move(task), period, period / 2);
+    }
+    m_PendingFastTasks.clear();
+}
+
+void RateScheduler::Run () {
+    for (auto &task : m_Tasks) {
+        if (0 == task.countdown) {
+            task.task();
+            task.countdown = task.divisor - 1;
+        } else {
+            task.countdown--;
+        }
+    }
+}
+
+int RateScheduler::PickPhase (int divisor) {
+    int bestPhase = 0;
+    int bestLoad = INT_MAX;
+
+    for (int phase = 0; phase < divisor; phase++) {
+        int load = 0;
+        for (int loop = phase; loop < kHyperPeriod; loop += divisor) {
+            load = std::max(load, m_Load[loop]);
+        }
+
+        if (load < bestLoad) {
+            bestLoad = load;
+            bestPhase = phase;
+        }
+    }
+
+    for (int loop = bestPhase; loop < kHyperPeriod; loop += divisor) {
+        m_Load[loop]++;
+    }
+
+    return bestPhase;
+}
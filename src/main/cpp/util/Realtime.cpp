@@ -0,0 +1,225 @@
+#include "util/Realtime.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include <frc/Notifier.h>
+#include <frc/RobotBase.h>
+#include <frc/Threads.h>
+
+// The profile is built on glibc and Linux calls.  Desktop builds for other
+// systems get the no-op version at the bottom, which is what simulation runs
+// anyway.
+#ifdef __linux__
+
+#include <alloca.h>
+#include <malloc.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#define kDefaultNotifierPriority 45
+#define kDefaultAcquisitionPriority 42
+#define kDefaultControlPriority 40
+#define kDefaultMainPriority 35
+
+#define kDefaultStackPrefaultKB 256
+#define kDefaultHeapReserveMB 8
+
+namespace {
+
+struct {
+    bool enabled = false;
+    bool lockMemory = true;
+    int notifierPriority, acquisitionPriority, controlPriority, mainPriority;
+    std::size_t stackPrefault;
+    std::size_t heapReserve;
+} config;
+
+std::vector<std::pair<std::string, std::function<std::size_t()>>> prefaults;
+
+long lastMinorFaults = 0;
+long lastMajorFaults = 0;
+
+int priorityOf (Realtime::Thread thread) {
+    switch (thread) {
+        case Realtime::Thread::kMain:        return config.mainPriority;
+        case Realtime::Thread::kControl:     return config.controlPriority;
+        case Realtime::Thread::kAcquisition: return config.acquisitionPriority;
+    }
+    return 0;
+}
+
+// Big enough to reach the pages below it, but not inlined into the caller, so
+// they're the caller's stack.
+__attribute__((noinline)) void prefaultStack (std::size_t bytes) {
+    volatile char* stack = static_cast<volatile char*>(alloca(bytes));
+    for (std::size_t i = 0; i < bytes; i += sysconf(_SC_PAGESIZE)) {
+        stack[i] = 0;
+    }
+}
+
+void raiseThread (const char* name, int priority) {
+    prefaultStack(config.stackPrefault);
+
+    if (frc::SetCurrentThreadPriority(true, priority)) {
+        std::cout << "realtime: " << name << " thread at priority " << priority << std::endl;
+    } else {
+        std::cerr << "realtime: couldn't raise " << name << " thread to priority " << priority << std::endl;
+    }
+}
+
+}
+
+namespace Realtime {
+
+void Configure (std::shared_ptr<cpptoml::table> toml) {
+    if (nullptr == toml) return;
+
+    config.enabled = toml->get_qualified_as<bool>("enabled").value_or(false);
+    config.lockMemory = toml->get_qualified_as<bool>("lockMemory").value_or(true);
+
+    config.notifierPriority    = toml->get_qualified_as<int>("priority.notifier").value_or(kDefaultNotifierPriority);
+    config.acquisitionPriority = toml->get_qualified_as<int>("priority.acquisition").value_or(kDefaultAcquisitionPriority);
+    config.controlPriority     = toml->get_qualified_as<int>("priority.control").value_or(kDefaultControlPriority);
+    config.mainPriority        = toml->get_qualified_as<int>("priority.main").value_or(kDefaultMainPriority);
+
+    config.stackPrefault = 1024 * toml->get_qualified_as<int>("stackPrefaultKB").value_or(kDefaultStackPrefaultKB);
+    config.heapReserve = 1024 * 1024 * toml->get_qualified_as<int>("heapReserveMB").value_or(kDefaultHeapReserveMB);
+
+    if (config.enabled && frc::RobotBase::IsSimulation()) {
+        std::cout << "realtime: ignored in simulation" << std::endl;
+        config.enabled = false;
+    }
+}
+
+bool IsEnabled () {
+    return config.enabled;
+}
+
+void Start () {
+    if (!config.enabled) return;
+
+    auto start = std::chrono::steady_clock::now();
+
+    if (config.lockMemory) {
+        // Keep freed memory, rather than handing it back and faulting it in
+        // again, and keep big blocks out of mmap, which would be new pages.
+        mallopt(M_TRIM_THRESHOLD, -1);
+        mallopt(M_MMAP_MAX, 0);
+
+        if (0 == mlockall(MCL_CURRENT | MCL_FUTURE)) {
+            std::cout << "realtime: memory locked" << std::endl;
+        } else {
+            std::cerr << "realtime: mlockall failed: " << std::strerror(errno) << std::endl;
+        }
+    }
+
+    frc::Notifier::SetHALThreadPriority(true, config.notifierPriority);
+    std::cout << "realtime: HAL notifier thread at priority " << config.notifierPriority << std::endl;
+
+    raiseThread("main", config.mainPriority);
+
+    // Malloc keeps this for later, already mapped.
+    if (0 < config.heapReserve) {
+        void* reserve = std::malloc(config.heapReserve);
+        if (nullptr != reserve) {
+            TouchPages(reserve, config.heapReserve);
+            std::free(reserve);
+            std::cout << "realtime: reserved " << config.heapReserve / (1024 * 1024) << " MB of heap" << std::endl;
+        }
+    }
+
+    for (auto &[name, touch] : prefaults) {
+        auto taskStart = std::chrono::steady_clock::now();
+        std::size_t bytes = touch();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - taskStart).count();
+
+        std::cout << "realtime: prefaulted " << name << ", " << bytes / 1024 << " KB in " << ms << " ms" << std::endl;
+    }
+    prefaults.clear();
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "realtime: ready in " << ms << " ms" << std::endl;
+}
+
+void EnterThread (Thread thread, const char* name) {
+    if (!config.enabled) return;
+
+    raiseThread(name, priorityOf(thread));
+}
+
+void AddPrefault (std::string name, std::function<std::size_t()> touch) {
+    if (!config.enabled) return;
+
+    prefaults.emplace_back(std::move(name), std::move(touch));
+}
+
+std::size_t TouchPages (void* data, std::size_t bytes) {
+    volatile char* bytePointer = static_cast<volatile char*>(data);
+    std::size_t page = sysconf(_SC_PAGESIZE);
+
+    for (std::size_t i = 0; i < bytes; i += page) {
+        bytePointer[i] = bytePointer[i];
+    }
+
+    return bytes;
+}
+
+void ReportFaults (const char* mode) {
+    if (!config.enabled) return;
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    std::cout << "realtime: " << usage.ru_minflt - lastMinorFaults << " minor and " << usage.ru_majflt - lastMajorFaults
+        << " major page faults, starting " << mode << std::endl;
+
+    lastMinorFaults = usage.ru_minflt;
+    lastMajorFaults = usage.ru_majflt;
+}
+
+}
+
+#else
+
+#define kFallbackPageSize 4096
+
+namespace Realtime {
+
+void Configure (std::shared_ptr<cpptoml::table> toml) {
+    if (nullptr != toml && toml->get_qualified_as<bool>("enabled").value_or(false)) {
+        std::cout << "realtime: only on Linux" << std::endl;
+    }
+}
+
+bool IsEnabled () {
+    return false;
+}
+
+void Start () {}
+
+void EnterThread (Thread thread, const char* name) {}
+
+void AddPrefault (std::string name, std::function<std::size_t()> touch) {}
+
+std::size_t TouchPages (void* data, std::size_t bytes) {
+    volatile char* bytePointer = static_cast<volatile char*>(data);
+
+    for (std::size_t i = 0; i < bytes; i += kFallbackPageSize) {
+        bytePointer[i] = bytePointer[i];
+    }
+
+    return bytes;
+}
+
+void ReportFaults (const char* mode) {}
+
+}
+
+#endif
@@ -0,0 +1,45 @@
+#include "util/Telemetry.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <frc2/Timer.h>
+#include <networktables/NetworkTableInstance.h>
+
+// Every live handle.  Only touched from the main thread.
+static std::vector<TelemetryEntry*>& entries () {
+    static std::vector<TelemetryEntry*> all;
+    return all;
+}
+
+TelemetryEntry::TelemetryEntry (const std::string &key, units::second_t period) : m_Period(period) {
+    m_Entry = nt::NetworkTableInstance::GetDefault().GetTable("SmartDashboard")->GetEntry(key);
+
+    entries().push_back(this);
+}
+
+TelemetryEntry::~TelemetryEntry () {
+    auto &all = entries();
+    all.erase(std::remove(all.begin(), all.end(), this), all.end());
+}
+
+void TelemetryEntry::Flush (units::second_t now) {
+    if (!m_Changed || now - m_LastSent < m_Period) return;
+
+    Send();
+
+    m_Changed = false;
+    m_LastSent = now;
+}
+
+namespace Telemetry {
+
+void Flush () {
+    units::second_t now = frc2::Timer::GetFPGATimestamp();
+
+    for (auto entry : entries()) {
+        entry->Flush(now);
+    }
+}
+
+}
@@ -0,0 +1,45 @@
+#include "util/WorkerPool.h"
+
+#define kSharedPoolThreads 2
+
+WorkerPool::WorkerPool (int threads) {
+    for (int i = 0; i < threads; i++) {
+        m_Threads.emplace_back(&WorkerPool::WorkerThread, this);
+    }
+}
+
+WorkerPool::~WorkerPool () {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+    }
+    m_JobAdded.notify_all();
+
+    for (auto &thread : m_Threads) {
+        thread.join();
+    }
+}
+
+WorkerPool& WorkerPool::GetInstance () {
+    static WorkerPool pool {kSharedPoolThreads};
+    return pool;
+}
+
+void WorkerPool::WorkerThread () {
+    while (true) {
+        std::function<void()> job;
+
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_JobAdded.wait(lock, [this] { return m_Stopping || !m_Jobs.empty(); });
+
+            // Finish what was queued before stopping.
+            if (m_Jobs.empty()) return;
+
+            job = std::move(m_Jobs.front());
+            m_Jobs.pop_front();
+        }
+
+        job();
+    }
+}
@@ -5,6 +5,7 @@
 namespace ConfigFiles {
     const std::string ConfigFile     = "config.toml";
     const std::string AutoConfigFile = "auto.toml";
+    const std::string SimConfigFile  = "sim.toml";
 }
 
 namespace Pins {
@@ -72,6 +73,13 @@ namespace Pins {
     constexpr int AIR_7 = 7;
 }
 
+// Driver Station ports for each operator's controller
+namespace ControllerPorts {
+    constexpr int kDriver   = 0;
+    constexpr int kOperator = 1;
+    constexpr int kClimb    = 2;
+}
+
 // CAN IDs for drivetrain Spark MAXes
 namespace DriveMotorPins {
     constexpr int Left1  = Pins::CAN_1;
@@ -3,10 +3,38 @@
 #include "pixy/PixyBlock.h"
 
 #include <stdint.h>
-#include <map>
+#include <array>
+#include <optional>
 #include <vector>
 
-struct BlockStats;
+// Track useful information about PixyBlocks that allows us to sift through the
+// noise and incongruities to distinguish cell layouts.
+struct BlockStats {
+    int m_Index;
+    int m_MaxAge;
+
+    // Average x positions.
+    int m_TotalX;
+    int m_NumX;
+
+    // Average y positions.
+    int m_TotalY;
+    int m_NumY;
+
+    // Average widths.
+    int m_TotalWidth;
+    int m_NumWidth;
+
+    // Average heights.
+    int m_TotalHeight;
+    int m_NumHeight;
+
+    BlockStats() = default;
+    BlockStats(const PixyBlock &block);
+    BlockStats(const BlockStats &stats) = default;
+
+    void Update(const PixyBlock &block);
+};
 
 class PathARedDetector;
 class PathABlueDetector;
@@ -16,8 +44,9 @@ class PathBBlueDetector;
 
 class LayoutDetector {
     // A possible candidate is a potential power cell or really good false
-    // positive. We have not, yet, settled on the three we like.
-    std::map<uint8_t, BlockStats> possibles;
+    // positive. We have not, yet, settled on the three we like.  Indexed by
+    // the Pixy's block index, so a new block doesn't allocate a node.
+    std::array<std::optional<BlockStats>, 256> possibles;
 
 public:
     struct Point {
@@ -26,8 +55,13 @@ public:
         Point(int x, int y) : x(x), y(y) {}
     };
 
+private:
+    // Averages of the liked possibles, kept between calls to GetError.
+    std::vector<Point> expectedPoints;
+
+public:
 
-    virtual std::vector<Point> ActualPoints() = 0;
+    virtual const std::vector<Point> &ActualPoints() = 0;
     virtual bool FilterBlock(const PixyBlock &block) = 0;
 
     void Reset();
@@ -44,54 +78,24 @@ public:
 
 class PathARedDetector : public LayoutDetector {
 public:
-    std::vector<LayoutDetector::Point> ActualPoints() override;
+    const std::vector<LayoutDetector::Point> &ActualPoints() override;
     bool FilterBlock(const PixyBlock &block) override;
 };
 
 class PathABlueDetector : public LayoutDetector {
 public:
-    std::vector<LayoutDetector::Point> ActualPoints() override;
+    const std::vector<LayoutDetector::Point> &ActualPoints() override;
     bool FilterBlock(const PixyBlock &block) override;
 };
 
 class PathBRedDetector : public LayoutDetector {
 public:
-    std::vector<LayoutDetector::Point> ActualPoints() override;
+    const std::vector<LayoutDetector::Point> &ActualPoints() override;
     bool FilterBlock(const PixyBlock &block) override;
 };
 
 class PathBBlueDetector : public LayoutDetector {
 public:
-    std::vector<LayoutDetector::Point> ActualPoints() override;
+    const std::vector<LayoutDetector::Point> &ActualPoints() override;
     bool FilterBlock(const PixyBlock &block) override;
 };
-
-
-// Track useful information about PixyBlocks that allows us to sift through the
-// noise and incongruities to distinguish cell layouts.
-struct BlockStats {
-    int m_Index;
-    int m_MaxAge;
-
-    // Average x positions.
-    int m_TotalX;
-    int m_NumX;
-
-    // Average y positions.
-    int m_TotalY;
-    int m_NumY;
-
-    // Average widths.
-    int m_TotalWidth;
-    int m_NumWidth;
-
-    // Average heights.
-    int m_TotalHeight;
-    int m_NumHeight;
-
-    BlockStats() = default;
-    BlockStats(const PixyBlock &block);
-    BlockStats(const BlockStats &stats) = default;
-
-    void Update(const PixyBlock &block);
-};
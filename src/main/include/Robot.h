@@ -5,6 +5,7 @@
 #include <hal/cpp/fpga_clock.h>
 
 #include "RobotContainer.h"
+#include "util/Telemetry.h"
 
 class Robot : public frc::TimedRobot {
  public:
@@ -18,6 +19,8 @@ class Robot : public frc::TimedRobot {
   void TeleopInit() override;
   void TeleopPeriodic() override;
   void TestPeriodic() override;
+  void SimulationInit() override;
+  void SimulationPeriodic() override;
 
   double GetDeltaTime() { return m_DeltaTime; }
 
@@ -32,4 +35,9 @@ class Robot : public frc::TimedRobot {
   hal::fpga_clock::time_point m_timePrev = hal::fpga_clock::now();
 
   RobotContainer m_container;
+
+  // Robot mode last set from an input replay.
+  int m_ReplayMode = -1;
+
+  TelemetryString m_ControlPanelColor {"Control Panel Color"};
 };
@@ -1,12 +1,25 @@
 #pragma once
 
+#include <functional>
+#include <future>
+#include <map>
+#include <string>
+#include <vector>
+
 #include <cpptoml.h>
 
 #include <frc2/command/Command.h>
 #include <frc/smartdashboard/SendableChooser.h>
-#include <frc/XboxController.h>
 
 #include "SendableChooser2.h"
+#include "autonomous/RoutineCompiler.h"
+#include "input/InputBindings.h"
+#include "input/InputRecorder.h"
+#include "input/InputSnapshot.h"
+#include "input/InputSource.h"
+#include "input/ReplayInput.h"
+#include "sim/RobotSimulation.h"
+#include "util/Telemetry.h"
 
 #include "subsystems/Climb.h"
 #include "subsystems/Drivetrain.h"
@@ -18,6 +31,7 @@
 
 #include "commands/ExpelIntakeCommand.h"
 #include "commands/ExtendIntakeCommand.h"
+#include "commands/IdleShooterCommand.h"
 #include "commands/IntakeBallsCommand.h"
 #include "commands/PreheatShooterCommand.h"
 #include "commands/RetractIntakeCommand.h"
@@ -30,33 +44,83 @@
 #include "commands/RollClimbLeftCommand.h"
 #include "commands/RollClimbRightCommand.h"
 #include "commands/ControlWinchCommand.h"
+#include "commands/FollowPolybezier.h"
 #include "commands/LockWinchCommand.h"
 #include "commands/UnlockWinchCommand.h"
 #include "commands/ClimbCylinderExtendCommand.h"
 #include "commands/ClimbCylinderRetractCommand.h"
 
+class AutoSimulation;
+
 class RobotContainer {
     public:
+        // Start of the routines simulation adds for each deployed path.
+        static constexpr const char* kPathRoutinePrefix = "path - ";
+
         RobotContainer();
 
         frc2::Command* GetAutonomousCommand();
 
+        // Builds the selected autonomous routine in the background, if it
+        // hasn't been built yet.  Call while disabled.
+        void PrepareSelectedAuto();
+
         void PollInput();
 
+        // Records driver input while the robot is enabled.
+        void StartInputLog();
+        void StopInputLog();
+
+        // Log being played back instead of the Driver Station, or nullptr.
+        // Set INPUT_REPLAY to a log file in simulation to use one.
+        ReplayInput* GetInputReplay () { return m_InputReplay; }
+
+        // Plants standing in for the hardware, or nullptr on the robot.
+        RobotSimulation* GetSimulation () { return m_Simulation; }
+
+        // Set AUTO_SIM in simulation to run autonomous routines headless.
+        AutoSimulation* GetAutoSimulation () { return m_AutoSimulation; }
+
+        // Every autonomous routine, in the order they were added.
+        std::vector<std::string> GetAutonomousNames () { return m_AutoNames; }
+
+        // Run this routine instead of the one chosen on the dashboard.
+        void SelectAutonomous (std::string name) { m_AutoOverride = std::move(name); }
+
     private:
         void ConfigureButtonBindings();
 
         std::shared_ptr<cpptoml::table> LoadConfig(std::string path);
 
-        void InitAutonomousChooser();
+        using AutoFactory = std::function<frc2::Command*()>;
 
+        // Uses the whole config.toml, for the path limits in [follower].
+        void InitAutonomousChooser(std::shared_ptr<cpptoml::table> toml);
+        void AddAutonomous(std::string name, AutoFactory factory, bool isDefault = false);
+
+        void PreloadPaths(std::string directory, FollowPolybezier::Configuration followerConfig);
+
+        // Adds a routine that just follows each path, named kPathRoutinePrefix
+        // and the file name.
+        void AddPathRoutines(std::string directory, FollowPolybezier::Configuration followerConfig);
+
+        // Adds the routines described in an auto.toml to the chooser.
+        void LoadAutonomousRoutines(std::string path, FollowPolybezier::Configuration followerConfig);
+
+        std::string GetSelectedAutoName();
         void ReportSelectedAuto();
 
-        // Operators' input devices.
-        // These are 0 indexed!
-        frc::XboxController m_DriverJoystick{0};
-        frc::XboxController m_OperatorJoystick{1};
-        frc::XboxController m_ClimbJoystick{2};
+        // Operators' input devices, read once per loop.
+        // Ports are in ControllerPorts.
+        InputSource* m_InputSource;
+        InputSnapshot m_Input;
+        InputBindings m_Bindings;
+
+        InputRecorder* m_InputRecorder;
+        ReplayInput* m_InputReplay = nullptr;
+
+        RobotSimulation* m_Simulation = nullptr;
+        AutoSimulation* m_AutoSimulation = nullptr;
 
         // The robot's subsystems and commands are defined here...
         Drivetrain* m_Drivetrain;
@@ -74,6 +138,7 @@ class RobotContainer {
         ShootCommand* m_TeleopShootCommand;
         ShootCommand* m_TeleopSlowShootCommand;
         ReverseBrushesCommand* m_ReverseBrushesCommand;
+        IdleShooterCommand* m_IdleShooterCommand;
 
         ShootCommand* m_ChallengeNearShootCommand;
         ShootCommand* m_ChallengeNearMidShootCommand;
@@ -91,7 +156,20 @@ class RobotContainer {
 
         ControlWinchCommand* m_ControlWinchCommand;
 
-        SendableChooser2<frc2::Command *> m_DashboardAutoChooser;
+        SendableChooser2<AutoFactory> m_DashboardAutoChooser;
+
+        // Routines are only built once selected, then kept.
+        std::map<std::string, AutoFactory> m_AutoFactories;
+        std::vector<std::string> m_AutoNames;
+        std::string m_AutoOverride;
+        std::map<std::string, frc2::Command*> m_AutoCache;
+
+        RoutineCompiler m_RoutineCompiler;
+
+        // Routine being built in the background.
+        std::string m_AutoBuildName;
+        std::future<frc2::Command*> m_AutoBuild;
+        TelemetryString m_SelectedAutoTelemetry {"Robot sees autonomous"};
 
         Pixycam* m_Pixy;
 
@@ -99,4 +177,5 @@ class RobotContainer {
         bool m_IntakeExtended = false;
 
     friend class Robot;
+    friend class AutoSimulation;
 };
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cpptoml.h>
+
+#include <frc2/command/Command.h>
+
+// Turns autonomous routines described in a TOML file into command groups, so
+// strategy can be changed with a deploy instead of a rebuild.
+//
+//     [[routine]]
+//     name = "3 cell auto"
+//     default = true
+//     steps = [
+//         { command = "aim", timeout = 2.0 },
+//         { parallel = [
+//             { command = "drive", speed = 0.25 },
+//             { command = "intake" },
+//         ], timeout = 1.0 },
+//     ]
+//
+// A step is one of:
+//  - { command = "name", ... }   a command registered with Register.  The
+//                                 rest of the step's keys are its parameters.
+//  - { sequence = [ steps ] }     one after another
+//  - { parallel = [ steps ] }     together, until all finish
+//  - { race = [ steps ] }         together, until any finishes
+//  - { deadline = [ steps ] }     together, until the first finishes
+//  - { wait = seconds }
+// and any step can have a timeout, in seconds.
+//
+// Files are checked when loaded, and routines that won't compile are reported
+// and left out.  Compiling a loaded routine can't fail.
+class RoutineCompiler {
+    public:
+        using Params = std::shared_ptr<cpptoml::table>;
+        using CommandFactory = std::function<std::unique_ptr<frc2::Command>(const Params &params)>;
+
+        struct Step {
+            enum Kind { kCommand, kSequence, kParallel, kRace, kDeadline, kWait };
+
+            Kind kind;
+            std::string command;
+            Params params;
+            std::vector<Step> steps;
+            double seconds = 0;     // for kWait
+            double timeout = 0;     // none if not positive
+        };
+
+        struct Routine {
+            std::string name;
+            bool isDefault;
+            Step step;
+        };
+
+        void Register(std::string name, CommandFactory factory);
+
+        // Reads every [[routine]] in a file.  Returns nothing if the file is
+        // missing or can't be parsed.
+        std::vector<Routine> Load(const std::string &path) const;
+
+        // Safe to call from any thread once registration is done.
+        std::unique_ptr<frc2::Command> Compile(const Step &step) const;
+
+    private:
+        Step ParseStep(const Params &params) const;
+        std::vector<Step> ParseSteps(const cpptoml::table &table, const std::string &key) const;
+
+        std::map<std::string, CommandFactory> m_Factories;
+};
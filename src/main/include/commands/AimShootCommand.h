@@ -5,6 +5,7 @@
 
 #include "Units.h"
 
+#include "subsystems/Drivetrain.h"
 #include "subsystems/Intake.h"
 #include "subsystems/PowerCellCounter.h"
 #include "subsystems/Shooter.h"
@@ -12,17 +13,27 @@
 class AimShootCommand : public frc2::CommandHelper<frc2::CommandBase, AimShootCommand> {
     public:
         explicit AimShootCommand(rpm_t shootSpeed, Shooter* shooter, Intake* intake, PowerCellCounter* counter);
+
+        // Shoot while driving.  Leads the target using the drivetrain's speed.
+        // The drivetrain is only read, so it is not a requirement.
+        explicit AimShootCommand(rpm_t shootSpeed, Shooter* shooter, Intake* intake, PowerCellCounter* counter, Drivetrain* drivetrain);
         void Initialize();
         void Execute();
         void End(bool interrupted);
         bool IsFinished();
 
     private:
+        enum class FeedState { Unknown, Stopped, Staging, Shooting };
+
+        void SetFeedState(FeedState state);
+
         Shooter* m_Shooter;
         Intake* m_Intake;
         PowerCellCounter* m_PowerCellCounter;
+        Drivetrain* m_Drivetrain = nullptr;
 
         rpm_t m_ShootSpeed = 0_rpm;
+        rpm_t m_TargetSpeed = 0_rpm;
 
-        bool feederActivated = false;
+        FeedState m_FeedState = FeedState::Unknown;
 };
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
+#include <initializer_list>
+#include <iostream>
+#include <memory>
+
+#include <frc2/command/CommandBase.h>
+#include <frc2/command/CommandHelper.h>
+#include <frc2/command/Subsystem.h>
+
+#include "util/WorkerPool.h"
+
+// Runs expensive work, like planning a path, on the worker pool instead of in
+// Execute, then hands the result to a follow-on command and runs that.
+//
+// The robot loop only ever checks whether the work is done, so a slow plan
+// delays the routine instead of overrunning the loop.
+//
+// Work is given a flag that is set if the command is interrupted.  Check it
+// between expensive steps and return early; the result is thrown away.  The
+// worker can't be stopped from outside, so interrupting never waits for it.
+//
+// The follow-on command is run from inside this one, so this command must
+// require everything the follow-on will.  Return nullptr from then, or leave
+// it empty, to finish as soon as the result arrives.
+template <typename T>
+class AsyncCommand : public frc2::CommandHelper<frc2::CommandBase, AsyncCommand<T>> {
+    public:
+        using Work = std::function<T(const std::atomic<bool> &cancelled)>;
+        using FollowOn = std::function<std::unique_ptr<frc2::Command>(T result)>;
+
+        AsyncCommand (Work work, FollowOn then, std::initializer_list<frc2::Subsystem*> requirements = {})
+            : m_Work(std::move(work)), m_Then(std::move(then))
+        {
+            this->AddRequirements(requirements);
+        }
+
+        void Initialize () {
+            m_Cancelled = std::make_shared<std::atomic<bool>>(false);
+            m_FollowOn.reset();
+            m_State = State::Working;
+
+            auto work = m_Work;
+            auto cancelled = m_Cancelled;
+            m_Result = WorkerPool::GetInstance().Submit([work, cancelled] { return work(*cancelled); });
+        }
+
+        void Execute () {
+            if (State::Working == m_State) {
+                if (std::future_status::ready != m_Result.wait_for(std::chrono::seconds(0))) return;
+
+                try {
+                    T result = m_Result.get();
+                    m_FollowOn = m_Then ? m_Then(std::move(result)) : nullptr;
+                } catch (const std::exception &ex) {
+                    std::cerr << "Background work failed: " << ex.what() << std::endl;
+                    m_State = State::Done;
+                    return;
+                }
+
+                if (nullptr == m_FollowOn) {
+                    m_State = State::Done;
+                    return;
+                }
+
+                m_State = State::Running;
+                m_FollowOn->Initialize();
+            }
+
+            if (State::Running == m_State) {
+                m_FollowOn->Execute();
+                if (m_FollowOn->IsFinished()) {
+                    m_FollowOn->End(false);
+                    m_State = State::Done;
+                }
+            }
+        }
+
+        void End (bool interrupted) {
+            if (State::Working == m_State) {
+                // Leave the worker to notice and give up.  Dropping the future
+                // doesn't wait for it.
+                *m_Cancelled = true;
+                m_Result = std::future<T>();
+            } else if (State::Running == m_State) {
+                m_FollowOn->End(interrupted);
+            }
+
+            m_State = State::Done;
+        }
+
+        bool IsFinished () {
+            return State::Done == m_State;
+        }
+
+    private:
+        enum class State { Working, Running, Done };
+
+        Work m_Work;
+        FollowOn m_Then;
+
+        State m_State = State::Done;
+        std::shared_ptr<std::atomic<bool>> m_Cancelled;
+        std::future<T> m_Result;
+        std::unique_ptr<frc2::Command> m_FollowOn;
+};
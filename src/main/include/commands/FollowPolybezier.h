@@ -1,14 +1,22 @@
 #pragma once
 
+#include <future>
+#include <memory>
+#include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include <cpptoml.h>
 #include <wpi/json.h>
 #include <frc2/command/CommandBase.h>
 #include <frc2/command/CommandHelper.h>
+#include <frc2/command/InstantCommand.h>
 
 #include "subsystems/Drivetrain.h"
 #include "bezier/bezier.h"
+#include "trajectory/Follower.h"
+#include "trajectory/Trajectory.h"
 
 class FollowPolybezier : public frc2::CommandHelper<frc2::CommandBase, FollowPolybezier> {
     public:
@@ -16,9 +24,76 @@ class FollowPolybezier : public frc2::CommandHelper<frc2::CommandBase, FollowPol
             double maximumRadialAcceleration;
             double maximumJerk;
             double maximumReverseAcceleration;
+
+            // For the trajectory's velocity profile.
+            double maximumVelocity = 3.5;
+            double maximumAcceleration = 1.0;
+        };
+
+        struct DistanceSample {
+            Point::Point p;
+            double t;
+            double d;
+            double maxV;
+            bool minimum;
         };
 
-        FollowPolybezier(Drivetrain *drivetrain, const wpi::Twine &filename, Configuration configuration, bool backwards = false);
+        struct Curve {
+            Bezier::CubicBezier bezier;
+
+            // Its polyline approximation.
+            std::vector<DistanceSample> samples;
+
+            // Driven with the robot facing backwards.  Where this changes
+            // from one curve to the next, the robot stops and reverses.
+            bool backwards = false;
+        };
+
+        // Either an array of curves, each an array of four [x, y] control
+        // points, or segments driven one way or the other in turn:
+        //
+        //  { "segments": [ { "backwards": false, "curves": [...] }, ... ] }
+        using Path = std::vector<Curve>;
+
+        // How far (m) odometry was to the side of the path, sampled every Execute.
+        struct TrackingStats {
+            int samples = 0;
+            double total = 0;
+            double max = 0;
+        };
+
+        // Stats from every follower since the last call, then starts over.
+        static TrackingStats TakeTrackingStats();
+
+        // Starts loading a path on the worker pool, or returns the one already
+        // loading.  Paths are cached by file and configuration, so load every
+        // path at boot and the commands find them ready.
+        static std::shared_future<Path> LoadPath(const std::string &filename, Configuration configuration);
+
+        // The path, profiled and sampled evenly in time.  Cached like
+        // LoadPath, and built on the worker pool once the path has loaded.
+        static std::shared_future<Trajectory> LoadTrajectory(const std::string &filename, Configuration configuration, bool backwards = false);
+
+        // Reads [follower] from config.toml: which Follower each path uses,
+        // and their gains.  Call before constructing any followers.
+        static void ConfigureFollowers(std::shared_ptr<cpptoml::table> toml);
+
+        // Puts the robot at the start of a path, facing +x.  The start is
+        // looked up when the command runs, so building a routine doesn't wait
+        // for its paths to load.
+        static frc2::InstantCommand ResetPoseCommand(Drivetrain *drivetrain, std::shared_future<Path> path);
+
+        // The limits paths are planned with, from the same [follower] table.
+        // The robot and the benchmark both plan with these.
+        static Configuration ReadConfiguration(std::shared_ptr<cpptoml::table> toml);
+
+        // Approximates a curve's polyline, and the fastest it can be taken at
+        // each vertex.
+        static void AddApproximation(Curve *curve, const Configuration &config, double previousCurveFinalSpeed = 0);
+
+        // Without a kind, uses the one configured for the file.
+        FollowPolybezier(Drivetrain *drivetrain, const wpi::Twine &filename, Configuration configuration, bool backwards = false,
+            std::optional<Follower::Kind> kind = std::nullopt);
 
         void Initialize();
         void Execute();
@@ -27,48 +102,33 @@ class FollowPolybezier : public frc2::CommandHelper<frc2::CommandBase, FollowPol
             drivetrain->SetAcceleration(0, 0);
             drivetrain->SetAngularVelocity(0);
             drivetrain->SetBrake(true);
-            logFile->close();
+            follower.reset();
         }
 
         bool IsFinished () { return finished; };
 
-        Point::Point GetStartPoint () { return polybezier[0].second[0].p; }
-        Point::Point GetEndPoint () { return polybezier.back().second.back().p; }
+        std::shared_future<Path> GetPath () const { return path; }
+        std::shared_future<Trajectory> GetTrajectory () const { return trajectory; }
 
     private:
-        struct DistanceSample {
-            Point::Point p;
-            double t;
-            double d;
-            double maxV;
-            bool minimum;
-        };
-
-        std::pair<double, double> CalculateAcceleration();
-
-        void LoadCurve(wpi::json::value_type controlPoints);
-        void AddApproximation(std::pair<Bezier::CubicBezier, std::vector<DistanceSample>> *bezier, double previousCurveFinalSpeed = 0);
-        void SetNextMin();
-
-        void ResetCurveProgress();
+        static void LoadCurve(Path &path, wpi::json::value_type controlPoints, const Configuration &config, bool backwards = false);
+        static std::vector<Trajectory::Waypoint> GetWaypoints(const Path &path);
 
         Drivetrain *drivetrain;
         Configuration config;
         bool backwards;
+        Follower::Kind kind;
 
         bool finished;
 
-        std::vector<std::pair<Bezier::CubicBezier, std::vector<DistanceSample>>> polybezier {};
-        unsigned int currentBezier;
-        unsigned int prevVertex;
-        std::pair<unsigned int, unsigned int> nextMin;
-
-        double distanceTraveled; // since beginning of curve
-        frc::Pose2d lastPose;
+        // Shared with every other follower of the same file.
+        std::shared_future<Path> path;
+        std::shared_future<Trajectory> trajectory;
 
-        uint64_t lastTime;
-        double velocity;
-        double acceleration;
+        // Made in Initialize, for one run of the path.
+        std::unique_ptr<Follower> follower;
+        uint64_t startTime;
 
-        std::ofstream *logFile;
+    // Times the planning steps on their own.  See src/benchmark.
+    friend class FollowerBenchmark;
 };
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <frc2/command/CommandBase.h>
+#include <frc2/command/CommandHelper.h>
+
+#include "Units.h"
+
+#include "subsystems/PowerCellCounter.h"
+#include "subsystems/Shooter.h"
+
+// Default command for the shooter.  Keeps the flywheel turning at its idle
+// speed while there are cells to shoot, so volleys don't start from rest.
+class IdleShooterCommand : public frc2::CommandHelper<frc2::CommandBase, IdleShooterCommand> {
+    public:
+        explicit IdleShooterCommand(Shooter* shooter, PowerCellCounter* counter);
+        void Initialize();
+        void Execute();
+        void End(bool interrupted);
+
+    private:
+        Shooter* m_Shooter;
+        PowerCellCounter* m_PowerCellCounter;
+
+        rpm_t m_AppliedSpeed = 0_rpm;
+        bool m_NeedsUpdate = true;
+};
@@ -2,17 +2,17 @@
 
 #include <frc2/command/CommandBase.h>
 #include <frc2/command/CommandHelper.h>
-#include <frc/XboxController.h>
 
+#include "input/InputSnapshot.h"
 #include "subsystems/Drivetrain.h"
 
 class TeleopDriveCommand : public frc2::CommandHelper<frc2::CommandBase, TeleopDriveCommand> {
     public:
-        explicit TeleopDriveCommand(Drivetrain* drivetrain, frc::XboxController* driverController);
+        explicit TeleopDriveCommand(Drivetrain* drivetrain, const ControllerSnapshot* driverController);
         void Initialize();
         void Execute();
 
     private:
         Drivetrain* m_Drivetrain;
-        frc::XboxController* m_Controller;
+        const ControllerSnapshot* m_Controller;
 };
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <utility>
+
+#include <frc2/Timer.h>
+#include <frc2/command/CommandBase.h>
+#include <frc2/command/CommandHelper.h>
+#include <frc2/command/ParallelRaceGroup.h>
+#include <units/time.h>
+
+// Finishes as soon as something is ready, or once the safety cap runs out.
+//
+// Autos should move on when the robot is ready rather than after a fixed
+// time.  The cap only guards against a condition that never comes true, so
+// hitting it is reported along with what was being waited for.
+class WaitForCommand : public frc2::CommandHelper<frc2::CommandBase, WaitForCommand> {
+    public:
+        WaitForCommand(std::string what, std::function<bool()> ready, units::second_t cap);
+
+        void Initialize();
+        void End(bool interrupted);
+        bool IsFinished();
+
+    private:
+        std::string m_What;
+        std::function<bool()> m_Ready;
+        units::second_t m_Cap;
+
+        frc2::Timer m_Timer;
+};
+
+// Runs command until it finishes, ready() is true, or the cap runs out.
+// For commands like driving that never finish on their own.
+template <class T>
+frc2::ParallelRaceGroup RunUntil (T&& command, std::string what, std::function<bool()> ready, units::second_t cap) {
+    return frc2::ParallelRaceGroup {
+        std::forward<T>(command),
+        WaitForCommand{std::move(what), std::move(ready), cap}
+    };
+}
@@ -13,10 +13,11 @@ class AutonomousRotateTurretCommand : public frc2::CommandHelper<frc2::CommandBa
         }
 
         void Initialize () {
+            m_Shooter->SetLimelightLight(true); // Camera can't see the target in the dark
             m_Shooter->SetTurretSpeed(16_rpm); // Rotate turret at 16 RPM
         }
         void End (bool interrupted) { m_Shooter->SetTurretSpeed(0_rpm); } // Stop turret on completion
-        bool IsFinished () { return false; } // End when target is detected
+        bool IsFinished () { return m_Shooter->HasTarget(); } // End when target is detected
 
     private:
         Shooter* m_Shooter;
@@ -31,6 +31,9 @@ class PickupCellsCommand : public frc2::CommandHelper<frc2::CommandBase, PickupC
         Intake* m_Intake;
         Pixycam* m_Pixy;
 
+        // Refilled every loop.
+        std::vector<PixyBlock> m_Blocks;
+
         PathARedDetector m_DetectorARed;
         PathABlueDetector m_DetectorABlue;
         PathBRedDetector m_DetectorBRed;
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+
+// Tracks where each power cell is between the intake and the flywheel.
+//
+// Positions are meters along the cell path, measured from the intake beam.
+// The conveyor carries cells up to the feeder beam, where the feeder wheels
+// take over and carry them to the exit beam at the flywheel.  Cells move at
+// the commanded motor speeds between beam breaks, can't pass each other, and
+// are snapped to a beam whenever it fires.
+class ConveyorModel {
+    public:
+        struct Configuration {
+            double feederPosition;      // feeder beam
+            double exitPosition;        // exit beam, at the flywheel
+            double cellDiameter;
+            double conveyorCellSpeed;   // m/s at full conveyor output
+            double feederCellSpeed;     // m/s at full feeder output
+        };
+
+        static constexpr int kMaxCells = 8;
+
+        explicit ConveyorModel(const Configuration &config);
+
+        // Forget everything and pack count cells back from the feeder.
+        void Reset(int count);
+
+        // Move cells for dt seconds at these percent outputs (+ is toward
+        // the flywheel).
+        void Update(double dt, double conveyorSpeed, double feederSpeed);
+
+        void OnIntakeEdge();
+        void OnFeederEdge();
+
+        // Removes the front cell, unless Update already dropped it past the
+        // exit.  Each cell leaves the count once, whichever sees it first.
+        void OnExitEdge();
+
+        int GetCount () { return m_Count; }
+
+        // Only once the exit beam has seen every cell out.  A cell Update
+        // dropped early may still be on its way to the flywheel.
+        bool IsEmpty () { return 0 == m_Count && 0 == m_UnseenExits; }
+
+        // A cell is in the feeder, ready to be fed to the flywheel.
+        bool IsCellStaged();
+
+        // Seconds until the next cell reaches the feeder beam at this conveyor
+        // output.  Zero if one is already there, negative if none are coming.
+        double GetTimeUntilStaged(double conveyorSpeed);
+
+        // Position of cell i, front (closest to the flywheel) first.
+        double GetPosition (int i) { return m_Positions[i]; }
+
+    private:
+        void Insert(double position);
+        void Remove(int i);
+
+        Configuration config;
+
+        // Sorted front first.
+        std::array<double, kMaxCells> m_Positions {};
+        int m_Count = 0;
+
+        // Cells Update dropped past the exit before the exit beam saw them.
+        // Their edges are still owed, and must not take another cell along.
+        int m_UnseenExits = 0;
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Xbox controller layout, as the Driver Station reports it.
+namespace Xbox {
+    enum Button {
+        kA = 1, kB, kX, kY,
+        kLeftBumper, kRightBumper,
+        kBack, kStart,
+        kLeftStick, kRightStick,
+    };
+
+    enum Axis {
+        kLeftX = 0, kLeftY,
+        kLeftTrigger, kRightTrigger,
+        kRightX, kRightY,
+    };
+}
+
+// Everything one controller reported in one loop.  Plain data, so it can be
+// copied around and written to a log as is.
+struct ControllerState {
+    static constexpr int kMaxAxes = 6;
+
+    std::array<float, kMaxAxes> axes {};
+    uint32_t buttons = 0;   // bit n-1 is button n
+    int16_t pov = -1;       // degrees, -1 when not pressed
+
+    bool GetButton (int button) const { return buttons & (1u << (button - 1)); }
+    double GetAxis (int axis) const { return axes[axis]; }
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include <frc2/command/Command.h>
+
+#include "input/InputSnapshot.h"
+
+// What each control does, as a table evaluated against the input snapshot
+// once per loop.  Bindings run in the order they were added.
+class InputBindings {
+    public:
+        using Condition = std::function<bool(const InputSnapshot&)>;
+        using Action = std::function<void()>;
+
+        // Runs action on the loop the condition becomes true.
+        void OnPress(Condition condition, Action action);
+
+        // Runs press when the condition becomes true and release when it
+        // becomes false again.
+        void OnPressRelease(Condition condition, Action press, Action release);
+
+        // Keeps command scheduled for as long as the condition is true, and
+        // cancels it once it isn't.  Re-schedules it if something else
+        // interrupted it while the condition was still true.
+        void WhileHeld(Condition condition, frc2::Command* command);
+
+        // Runs action every loop, for controls that are not just on or off.
+        void Always(std::function<void(const InputSnapshot&)> action);
+
+        void Evaluate(const InputSnapshot &input);
+
+    private:
+        struct Binding {
+            Condition condition;
+            Action press, release;
+            frc2::Command* command = nullptr;
+            std::function<void(const InputSnapshot&)> always;
+
+            bool active = false;
+        };
+
+        std::vector<Binding> m_Bindings;
+};
+
+namespace Input {
+    InputBindings::Condition Button(int port, int button);
+    InputBindings::Condition POV(int port, int angle);
+}
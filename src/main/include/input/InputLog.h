@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "input/ControllerState.h"
+#include "input/InputSnapshot.h"
+
+// Binary log of what the drivers did, one record per robot loop.
+//
+// A file is a Header followed by Records, all little endian as the roboRIO
+// and desktops write them.  Axes are stored the way the Driver Station sends
+// them, as a signed byte, so nothing is lost packing them.
+namespace InputLog {
+
+constexpr uint32_t kMagic = 0x4C495850; // "PXIL"
+constexpr uint16_t kVersion = 1;
+
+enum Mode : uint8_t {
+    kDisabled = 0,
+    kAutonomous,
+    kTeleop,
+    kTest,
+};
+
+struct Header {
+    uint32_t magic = kMagic;
+    uint16_t version = kVersion;
+    uint16_t controllers = InputSnapshot::kControllers;
+};
+
+struct Controller {
+    std::array<int8_t, ControllerState::kMaxAxes> axes;
+    int16_t pov;
+    uint32_t buttons;
+};
+
+struct Record {
+    uint32_t timeMs;    // since the log was started
+    uint8_t mode;
+    uint8_t reserved[3];
+    std::array<Controller, InputSnapshot::kControllers> controllers;
+};
+
+static_assert(sizeof(Header) == 8, "input log header must not be padded");
+static_assert(sizeof(Controller) == 12, "input log controller must not be padded");
+static_assert(sizeof(Record) == 8 + 12 * InputSnapshot::kControllers, "input log record must not be padded");
+
+Controller pack(const ControllerState &state);
+ControllerState unpack(const Controller &controller);
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include <hal/cpp/fpga_clock.h>
+
+#include "input/InputLog.h"
+#include "input/InputSnapshot.h"
+#include "util/SpscRing.h"
+
+// Writes every loop's controller state to a new log file in directory.
+//
+// Record only queues the loop's state.  A background thread does the file
+// writes, so a slow flash write never holds up the robot loop.
+class InputRecorder {
+    public:
+        explicit InputRecorder(std::string directory);
+        ~InputRecorder();
+
+        // Opens a new log.  Does nothing if one is already open.
+        void Start();
+
+        // Writes out what is queued and closes the log.
+        void Stop();
+
+        void Record(const InputSnapshot &input, InputLog::Mode mode);
+
+        // Touches the queue's pages so the first loops recorded don't page
+        // fault.  Only while stopped.
+        std::size_t Prefault();
+
+    private:
+        // About five seconds of loops.
+        using RecordQueue = SpscRing<InputLog::Record, 256>;
+
+        void WriterThread();
+        void Drain();
+
+        std::string m_Directory;
+
+        FILE* m_File = nullptr;
+        hal::fpga_clock::time_point m_StartTime;
+
+        RecordQueue m_Queue;
+        std::atomic<bool> m_Running {false};
+        std::thread m_Writer;
+
+        // Records dropped because the writer fell behind.
+        int m_Dropped = 0;
+};
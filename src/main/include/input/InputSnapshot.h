@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+
+#include "input/ControllerState.h"
+#include "input/InputSource.h"
+
+// One controller this loop, and what changed since the last one.
+//
+// Unlike XboxController::Get...Pressed, reading an edge doesn't consume it,
+// so any number of bindings can look at the same press.
+class ControllerSnapshot {
+    public:
+        void Update (const ControllerState &state) {
+            m_Previous = m_Current;
+            m_Current = state;
+        }
+
+        bool GetButton (int button) const { return m_Current.GetButton(button); }
+        bool GetButtonPressed (int button) const { return m_Current.GetButton(button) && !m_Previous.GetButton(button); }
+        bool GetButtonReleased (int button) const { return !m_Current.GetButton(button) && m_Previous.GetButton(button); }
+
+        double GetAxis (int axis) const { return m_Current.GetAxis(axis); }
+        int GetPOV () const { return m_Current.pov; }
+
+        const ControllerState& GetState () const { return m_Current; }
+
+    private:
+        ControllerState m_Current;
+        ControllerState m_Previous;
+};
+
+// Every controller, read once at the start of the loop.
+class InputSnapshot {
+    public:
+        static constexpr int kControllers = 3;
+
+        void Update (InputSource &source) {
+            source.NextLoop();
+
+            for (int port = 0; port < kControllers; port++) {
+                ControllerState state;
+                source.Read(port, state);
+                m_Controllers[port].Update(state);
+            }
+        }
+
+        const ControllerSnapshot& operator[] (int port) const { return m_Controllers[port]; }
+
+    private:
+        std::array<ControllerSnapshot, kControllers> m_Controllers;
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "input/ControllerState.h"
+
+// Where controller state comes from.  Normally the Driver Station, but
+// anything that can fill in a ControllerState will do.
+class InputSource {
+    public:
+        virtual ~InputSource() = default;
+
+        // Called once at the start of every loop, before any port is read.
+        virtual void NextLoop () {}
+
+        // Fills state with what the controller on port is doing now.
+        virtual void Read(int port, ControllerState &state) = 0;
+};
+
+class DriverStationInput : public InputSource {
+    public:
+        void Read(int port, ControllerState &state) override;
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "input/InputLog.h"
+#include "input/InputSource.h"
+
+// Plays an InputRecorder log back, one record per loop, regardless of the
+// time in the record.  Run it in simulation with stepped timing and the
+// robot code sees exactly what the drivers did, as fast as it can go.
+class ReplayInput : public InputSource {
+    public:
+        explicit ReplayInput(const std::string &path);
+
+        void NextLoop() override;
+        void Read(int port, ControllerState &state) override;
+
+        // Robot mode the drivers were in on this loop.
+        InputLog::Mode GetMode();
+
+        bool IsFinished () { return m_Index >= m_Records.size(); }
+        size_t GetLoopCount () { return m_Records.size(); }
+
+    private:
+        std::vector<InputLog::Record> m_Records;
+
+        // Record for the current loop.
+        size_t m_Index = 0;
+        bool m_Started = false;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+
+// Finds heap allocations in code that runs every loop.
+//
+// Build with ALLOCATION_TRACKING to replace the global operator new and
+// delete with ones that count allocations per thread.  Desktop builds (the
+// simulator, tests and benchmarks) have it on; robot builds don't.
+//
+// Put NO_ALLOC_REGION("Name") at the top of an Execute or Periodic, next to
+// its LOOP_TIMER.  Once the block has run kWarmUpRuns times, a run that
+// allocates is reported on stderr, or aborts the program if the environment
+// has ALLOCATION_TRACKING=fail.  Allocations in a nested region count
+// against that region only.
+//
+// Without ALLOCATION_TRACKING, regions compile out and GetCount is zero.
+
+namespace AllocationTracking {
+    // Allocations made by this thread so far.
+    uint64_t GetCount();
+}
+
+// One NO_ALLOC_REGION.  Only used from one thread at a time.
+class AllocationSite {
+    public:
+        static constexpr uint32_t kWarmUpRuns = 50;
+
+        explicit AllocationSite (const char* name) : m_Name(name) {}
+
+        void Record(uint64_t allocations);
+
+    private:
+        const char* m_Name;
+        uint32_t m_Runs = 0;
+        uint32_t m_AllocatingRuns = 0;
+};
+
+class NoAllocRegion {
+    public:
+        explicit NoAllocRegion(AllocationSite &site);
+        ~NoAllocRegion();
+
+    private:
+        AllocationSite &m_Site;
+        uint64_t m_Start;
+        uint64_t m_NestedStart;
+};
+
+#ifdef ALLOCATION_TRACKING
+#define NO_ALLOC_REGION_CONCAT2(a, b) a##b
+#define NO_ALLOC_REGION_CONCAT(a, b) NO_ALLOC_REGION_CONCAT2(a, b)
+#define NO_ALLOC_REGION(name) \
+    static AllocationSite NO_ALLOC_REGION_CONCAT(allocationSite_, __LINE__) {name}; \
+    NoAllocRegion NO_ALLOC_REGION_CONCAT(noAllocRegion_, __LINE__) {NO_ALLOC_REGION_CONCAT(allocationSite_, __LINE__)}
+#else
+#define NO_ALLOC_REGION(name)
+#endif
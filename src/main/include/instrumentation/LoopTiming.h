@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include <networktables/NetworkTableEntry.h>
+
+// Where the 20 ms loop goes.
+//
+// Put LOOP_TIMER("Name") at the top of a Periodic, Execute or any other
+// block.  Every run of the block lands in a fixed bucket histogram, and once
+// a second LoopTiming::Publish() sends p50, p99 and max (in ms) for each one
+// to the "Timing" network table, then starts a fresh window.
+//
+// A timed block costs two steady_clock reads and a few integer operations.
+// Build with DISABLE_LOOP_TIMING to compile it out completely.
+
+class TimingHistogram {
+    public:
+        explicit TimingHistogram(std::string name);
+
+        void Record(std::chrono::nanoseconds duration);
+
+        // Microseconds under which this fraction of the window's samples fell.
+        double GetPercentile(double fraction);
+        double GetMax () { return m_MaxMicros; }
+
+        void Publish();
+        void Reset();
+
+    private:
+        // Four buckets per power of two microseconds, up to ~65 ms.
+        static constexpr int kBucketsPerOctave = 4;
+        static constexpr int kBuckets = 16 * kBucketsPerOctave;
+
+        static int Bucket(uint32_t micros);
+        static double BucketLimit(int bucket);
+
+        std::string m_Name;
+
+        std::array<uint32_t, kBuckets> m_Counts {};
+        uint32_t m_Total = 0;
+        double m_MaxMicros = 0;
+
+        bool m_EntriesResolved = false;
+        nt::NetworkTableEntry m_P50Entry, m_P99Entry, m_MaxEntry;
+};
+
+class ScopedTimer {
+    public:
+        explicit ScopedTimer (TimingHistogram &histogram)
+            : m_Histogram(histogram), m_Start(std::chrono::steady_clock::now()) {}
+
+        ~ScopedTimer () {
+            m_Histogram.Record(std::chrono::steady_clock::now() - m_Start);
+        }
+
+    private:
+        TimingHistogram &m_Histogram;
+        std::chrono::steady_clock::time_point m_Start;
+};
+
+namespace LoopTiming {
+    // Call once at the start of every robot loop.  Counts overruns of the
+    // 20 ms budget, and publishes everything once a second.
+    void StartLoop();
+
+    void Publish();
+}
+
+#ifdef DISABLE_LOOP_TIMING
+#define LOOP_TIMER(name)
+#else
+#define LOOP_TIMER_CONCAT2(a, b) a##b
+#define LOOP_TIMER_CONCAT(a, b) LOOP_TIMER_CONCAT2(a, b)
+#define LOOP_TIMER(name) \
+    static TimingHistogram LOOP_TIMER_CONCAT(loopTimerHistogram_, __LINE__) {name}; \
+    ScopedTimer LOOP_TIMER_CONCAT(loopTimer_, __LINE__) {LOOP_TIMER_CONCAT(loopTimerHistogram_, __LINE__)}
+#endif
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+
+// Estimates flywheel speed without the lag of the Spark MAX velocity filter.
+//
+// The model is the usual feedforward one, V = ks + kv*w + ka*dw/dt, plus a
+// load term that soaks up whatever the model misses.  A cell leaving the
+// flywheel shows up as a spike in that load.
+//
+// Two measurements correct the model every update:
+//  - back EMF speed, (V - I*R) * motorKv.  Noisy, but not delayed at all.
+//  - encoder speed.  Accurate, but filtered by the motor controller, so it is
+//    compared against the estimate from encoderLag seconds ago.
+//
+// Everything is wheel RPM and seconds.
+class FlywheelObserver {
+    public:
+        struct Configuration {
+            double ks, kv, ka;      // V, V per rpm, V per rpm/s
+            double resistance;      // ohms, of one motor
+            double motorKv;         // motor rpm per volt
+            double motorRatio;      // wheel rpm per motor rpm
+
+            double emfGain;         // 0..1, trust in back EMF speed
+            double encoderGain;     // 0..1, trust in encoder speed
+            double loadGain;        // 0..1, how fast the load estimate moves
+            double encoderLag;      // seconds
+
+            double dipLoad;         // rpm/s of load that means a cell is leaving
+        };
+
+        explicit FlywheelObserver(const Configuration &config);
+
+        void Reset(double speed = 0);
+        void Update(double dt, double voltage, double current, double encoderSpeed);
+
+        double GetSpeed () { return m_Speed; }
+        double GetLoad () { return m_Load; }
+
+        // Number of cells seen leaving the flywheel since the last reset.
+        int GetShotCount () { return m_ShotCount; }
+
+        // True from the start of a dip until the load drops back off.
+        bool IsRecovering () { return m_Recovering; }
+
+        // Seconds until the flywheel reaches target with the motors at
+        // voltage, or a large number if it never will.
+        double PredictRecoveryTime(double target, double voltage);
+
+    private:
+        static constexpr int kHistorySize = 16;
+
+        Configuration config;
+
+        double m_Speed = 0;
+        double m_Load = 0;
+
+        int m_ShotCount = 0;
+        bool m_Recovering = false;
+
+        // Past estimates, for comparing against the lagging encoder.
+        std::array<double, kHistorySize> m_History {};
+        int m_HistoryHead = 0;
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+namespace Lead {
+
+// Everything is measured in the robot frame, in meters, seconds and radians.
+// Angles are counter-clockwise positive, zero is the robot's front.
+struct Solution {
+    double aimOffset;       // rotate the shot this far CCW from the line of sight
+    double effectiveRange;  // range a stationary robot would shoot for the same flight
+    double flightTime;
+};
+
+// Find where to aim so that the robot's own velocity, which the cell inherits
+// when it leaves the flywheel, carries the cell onto the target.
+//
+// range      - horizontal distance from the shooter to the target
+// bearing    - direction of the target, relative to the robot's front
+// robotSpeed - forward speed of the robot (differential drive has no sideways speed)
+// ballSpeed  - horizontal exit speed of a cell from a stationary robot
+Solution solve(double range, double bearing, double robotSpeed, double ballSpeed);
+
+}
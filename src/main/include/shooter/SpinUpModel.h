@@ -0,0 +1,30 @@
+#pragma once
+
+#include <array>
+
+// Learns how long the flywheel really takes to spin up to each target speed.
+//
+// FlywheelObserver predicts spin-up time from the feedforward model as if the
+// motors ran at full voltage.  The velocity PID never does that, and how far
+// off it is depends on the target, so each band of target speeds keeps its
+// own correction: the ratio of measured to predicted time.
+class SpinUpModel {
+    public:
+        SpinUpModel () { m_Factor.fill(1.0); }
+
+        // Seconds to reach target, given the model's prediction.
+        double Predict(double target, double modelTime);
+
+        // Record one spin-up to target that took actualTime, when the model
+        // said modelTime.
+        void Learn(double target, double modelTime, double actualTime);
+
+    private:
+        static constexpr int kBuckets = 24;
+        static constexpr double kBucketWidth = 250.0; // rpm
+
+        static int Bucket(double target);
+
+        std::array<double, kBuckets> m_Factor;
+        std::array<int, kBuckets> m_Samples {};
+};
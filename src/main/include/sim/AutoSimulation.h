@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <frc/geometry/Pose2d.h>
+#include <frc2/command/Command.h>
+
+#include "commands/FollowPolybezier.h"
+
+class RobotContainer;
+
+// Runs autonomous routines back to back in desktop simulation, stepping the
+// clock a loop at a time so they finish much faster than real time, and
+// reports how each one went.
+//
+// Set AUTO_SIM to "all", "paths" for just following each deployed path, or
+// a comma separated list of routine names.  Or run
+// ./gradlew simulateAutos -PautoSim=...
+//
+// Loop cost is the robot thread's CPU time per loop, so it doesn't count
+// time spent waiting for the clock to be stepped.
+class AutoSimulation {
+    public:
+        AutoSimulation(RobotContainer &container, const std::string &routines);
+
+        // Call once a loop from SimulationPeriodic.  Returns false once every
+        // routine has run.
+        bool Periodic();
+
+    private:
+        struct Result {
+            std::string name;
+            double matchTime;
+            bool finished;
+            int pickedUp, shot;
+            FollowPolybezier::TrackingStats tracking;
+            double drift;               // odometry from the true travel, m
+            int loops;
+            double loopTotal, loopMax;  // CPU time, seconds
+            double wallTime;
+        };
+
+        void Start();
+        void Finish(bool finished);
+
+        // Poses from the last loop before the robot moved, to measure drift
+        // from.
+        void TrackStart();
+        double MeasureDrift();
+        void Report(const Result &result);
+
+        RobotContainer &m_Container;
+
+        std::vector<std::string> m_Routines;
+        size_t m_Current = 0;
+
+        // Disabled loops before each routine, to settle and build it.
+        int m_DisabledLoops = 0;
+        bool m_Running = false;
+
+        frc2::Command* m_Command = nullptr;
+        bool m_Scheduled = false;
+        double m_StartTime = 0;
+
+        bool m_Started = false, m_Moved = false;
+        frc::Pose2d m_OdometryStart, m_TrueStart;
+
+        Result m_Result;
+        double m_LastLoop;
+        std::chrono::steady_clock::time_point m_RoutineStart;
+        std::chrono::steady_clock::time_point m_Begin = std::chrono::steady_clock::now();
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+
+#include <cpptoml.h>
+#include <frc/geometry/Pose2d.h>
+#include <frc/geometry/Translation2d.h>
+#include <frc/simulation/DIOSim.h>
+
+#include "Constants.h"
+#include "conveyor/ConveyorModel.h"
+#include "sim/ShooterPlant.h"
+#include "subsystems/Intake.h"
+
+// Power cells on the field and in the robot, in simulation.
+//
+// Cells in the robot are moved along the cell path by their own
+// ConveyorModel, which is the truth here rather than an estimate, and break
+// the intake, feeder and exit beams as they pass them.  A cell on the field
+// is picked up when the extended intake is running and drives over it.
+class CellPlant {
+    public:
+        // Uses the [conveyor] table, like PowerCellCounter.
+        CellPlant(std::shared_ptr<cpptoml::table> toml, std::vector<frc::Translation2d> field);
+
+        void Update(double dt, const frc::Pose2d &pose, Intake* intake, ShooterPlant* shooter);
+
+        // Every field cell back in place, and count cells in the robot.
+        void Reset(int count);
+
+        int GetCount () { return m_Cells.GetCount(); }
+        int GetPickedUp () { return m_PickedUp; }
+        int GetShot () { return m_Shot; }
+
+    private:
+        bool IsBeamBroken(double position);
+        void UpdateBeams();
+
+        ConveyorModel::Configuration config;
+        ConveyorModel m_Cells;
+
+        std::vector<frc::Translation2d> m_Field;
+        std::vector<bool> m_OnField;
+
+        int m_PickedUp = 0;
+        int m_Shot = 0;
+
+        frc::sim::DIOSim m_InBeam {kBeamPowerCellIn};
+        frc::sim::DIOSim m_OutBeam {kBeamPowerCellOut};
+        frc::sim::DIOSim m_FeederBeam {kBeamPowerCellFeeder};
+};
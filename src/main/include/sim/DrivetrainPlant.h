@@ -0,0 +1,88 @@
+#pragma once
+
+#include <random>
+
+#include <cpptoml.h>
+#include <frc/geometry/Pose2d.h>
+
+#include "sim/Plant.h"
+#include "subsystems/DrivetrainIO.h"
+
+// The drivetrain in simulation, driven by the same feedforward model
+// Drivetrain uses to pick its voltages.
+//
+// Each side follows V = ks + kv*v + ka*a on its own, and the robot yaws by
+// the difference in wheel speeds over the track width.  By default the track
+// width is the one that makes Drivetrain's kw exact, 2*kw/kv.
+//
+// Sensors can be given noise: wheel slip that odometry doesn't know about,
+// jitter on the encoder velocities, and gyro noise and drift.  It is seeded,
+// so a run with noise is as repeatable as one without.
+class DrivetrainPlant : public DrivetrainIO, public Plant {
+    public:
+        // Uses the [drivetrain] table from config.toml, like Drivetrain, and
+        // the one from sim.toml, if any, for the track width and noise.
+        DrivetrainPlant(std::shared_ptr<cpptoml::table> toml, std::shared_ptr<cpptoml::table> sim);
+
+        void Set(double left, double right) override;
+        void SetBrake(bool on) override;
+
+        double GetLeftPosition() override;
+        double GetRightPosition() override;
+        void ResetPosition() override;
+
+        double GetLeftVelocity() override;
+        double GetRightVelocity() override;
+
+        double GetLeftBusVoltage () override { return kBusVoltage; }
+        double GetRightBusVoltage () override { return kBusVoltage; }
+
+        double GetOutputCurrent() override;
+
+        units::degree_t GetGyroAngle() override;
+
+        // Where the robot really is, counter-clockwise positive like odometry.
+        frc::Pose2d GetTruePose();
+
+        // Stopped at pose, with the encoders and gyro zeroed and the noise
+        // restarted from its seed.
+        void Reset(frc::Pose2d pose = frc::Pose2d{});
+
+    protected:
+        void Step(double dt) override;
+
+    private:
+        static constexpr double kBusVoltage = 12.0;
+
+        // New speed for one side after dt seconds at this voltage.
+        double StepSide(double speed, double voltage, double dt);
+
+        double Noise(double deviation);
+
+        struct {
+            double ks, kv, ka;
+            double trackWidth;
+
+            struct {
+                double slip;        // fraction of wheel travel, per step
+                double velocity;    // m/s
+                double gyro;        // degrees
+                double gyroDrift;   // degrees per second
+                unsigned int seed;
+            } noise;
+        } config;
+
+        std::mt19937 m_Random;
+
+        double m_Left = 0, m_Right = 0;
+        bool m_Brake = true;
+
+        double m_X = 0, m_Y = 0, m_Heading = 0;
+        double m_LeftSpeed = 0, m_RightSpeed = 0;
+
+        // Measured wheel travel since the encoders were last zeroed, and gyro
+        // drift since the gyro was.
+        double m_LeftPosition = 0, m_RightPosition = 0;
+        double m_GyroZero = 0;
+        double m_GyroDrift = 0;
+};
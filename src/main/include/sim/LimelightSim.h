@@ -0,0 +1,31 @@
+#pragma once
+
+#include <memory>
+
+#include <cpptoml.h>
+#include <frc/geometry/Pose2d.h>
+#include <frc/geometry/Translation2d.h>
+#include <networktables/NetworkTable.h>
+#include <units/angle.h>
+
+// Stands in for the Limelight on the turret, publishing tv, tx and ty for
+// the target as the real camera would.  It only sees the target with its
+// light on.
+class LimelightSim {
+    public:
+        // Uses the vision settings from the [shooter] table.  turretZero is
+        // where the turret points at zero ticks, clockwise from the front.
+        LimelightSim(std::shared_ptr<cpptoml::table> toml, frc::Translation2d target, units::degree_t turretZero);
+
+        void Update(const frc::Pose2d &pose, units::degree_t turretAngle);
+
+    private:
+        std::shared_ptr<nt::NetworkTable> m_Table;
+
+        frc::Translation2d m_Target;
+        units::degree_t m_TurretZero;
+
+        struct {
+            double cameraHeight, cameraPitch, targetHeight;
+        } config;
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+// Simulated hardware.  Its state is moved forward to the current simulation
+// time whenever it is read or commanded, in small fixed steps, so it stays
+// accurate whatever rate the code polls it at.
+class Plant {
+    public:
+        virtual ~Plant() = default;
+
+        // Step up to now.  Called by every getter and setter.
+        void Advance();
+
+        // Start over from rest at the current time.
+        void Restart();
+
+    protected:
+        virtual void Step(double dt) = 0;
+
+    private:
+        double m_Time = -1.0;
+};
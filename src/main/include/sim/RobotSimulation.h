@@ -0,0 +1,53 @@
+#pragma once
+
+#include <memory>
+
+#include <cpptoml.h>
+
+#include "sim/CellPlant.h"
+#include "sim/DrivetrainPlant.h"
+#include "sim/LimelightSim.h"
+#include "sim/ShooterPlant.h"
+#include "subsystems/Intake.h"
+
+// Everything the robot code talks to in desktop simulation, and the field
+// around it.  RobotContainer gives the drivetrain and shooter plants to its
+// subsystems in place of their hardware.
+//
+// The field is read from sim.toml, in meters from where the robot starts
+// facing +x.
+class RobotSimulation {
+    public:
+        // robot is the whole config.toml, for the settings the plants share
+        // with the subsystems.
+        RobotSimulation(std::shared_ptr<cpptoml::table> robot, std::shared_ptr<cpptoml::table> field);
+
+        DrivetrainPlant* GetDrivetrain () { return &m_Drivetrain; }
+        ShooterPlant* GetShooter () { return &m_Shooter; }
+
+        // The intake's rollers and solenoids aren't simulated, so cells are
+        // picked up from what it was last told to do.
+        void SetIntake (Intake* intake) { m_Intake = intake; }
+
+        // Back to the start of a match: robot at the origin, cells preloaded
+        // and the rest back on the field.
+        void Reset();
+
+        // Call once a loop, after the robot code has run.
+        void Update();
+
+        int GetPreloadedCells () { return m_PreloadedCells; }
+        int GetCellsPickedUp () { return m_Cells->GetPickedUp(); }
+        int GetCellsShot () { return m_Cells->GetShot(); }
+
+    private:
+        DrivetrainPlant m_Drivetrain;
+        ShooterPlant m_Shooter;
+        std::unique_ptr<CellPlant> m_Cells;
+        std::unique_ptr<LimelightSim> m_Limelight;
+
+        Intake* m_Intake = nullptr;
+
+        int m_PreloadedCells;
+        double m_Time = -1.0;
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cpptoml.h>
+#include <units/angle.h>
+
+#include "sim/Plant.h"
+#include "subsystems/ShooterIO.h"
+
+// The flywheel and turret in simulation.
+//
+// The flywheel follows the same model as FlywheelObserver, with the Spark
+// MAX velocity loop run on top of it, and loses speed to every cell shot.
+// The turret just lags behind the speed it's given.
+class ShooterPlant : public ShooterIO, public Plant {
+    public:
+        // Uses the [shooter] table, like Shooter.
+        explicit ShooterPlant(std::shared_ptr<cpptoml::table> toml);
+
+        void ConfigureFlywheel(const Gains &gains) override;
+        void ConfigureTurret (const Gains &gains) override {}
+
+        void SetFlywheelVelocity(double motorRpm) override;
+        void StopFlywheel() override;
+
+        double GetFlywheelVelocity() override;
+        double GetFollowerVelocity () override { return GetFlywheelVelocity(); }
+
+        double GetFlywheelAppliedOutput() override;
+        double GetFlywheelBusVoltage () override { return kBusVoltage; }
+        double GetFlywheelCurrent() override;
+
+        void SetTurretVelocity(double ticksPer100ms) override;
+        void StopTurret() override;
+
+        double GetTurretPosition() override;
+
+        // Clockwise positive, from where it started.
+        units::degree_t GetTurretAngle();
+
+        // Flywheel speed, in wheel rpm.
+        double GetWheelSpeed();
+
+        // A cell has gone through the flywheel.
+        void OnShot();
+
+        void Reset();
+
+    protected:
+        void Step(double dt) override;
+
+    private:
+        static constexpr double kBusVoltage = 12.0;
+
+        struct {
+            double ks, kv, ka;
+            double resistance, motorKv;
+        } config;
+
+        Gains m_Gains {0, 0, 0, 0};
+
+        // Motor rpm, zero when stopped.
+        double m_Setpoint = 0;
+        double m_Integral = 0;
+        double m_LastError = 0;
+        double m_Output = 0;
+
+        double m_WheelSpeed = 0;
+
+        double m_TurretSetpoint = 0;    // ticks per 100 ms
+        double m_TurretVelocity = 0;    // ticks per second
+        double m_TurretPosition = 0;    // ticks
+};
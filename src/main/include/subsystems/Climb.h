@@ -1,6 +1,5 @@
 #pragma once
 
-#include <frc2/command/SubsystemBase.h>
 #include <ctre/phoenix/motorcontrol/can/TalonSRX.h>
 #include <frc/Relay.h>
 #include <frc/Solenoid.h>
@@ -8,11 +7,13 @@
 #include <rev/CANSparkMax.h>
 
 #include "Constants.h"
+#include "subsystems/MultiRateSubsystem.h"
+#include "util/Telemetry.h"
 
-class Climb : public frc2::SubsystemBase {
+class Climb : public MultiRateSubsystem {
     public:
         Climb();
-        void Periodic() override;
+        void RatePeriodic() override;
 
         void PistonExtend();
         void PistonRetract();
@@ -61,5 +62,10 @@ class Climb : public frc2::SubsystemBase {
         frc::Solenoid m_BrakeUnlockSolenoid {ClimbPins::kBrakeUnlockSolenoid};
 
         rev::CANSparkMax m_ClimbRoller {ClimbPins::kClimbRollerMotor, rev::CANSparkMax::MotorType::kBrushless};
+
+        struct {
+            TelemetryBoolean winchLocked {"Winch Locked"};
+            TelemetryBoolean pistonOut {"Climb Piston Out"};
+        } m_Telemetry;
 };
 
@@ -1,40 +1,51 @@
 #pragma once
 
-#include <AHRS.h>
+#include <cstdint>
+#include <memory>
+
 #include <cpptoml.h>
-#include <frc2/command/SubsystemBase.h>
-#include <frc/SpeedControllerGroup.h>
+#include <frc/Notifier.h>
 #include <frc/kinematics/DifferentialDriveOdometry.h>
-#include <rev/CANSparkMax.h>
+#include <frc2/command/SubsystemBase.h>
 #include <units/length.h>
 #include <units/current.h>
+#include <units/time.h>
 
 #include "Constants.h"
-
+#include "subsystems/DrivetrainIO.h"
+#include "util/Mailbox.h"
+
+// Odometry, velocity and heading correction, and motor output run in their
+// own control loop, faster than the robot loop (controlRate, 100 to 200 Hz).
+// On the robot that's a Notifier thread; in simulation it runs between robot
+// loops on the main thread, so the simulated hardware is only ever touched
+// from one thread.
+//
+// Commands never touch the loop's state.  Setters update a setpoint that is
+// handed over through a Mailbox, and GetPose and friends read what the loop
+// last published.
 class Drivetrain : public frc2::SubsystemBase {
     public:
-        Drivetrain(std::shared_ptr<cpptoml::table> toml);
-
-        void Periodic() override;
+        Drivetrain(std::shared_ptr<cpptoml::table> toml, DrivetrainIO* io);
 
         void Drive(double yInput, double xInput);
         void RadiusDrive(double speed, double radius);
 
         void SetBrake(bool on);
 
-        void SetAcceleration (double a) { SetDrivingMode(false); acceleration = a; }
-        void SetAcceleration (double a, double target) { SetDrivingMode(false); acceleration = a; targetSpeed = target; }
-        void SetAngularVelocity (double w) { SetDrivingMode(false); angularVelocity = w; }
-        void SetAngularVelocity (double w, double target) { SetDrivingMode(false); angularVelocity = w; targetAngle = target; }
+        void SetAcceleration (double a) { SetDrivingMode(false); setpoint.acceleration = a; Send(); }
+        void SetAcceleration (double a, double target) { SetDrivingMode(false); setpoint.acceleration = a; setpoint.targetSpeed = target; Send(); }
+        void SetAngularVelocity (double w) { SetDrivingMode(false); setpoint.angularVelocity = w; Send(); }
+        void SetAngularVelocity (double w, double target) { SetDrivingMode(false); setpoint.angularVelocity = w; setpoint.targetAngle = target; Send(); }
 
-        frc::Pose2d GetPose () { return odometry.GetPose(); }
+        frc::Pose2d GetPose();
         void SetPose(double x, double y, double angle = 0);
         void ResetPose (double angle = 0) { SetPose(0, 0, angle); }
 
-        double GetSpeed () { return (leftLeader.GetEncoder().GetVelocity() + rightLeader.GetEncoder().GetVelocity()) / 2.0; }
+        double GetSpeed () { return status.Read().speed; }
 
-        double GetVoltage () { return (leftLeader.GetBusVoltage() + rightLeader.GetBusVoltage()) / 2.0; }
-        double GetMaxAvailableAcceleration () { return (GetVoltage() - voltageUsedWithoutAcceleration) / config.kinematics.ka; }
+        double GetVoltage () { return (io->GetLeftBusVoltage() + io->GetRightBusVoltage()) / 2.0; }
+        double GetMaxAvailableAcceleration () { return (GetVoltage() - status.Read().voltageUsedWithoutAcceleration) / config.kinematics.ka; }
 
         double GetKS () { return config.kinematics.ks; }
         double GetKV () { return config.kinematics.kv; }
@@ -42,49 +53,80 @@ class Drivetrain : public frc2::SubsystemBase {
         double GetKW () { return config.kinematics.kw; }
 
         units::current::ampere_t GetMotorCurrent () {
-            return units::current::ampere_t{(leftLeader.GetOutputCurrent() + rightLeader.GetOutputCurrent()) / 2.0};
+            return units::current::ampere_t{io->GetOutputCurrent()};
         }
 
     private:
+        // What commands want.  Written by the main thread only.
+        struct Setpoint {
+            // Counts changes, so the loop can tell a new setpoint from an old
+            // one it has stopped following.
+            uint32_t sequence = 0;
+
+            // Brake defaults to on
+            bool brakeOn = true;
+            bool oldDriving = true;
+
+            // Fractions of bus voltage, for old driving.
+            double left = 0;
+            double right = 0;
+
+            double acceleration = 0;
+            double angularVelocity = 0;
+            double targetSpeed = 0;
+            double targetAngle = 0;
+
+            // Pose to reset odometry to, whenever poseSequence changes.
+            uint32_t poseSequence = 0;
+            double poseX = 0, poseY = 0, poseAngle = 0;
+        };
+
+        // What the loop last measured.  Written by the control loop only.
+        struct Status {
+            double x = 0, y = 0, angle = 0;
+            double speed = 0;
+            double voltageUsedWithoutAcceleration = 0;
+
+            // The last pose reset applied.
+            uint32_t poseSequence = 0;
+        };
+
+        void Send () { setpoint.sequence++; setpoints.Write(setpoint); }
+
+        // The control loop and everything it calls.
+        void ControlPeriodic();
+        void ApplyBrake(bool on);
         void UpdateOdometry();
-        void UpdateVoltages();
+        void UpdateVoltages(const Setpoint &target);
+
+        double GetLinearVoltage(const Setpoint &target, double speed);
+        double GetRotationalVoltage(const Setpoint &target);
+        double GetAccelerationCorrection(const Setpoint &target, double speed);
+        double GetRotationalCorrection(const Setpoint &target);
 
-        double GetLinearVoltage();
-        double GetRotationalVoltage();
-        double GetAccelerationCorrection(double speed);
-        double GetRotationalCorrection();
+        void SetDrivingMode (bool old) { setpoint.brakeOn = false; setpoint.oldDriving = old; }
 
-        void SetDrivingMode (bool old) { SetBrake(false); oldDriving = old; }
-        
         struct {
             struct {
                 double ks, kv, ka, kw;
             } kinematics;
-        } config;
 
-        bool brakeOn;
-        bool oldDriving = true;
+            units::second_t controlPeriod;
+        } config;
 
-        double acceleration = 0;
-        double angularVelocity = 0;
-        double targetSpeed = 0;
-        double targetAngle = 0;
+        DrivetrainIO* io;
 
-        double gyroZeroAngle;
+        Setpoint setpoint;
+        Mailbox<Setpoint> setpoints;
+        Mailbox<Status> status;
 
+        // Control loop state.
+        frc::DifferentialDriveOdometry odometry {frc::Rotation2d{}};
+        bool brakeApplied = false;
+        uint32_t poseSequence = 0;
+        uint32_t stoppedSequence = UINT32_MAX;
         double voltageUsedWithoutAcceleration = 0;
 
-        rev::CANSparkMax leftLeader {DriveMotorPins::Left1, rev::CANSparkMax::MotorType::kBrushless};
-        rev::CANSparkMax leftFollower1 {DriveMotorPins::Left2, rev::CANSparkMax::MotorType::kBrushless};
-        rev::CANSparkMax leftFollower2 {DriveMotorPins::Left3, rev::CANSparkMax::MotorType::kBrushless};
-        rev::CANSparkMax rightLeader {DriveMotorPins::Right1, rev::CANSparkMax::MotorType::kBrushless};
-        rev::CANSparkMax rightFollower1 {DriveMotorPins::Right2, rev::CANSparkMax::MotorType::kBrushless};
-        rev::CANSparkMax rightFollower2 {DriveMotorPins::Right3, rev::CANSparkMax::MotorType::kBrushless};
-
-        frc::SpeedControllerGroup leftGroup {leftLeader, leftFollower1, leftFollower2};
-        frc::SpeedControllerGroup rightGroup {rightLeader, rightFollower1, rightFollower2};
-
-        AHRS gyro {frc::SPI::Port::kMXP};
-
-        frc::DifferentialDriveOdometry odometry {gyro.GetRotation2d()};
+        // Last, so the loop stops before anything it uses is destroyed.
+        std::unique_ptr<frc::Notifier> notifier;
 };
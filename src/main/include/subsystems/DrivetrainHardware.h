@@ -0,0 +1,49 @@
+#pragma once
+
+#ifdef __FRC_ROBORIO__
+#include <AHRS.h>
+#endif
+#include <frc/SpeedControllerGroup.h>
+#include <rev/CANSparkMax.h>
+
+#include "Constants.h"
+#include "subsystems/DrivetrainIO.h"
+
+// Spark MAXes and the navX.  The navX library only exists for the roboRIO, so
+// off the robot the gyro reads zero.
+class DrivetrainHardware : public DrivetrainIO {
+    public:
+        DrivetrainHardware();
+
+        void Set(double left, double right) override;
+        void SetBrake(bool on) override;
+
+        double GetLeftPosition () override { return leftLeader.GetEncoder().GetPosition(); }
+        double GetRightPosition () override { return rightLeader.GetEncoder().GetPosition(); }
+        void ResetPosition() override;
+
+        double GetLeftVelocity () override { return leftLeader.GetEncoder().GetVelocity(); }
+        double GetRightVelocity () override { return rightLeader.GetEncoder().GetVelocity(); }
+
+        double GetLeftBusVoltage () override { return leftLeader.GetBusVoltage(); }
+        double GetRightBusVoltage () override { return rightLeader.GetBusVoltage(); }
+
+        double GetOutputCurrent () override { return (leftLeader.GetOutputCurrent() + rightLeader.GetOutputCurrent()) / 2.0; }
+
+        units::degree_t GetGyroAngle() override;
+
+    private:
+        rev::CANSparkMax leftLeader {DriveMotorPins::Left1, rev::CANSparkMax::MotorType::kBrushless};
+        rev::CANSparkMax leftFollower1 {DriveMotorPins::Left2, rev::CANSparkMax::MotorType::kBrushless};
+        rev::CANSparkMax leftFollower2 {DriveMotorPins::Left3, rev::CANSparkMax::MotorType::kBrushless};
+        rev::CANSparkMax rightLeader {DriveMotorPins::Right1, rev::CANSparkMax::MotorType::kBrushless};
+        rev::CANSparkMax rightFollower1 {DriveMotorPins::Right2, rev::CANSparkMax::MotorType::kBrushless};
+        rev::CANSparkMax rightFollower2 {DriveMotorPins::Right3, rev::CANSparkMax::MotorType::kBrushless};
+
+        frc::SpeedControllerGroup leftGroup {leftLeader, leftFollower1, leftFollower2};
+        frc::SpeedControllerGroup rightGroup {rightLeader, rightFollower1, rightFollower2};
+
+#ifdef __FRC_ROBORIO__
+        AHRS gyro {frc::SPI::Port::kMXP};
+#endif
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <units/angle.h>
+
+// The drivetrain's motors, encoders and gyro.  DrivetrainHardware on the
+// robot, a physics model in simulation.
+//
+// Distances are meters and speeds meters per second, of the wheels.
+class DrivetrainIO {
+    public:
+        virtual ~DrivetrainIO() = default;
+
+        // Fractions of bus voltage, positive forward on both sides.
+        virtual void Set(double left, double right) = 0;
+        virtual void SetBrake(bool on) = 0;
+
+        virtual double GetLeftPosition() = 0;
+        virtual double GetRightPosition() = 0;
+        virtual void ResetPosition() = 0;
+
+        virtual double GetLeftVelocity() = 0;
+        virtual double GetRightVelocity() = 0;
+
+        virtual double GetLeftBusVoltage() = 0;
+        virtual double GetRightBusVoltage() = 0;
+
+        // Average of one motor on each side, amps.
+        virtual double GetOutputCurrent() = 0;
+
+        // Clockwise positive, like the navX.
+        virtual units::degree_t GetGyroAngle() = 0;
+};
@@ -36,6 +36,13 @@ class Intake : public frc2::SubsystemBase {
         bool IsExtended();
         bool IsPowerCellInFeeder();
 
+        // Last commanded percent output, negative pulls cells in.
+        double GetIntakeSpeed () { return m_IntakeSpeed; }
+
+        // Last commanded percent outputs, positive toward the flywheel.
+        double GetConveyorSpeed () { return m_ConveyorSpeed; }
+        double GetFeederSpeed () { return m_FeederSpeed; }
+
     private:
         void SetFeederSpeed (double percentSpeed);
 
@@ -50,6 +57,10 @@ class Intake : public frc2::SubsystemBase {
 
         bool m_IsExtended = false;
 
+        double m_IntakeSpeed = 0.0;
+        double m_ConveyorSpeed = 0.0;
+        double m_FeederSpeed = 0.0;
+
         struct {
             struct {
                 double load, shoot, reverse;
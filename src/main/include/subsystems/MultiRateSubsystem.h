@@ -0,0 +1,24 @@
+#pragma once
+
+#include <frc2/command/SubsystemBase.h>
+#include <units/time.h>
+
+// A subsystem whose periodic work runs at its own rate rather than every
+// robot loop.  Override RatePeriodic instead of Periodic.
+//
+// Pick the slowest period that does the job: 100 ms for dashboard-only work,
+// 20 ms for mechanism control, 10 ms for fast feedback.  The drivetrain has a
+// control loop of its own.
+class MultiRateSubsystem : public frc2::SubsystemBase {
+    public:
+        explicit MultiRateSubsystem(units::second_t period);
+
+        void Periodic () final {}
+
+        virtual void RatePeriodic() = 0;
+
+        units::second_t GetPeriod () { return m_Period; }
+
+    private:
+        units::second_t m_Period;
+};
@@ -17,6 +17,9 @@ class Pixycam : public frc2::SubsystemBase {
 
         std::vector<PixyBlock> GetBlocks();
 
+        // Replaces the contents of blocks, reusing its storage.
+        void GetBlocks(std::vector<PixyBlock> &blocks);
+
     private:
         frc::SPI m_Spi{kPixycamSpi};
 
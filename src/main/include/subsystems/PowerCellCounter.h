@@ -1,38 +1,83 @@
 #pragma once
 
+#include <atomic>
+
+#include <cpptoml.h>
+
 #include <frc2/command/SubsystemBase.h>
 #include <frc/DigitalInput.h>
 
 #include <hal/cpp/fpga_clock.h>
 
-#include <networktables/NetworkTable.h>
-
 #include "Constants.h"
+#include "conveyor/ConveyorModel.h"
+#include "subsystems/Intake.h"
+#include "util/SpscRing.h"
+#include "util/Telemetry.h"
 
 class PowerCellCounter : public frc2::SubsystemBase {
     public:
-        PowerCellCounter();
+        PowerCellCounter(Intake* intake, std::shared_ptr<cpptoml::table> toml);
 
         int GetCount();
 
         void SetCount(int count);
 
+        // From the conveyor model.
+        bool IsCellStaged();
+        bool IsHopperEmpty();
+        double GetTimeUntilStaged();
+
         void Periodic();
 
     private:
+        // Beam break edges, queued by the interrupt handlers and counted in
+        // Periodic.  One queue per sensor, since each handler has its own thread.
+        using EdgeQueue = SpscRing<hal::fpga_clock::time_point, 32>;
+
         void InitNetworkTables();
-        
+
+        void DashboardPeriodic();
+
+        // Queue the edges since the last loop, in place of the interrupt
+        // handlers.  Only in simulation.
+        void PollBeams();
+
+        int CountEdges(EdgeQueue &edges, hal::fpga_clock::time_point &lastEdge);
+
+        void ModelPeriodic(int cellsIn, int cellsOut);
+
         frc::DigitalInput m_PowerCellIn {kBeamPowerCellIn};
         frc::DigitalInput m_PowerCellOut {kBeamPowerCellOut};
 
         // All matches start with 3 power cells.
-        int m_Count = 3;
+        // Written by Periodic and the network tables listener thread.
+        std::atomic<int> m_Count {3};
+
+        // Set when the count is changed from outside, so the model is rebuilt.
+        std::atomic<bool> m_CountChanged {false};
+
+        Intake* m_Intake;
+
+        ConveyorModel* m_Model;
+        bool m_FeederBeamBroken = false;
+        hal::fpga_clock::time_point m_ModelTimestamp = hal::fpga_clock::now();
+
+        EdgeQueue m_PowerCellInEdges;
+        EdgeQueue m_PowerCellOutEdges;
+
+        // Edges dropped because a queue was full.
+        std::atomic<int> m_DroppedEdges {0};
 
-        bool m_PowerCellInActive = false;
-        bool m_PowerCellOutActive = false;
+        bool m_PollBeams = false;
+        bool m_PowerCellInBroken = false;
+        bool m_PowerCellOutBroken = false;
 
+        // Last edge that counted as a cell, for debouncing.
         hal::fpga_clock::time_point m_PowerCellInTimestamp;
         hal::fpga_clock::time_point m_PowerCellOutTimestamp;
 
-        std::shared_ptr<NetworkTable> m_Table;
+        struct {
+            TelemetryNumber cellCount {"cell count"};
+        } m_Telemetry;
 };
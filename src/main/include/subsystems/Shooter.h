@@ -1,27 +1,53 @@
 #pragma once
 
 #include <cpptoml.h>
+#include <units/angle.h>
 #include <units/angular_velocity.h>
+#include <units/length.h>
 
+#include <hal/cpp/fpga_clock.h>
 #include <frc/SpeedControllerGroup.h>
 #include <frc2/command/SubsystemBase.h>
 #include <frc/controller/PIDController.h>
-#include <rev/CANSparkMax.h>
-#include <ctre/phoenix/motorcontrol/can/TalonSRX.h>
 #include <networktables/NetworkTableInstance.h>
 
 #include "Constants.h"
+#include "subsystems/ShooterIO.h"
+#include "shooter/FlywheelObserver.h"
+#include "shooter/SpinUpModel.h"
+#include "util/Telemetry.h"
 
 enum class TrackingMode { Off, GyroTracking, CameraTracking, Auto };
 
 class Shooter : public frc2::SubsystemBase {
     public:
-        Shooter(std::shared_ptr<cpptoml::table> toml);
+        Shooter(std::shared_ptr<cpptoml::table> toml, ShooterIO* io);
         void Periodic() override;
 
         void SetShooterMotorSpeed(units::angular_velocity::revolutions_per_minute_t speed);
         units::angular_velocity::revolutions_per_minute_t GetShooterMotorSpeed();
 
+        // Observer estimate of flywheel speed.  Leads GetShooterMotorSpeed,
+        // which lags behind the encoder filter.
+        units::angular_velocity::revolutions_per_minute_t GetEstimatedShooterSpeed();
+
+        // Cells seen leaving the flywheel since the shooter was last stopped.
+        int GetShotCount();
+
+        // True once the flywheel will reach speed by the time a cell started
+        // now gets from the feeder to the flywheel.
+        bool IsReadyToFeed(units::angular_velocity::revolutions_per_minute_t speed);
+
+        // Predicted seconds until the flywheel is close enough to speed to
+        // shoot, using what was learned from earlier spin-ups.
+        double GetTimeUntilReady(units::angular_velocity::revolutions_per_minute_t speed);
+
+        // Speed to hold between volleys while cells are loaded.
+        units::angular_velocity::revolutions_per_minute_t GetIdleSpeed () { return config.idleSpeed; }
+
+        // Speed autonomous routines shoot at unless a step gives its own.
+        units::angular_velocity::revolutions_per_minute_t GetAutoSpeed () { return config.autoSpeed; }
+
         void SetTrackingMode(TrackingMode mode);
 
         void SetTurretSpeed(units::angular_velocity::revolutions_per_minute_t speed);
@@ -33,30 +59,72 @@ class Shooter : public frc2::SubsystemBase {
 
         int GetTargetCount();
 
+        // True while the camera sees the target, aimed or not.
+        bool HasTarget();
         bool IsOnTarget();
 
+        units::length::meter_t GetTargetDistance();
+
+        // Clockwise from the robot's front, like tx.  The encoder is relative,
+        // so this counts from turretStartAngle, where the turret has to be at
+        // power on.
+        units::angle::degree_t GetTurretAngle();
+
+        // Aim this far counter-clockwise of the target while camera tracking.
+        void SetAimOffset(units::angle::degree_t offset);
+
+        // Lead the target for a robot driving at robotSpeed (m/s).  Updates the
+        // aim offset and returns the flywheel speed to use instead of speed.
+        units::angular_velocity::revolutions_per_minute_t CompensateForMotion(units::angular_velocity::revolutions_per_minute_t speed, double robotSpeed);
+
         double MeasureShooterMotorSpeed1();
         double MeasureShooterMotorSpeed2();
 
         void SetLimelightLight(bool on);
 
     private:
+        void DashboardPeriodic();
         void TrackingPeriodic(TrackingMode mode);
+        void ObserverPeriodic();
+        void SpinUpPeriodic();
 
         TrackingMode m_TrackingMode = TrackingMode::Off;
 
         int m_TargetCount = 0;
         double m_TargetErrorX = 0.0;
         double m_TargetErrorY = 0.0;
+        double m_AimOffset = 0.0;
 
-        rev::CANSparkMax m_ShooterMotor1 {kShooterMotor1, rev::CANSparkMax::MotorType::kBrushless};
-        rev::CANSparkMax m_ShooterMotor2 {kShooterMotor2, rev::CANSparkMax::MotorType::kBrushless};
-
-        ctre::phoenix::motorcontrol::can::TalonSRX m_TurretMotor {kTurretMotor};
+        ShooterIO* m_IO;
 
         std::shared_ptr<nt::NetworkTable> m_VisionTable;
         
         frc2::PIDController* m_TurretPID;
+
+        FlywheelObserver* m_FlywheelObserver;
+        hal::fpga_clock::time_point m_ObserverTimestamp = hal::fpga_clock::now();
+
+        // Spin-up being timed for the model.  Target of zero means none.
+        SpinUpModel m_SpinUpModel;
+        struct {
+            double target = 0.0;
+            double modelTime;
+            hal::fpga_clock::time_point start;
+        } m_SpinUp;
+
+        struct {
+            TelemetryNumber shooterP {"Shooter P"};
+            TelemetryNumber shooterD {"Shooter D"};
+            TelemetryNumber shooterF {"Shooter F"};
+
+            TelemetryNumber motor1Speed {"Shooter Motor 1"};
+            TelemetryNumber motor2Speed {"Shooter Motor 2"};
+
+            TelemetryNumber turretSetpoint {"Turret Speed Setpoint (RPM)"};
+            TelemetryBoolean hasTarget {"Limelight Has Target", 20_ms};
+            TelemetryNumber targetErrorX {"Turret Error X"};
+            TelemetryNumber targetErrorY {"Turret Error Y"};
+        } m_Telemetry;
         
         struct {
             struct {
@@ -67,6 +135,8 @@ class Shooter : public frc2::SubsystemBase {
                 double p, i, d;
             } turretPosition;
 
+            double turretStartAngle;
+
             struct {
                 double p, i, d, f;
             } shooterVelocity;
@@ -74,5 +144,20 @@ class Shooter : public frc2::SubsystemBase {
             struct {
                 units::angular_velocity::revolutions_per_minute_t near, far;
             } shootingSpeed;
+
+            struct {
+                double cameraHeight, cameraPitch, targetHeight;
+            } vision;
+
+            struct {
+                double ballSpeed, rpmPerMeter;
+            } lead;
+
+            struct {
+                double feedLeadTime;
+            } flywheel;
+
+            units::angular_velocity::revolutions_per_minute_t idleSpeed;
+            units::angular_velocity::revolutions_per_minute_t autoSpeed;
         } config;
 };
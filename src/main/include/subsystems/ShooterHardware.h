@@ -0,0 +1,36 @@
+#pragma once
+
+#include <ctre/phoenix/motorcontrol/can/TalonSRX.h>
+#include <rev/CANSparkMax.h>
+
+#include "Constants.h"
+#include "subsystems/ShooterIO.h"
+
+class ShooterHardware : public ShooterIO {
+    public:
+        ShooterHardware();
+
+        void ConfigureFlywheel(const Gains &gains) override;
+        void ConfigureTurret(const Gains &gains) override;
+
+        void SetFlywheelVelocity(double motorRpm) override;
+        void StopFlywheel() override;
+
+        double GetFlywheelVelocity () override { return m_ShooterMotor1.GetEncoder().GetVelocity(); }
+        double GetFollowerVelocity () override { return m_ShooterMotor2.GetEncoder().GetVelocity(); }
+
+        double GetFlywheelAppliedOutput () override { return m_ShooterMotor1.GetAppliedOutput(); }
+        double GetFlywheelBusVoltage () override { return m_ShooterMotor1.GetBusVoltage(); }
+        double GetFlywheelCurrent () override { return m_ShooterMotor1.GetOutputCurrent(); }
+
+        void SetTurretVelocity(double ticksPer100ms) override;
+        void StopTurret() override;
+
+        double GetTurretPosition () override { return m_TurretMotor.GetSelectedSensorPosition(); }
+
+    private:
+        rev::CANSparkMax m_ShooterMotor1 {kShooterMotor1, rev::CANSparkMax::MotorType::kBrushless};
+        rev::CANSparkMax m_ShooterMotor2 {kShooterMotor2, rev::CANSparkMax::MotorType::kBrushless};
+
+        ctre::phoenix::motorcontrol::can::TalonSRX m_TurretMotor {kTurretMotor};
+};
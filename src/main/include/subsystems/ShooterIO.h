@@ -0,0 +1,34 @@
+#pragma once
+
+// The shooter's flywheel and turret motors.  ShooterHardware on the robot, a
+// physics model in simulation.
+//
+// Flywheel speeds are motor rpm.  Turret units are the Talon's: encoder ticks,
+// and ticks per 100 ms.
+class ShooterIO {
+    public:
+        struct Gains {
+            double p, i, d, f;
+        };
+
+        virtual ~ShooterIO() = default;
+
+        virtual void ConfigureFlywheel(const Gains &gains) = 0;
+        virtual void ConfigureTurret(const Gains &gains) = 0;
+
+        // Through the motor controller's velocity loop.
+        virtual void SetFlywheelVelocity(double motorRpm) = 0;
+        virtual void StopFlywheel() = 0;
+
+        virtual double GetFlywheelVelocity() = 0;
+        virtual double GetFollowerVelocity() = 0;
+
+        virtual double GetFlywheelAppliedOutput() = 0;
+        virtual double GetFlywheelBusVoltage() = 0;
+        virtual double GetFlywheelCurrent() = 0;
+
+        virtual void SetTurretVelocity(double ticksPer100ms) = 0;
+        virtual void StopTurret() = 0;
+
+        virtual double GetTurretPosition() = 0;
+};
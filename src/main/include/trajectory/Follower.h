@@ -0,0 +1,46 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include <frc/geometry/Pose2d.h>
+
+#include "trajectory/Trajectory.h"
+
+// How FollowPolybezier steers along a path.  Each kind is chosen per path in
+// [follower] in config.toml, and all of them read the same Trajectory.
+//
+//  - legacy: the original follower.  Plans speed ahead over the polyline
+//    with a jerk limit, and steers by curvature, holding the path's heading.
+//    No feedback on position, so error builds up over long paths.
+//  - ramsete: tracks the trajectory in time, with feedback on position and
+//    heading.
+//  - purePursuit: drives toward a point ahead on the path, further ahead the
+//    faster it goes, at the profile's speed for where the robot is.
+class Follower {
+    public:
+        enum class Kind { kLegacy, kRamsete, kPurePursuit };
+
+        // "legacy", "ramsete" or "purePursuit".
+        static std::optional<Kind> ParseKind(const std::string &name);
+
+        // What FollowPolybezier hands the drivetrain, plus the point on the
+        // trajectory it was aiming for, to measure tracking against.
+        struct Output {
+            double acceleration;
+            double targetSpeed;
+            double angularVelocity;
+            double targetAngle;
+
+            Trajectory::Sample reference;
+        };
+
+        virtual ~Follower() = default;
+
+        // From Initialize, with the trajectory ready.
+        virtual void Start(const frc::Pose2d &pose) = 0;
+
+        // Every Execute, with the seconds since Start.  Returns false once
+        // the path is done, leaving output alone.
+        virtual bool Update(const frc::Pose2d &pose, double time, Output &output) = 0;
+};
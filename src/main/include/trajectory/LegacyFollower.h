@@ -0,0 +1,69 @@
+#pragma once
+
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "commands/FollowPolybezier.h"
+#include "subsystems/Drivetrain.h"
+#include "trajectory/Follower.h"
+#include "trajectory/Trajectory.h"
+
+// FollowPolybezier's original controller.  Finds the robot's progress along
+// the path by projecting its pose onto the trajectory, plans acceleration
+// ahead of it over each curve's polyline with a jerk limit, and steers by the
+// curvature and heading there, corrected for cross-track error.  Planning
+// uses the polylines the path was loaded with, and treats a cusp like the end
+// of the path until it's past.
+class LegacyFollower : public Follower {
+    public:
+        // The trajectory must outlive the follower, and be the one built
+        // for path in the same direction.
+        LegacyFollower(Drivetrain *drivetrain, const FollowPolybezier::Path &path, const Trajectory &trajectory,
+            FollowPolybezier::Configuration configuration, bool backwards);
+
+        void Start(const frc::Pose2d &pose) override;
+        bool Update(const frc::Pose2d &pose, double time, Output &output) override;
+
+    private:
+        std::pair<double, double> CalculateAcceleration();
+
+        void SetNextMin();
+
+        void ResetCurveProgress();
+
+        Drivetrain *drivetrain;
+        FollowPolybezier::Configuration config;
+        bool backwards;
+
+        // Approximated when the path was loaded.  Reapproximating each curve
+        // from where the robot reached it allocated in the loop, and put its
+        // samples out of step with the trajectory's distances.
+        const FollowPolybezier::Path &polybezier;
+
+        // The heading and curvature at each point come from here, by
+        // distance along the path, rather than from the curves each loop.
+        const Trajectory &trajectory;
+
+        // Where each curve starts on the trajectory.
+        std::vector<double> curveStart;
+
+        unsigned int currentBezier;
+        unsigned int prevVertex;
+        std::pair<unsigned int, unsigned int> nextMin;
+
+        double progress; // along the trajectory
+        double distanceTraveled; // since beginning of curve
+
+        uint64_t lastTime;
+        double velocity;
+        double acceleration;
+
+        // Vertex, distance to it, velocity and acceleration there, for each
+        // vertex CalculateAcceleration looks ahead to.
+        using LookaheadPoint = std::tuple<std::pair<unsigned int, unsigned int>, double, double, double>;
+        std::vector<LookaheadPoint> lookahead;
+
+    // Times the planning steps on their own.  See src/benchmark.
+    friend class FollowerBenchmark;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Finds the nearest point on a polyline, for following by where the robot
+// actually is rather than how far it's driven.
+//
+// The segments are bucketed into a uniform grid of square cells, and a query
+// searches rings of cells outward from the point until nothing unsearched
+// could be closer, so it looks at a handful of segments however long the
+// path is.  Queries are limited to a window of distance along the path, so a
+// path that crosses itself can't pull progress onto the wrong pass.
+class PathIndex {
+    public:
+        struct Projection {
+            // Along the path, to the nearest point.
+            double distance;
+            double x, y;
+
+            // Signed, positive when the point is to the left of the path's
+            // direction of travel.
+            double crossTrack;
+        };
+
+        PathIndex() = default;
+
+        // Vertices of the polyline, with the distance along it to each.
+        PathIndex(const std::vector<double> &xs, const std::vector<double> &ys, const std::vector<double> &distances);
+
+        bool IsEmpty () const { return m_X.size() < 2; }
+
+        // The nearest point between from and to along the path.  Held at the
+        // ends of the window.
+        Projection Project(double x, double y, double from, double to) const;
+
+    private:
+        // Side (m) of each cell.
+        static constexpr double kCellSize = 0.25;
+
+        // Project onto segment i, between from and to.  Returns the squared
+        // distance to the point.
+        double ProjectOnto(std::size_t i, double x, double y, double from, double to, Projection &projection) const;
+
+        // Every segment in the window, for queries off the grid.
+        Projection Scan(double x, double y, double from, double to) const;
+
+        std::vector<double> m_X;
+        std::vector<double> m_Y;
+        std::vector<double> m_Distance;
+
+        double m_MinimumX = 0, m_MinimumY = 0;
+        int m_Columns = 0, m_Rows = 0;
+
+        // Segments in cell c are m_CellSegments[m_CellStart[c]] up to
+        // m_CellSegments[m_CellStart[c+1]], all in one array.
+        std::vector<uint32_t> m_CellStart;
+        std::vector<uint32_t> m_CellSegments;
+};
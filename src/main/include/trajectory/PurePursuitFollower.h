@@ -0,0 +1,42 @@
+#pragma once
+
+#include "trajectory/Follower.h"
+#include "trajectory/Trajectory.h"
+
+// Adaptive pure pursuit.  Finds the closest point on the path, drives at the
+// profile's speed for that point, and steers along the arc through a goal
+// point further on.  The goal is gain seconds ahead at the current speed,
+// kept between minimum and maximum metres, so it cuts corners less when slow
+// and weaves less when fast.  At a cusp it stops, and starts again the
+// other way.
+class PurePursuitFollower : public Follower {
+    public:
+        struct Lookahead {
+            double minimum = 0.3;
+            double maximum = 1.2;
+            double gain = 0.4;
+        };
+
+        // The trajectory must outlive the follower.
+        PurePursuitFollower (const Trajectory &trajectory, Lookahead lookahead) : m_Trajectory(trajectory), m_Lookahead(lookahead) {}
+
+        void Start(const frc::Pose2d &pose) override;
+        bool Update(const frc::Pose2d &pose, double time, Output &output) override;
+
+    private:
+        // From m_Progress to the next cusp or the end.
+        void StartStretch();
+
+        const Trajectory &m_Trajectory;
+        Lookahead m_Lookahead;
+
+        // Distance along the path to the closest point.
+        double m_Progress;
+
+        // Where the stretch being driven starts and stops.
+        double m_StretchStart;
+        double m_Stop;
+
+        // 1 forward, -1 backwards, over the stretch.
+        double m_Direction;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "trajectory/Follower.h"
+#include "trajectory/Trajectory.h"
+
+// Tracks where the trajectory says the robot should be at each moment, with
+// the usual nonlinear Ramsete feedback on the error in the robot's frame.
+// b (> 0) stiffens it, like a proportional gain, and zeta (0 to 1) damps it.
+class RamseteFollower : public Follower {
+    public:
+        struct Gains {
+            double b = 2.0;
+            double zeta = 0.7;
+        };
+
+        // The trajectory must outlive the follower.
+        RamseteFollower (const Trajectory &trajectory, Gains gains) : m_Trajectory(trajectory), m_Gains(gains) {}
+
+        void Start(const frc::Pose2d &pose) override;
+        bool Update(const frc::Pose2d &pose, double time, Output &output) override;
+
+    private:
+        const Trajectory &m_Trajectory;
+        Gains m_Gains;
+};
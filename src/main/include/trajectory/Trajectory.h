@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "trajectory/PathIndex.h"
+
+// A path and its velocity profile, sampled every kStep seconds of driving.
+//
+// Built once, when a path loads, from the path's polyline.  Curvature caps
+// the speed through each bend, forward and backward passes limit
+// acceleration and braking, and the result is resampled evenly in time.
+// Followers look setpoints up by elapsed time or by distance along the path
+// in O(1), instead of evaluating bezier curves every loop, and find where the
+// robot is along it with Project.
+//
+// Samples are kept as a structure of arrays, one contiguous vector for each
+// quantity.  Headings are radians counterclockwise, like odometry, in
+// (-pi, pi].  Velocity and acceleration are negative when driven backwards;
+// distance always counts up.
+//
+// A path can change direction partway, at a cusp, where it stops and backs
+// out the way it came.  The profile slows to a stop there and speeds up
+// again, and the robot's heading carries straight through.
+class Trajectory {
+    public:
+        // Seconds between samples.
+        static constexpr double kStep = 0.01;
+
+        struct Constraints {
+            double maximumVelocity;
+            double maximumAcceleration;
+            double maximumDeceleration;
+            double maximumRadialAcceleration;
+        };
+
+        // A point on the path.  Heading is the direction of travel, and
+        // curvature (1/m) is positive turning left.  Backwards points are
+        // driven with the robot facing away from the direction of travel,
+        // and a cusp is the last point before a change.
+        struct Waypoint {
+            double x, y;
+            double heading;
+            double curvature;
+            bool backwards = false;
+        };
+
+        struct Sample {
+            double time;
+            double distance;
+            double x, y;
+            double heading;
+            double velocity;
+            double acceleration;
+            double angularVelocity;
+            double curvature;
+        };
+
+        Trajectory() = default;
+
+        // Drives through waypoints in order, from rest to rest.  Backwards
+        // drives every waypoint the other way to how it's marked.
+        Trajectory(const std::vector<Waypoint> &waypoints, const Constraints &constraints, bool backwards = false);
+
+        bool IsEmpty () const { return m_Time.empty(); }
+        std::size_t GetSize () const { return m_Time.size(); }
+        double GetDuration () const { return m_Time.empty() ? 0 : m_Time.back(); }
+        double GetLength () const { return m_Distance.empty() ? 0 : m_Distance.back(); }
+
+        // Distance along the path to each cusp.
+        const std::vector<double>& GetCusps () const { return m_Cusps; }
+
+        // Where the robot next stops after distance: the next cusp, or the
+        // end.
+        double NextStop(double distance) const;
+
+        Sample GetSample(std::size_t index) const;
+
+        // Interpolated between samples, and held at the ends.
+        Sample AtTime(double time) const;
+        Sample AtDistance(double distance) const;
+
+        // The nearest point to (x, y) between from and to along the path.
+        // Followers keep from at their progress so far, and to a little
+        // ahead, so progress only moves forward.
+        PathIndex::Projection Project (double x, double y, double from, double to) const { return m_Index.Project(x, y, from, to); }
+
+        const std::vector<double>& GetTimes () const { return m_Time; }
+        const std::vector<double>& GetDistances () const { return m_Distance; }
+        const std::vector<double>& GetXs () const { return m_X; }
+        const std::vector<double>& GetYs () const { return m_Y; }
+        const std::vector<double>& GetHeadings () const { return m_Heading; }
+        const std::vector<double>& GetVelocities () const { return m_Velocity; }
+        const std::vector<double>& GetAccelerations () const { return m_Acceleration; }
+        const std::vector<double>& GetAngularVelocities () const { return m_AngularVelocity; }
+        const std::vector<double>& GetCurvatures () const { return m_Curvature; }
+
+    private:
+        // Spacing (m) of the distance lookup table.
+        static constexpr double kDistanceStep = 0.01;
+
+        // Spacing (m) of the polyline Project searches.
+        static constexpr double kIndexStep = 0.05;
+
+        Sample Interpolate(std::size_t index, double fraction) const;
+
+        void Add(double time, double distance, double x, double y, double heading, double velocity, double acceleration, double curvature);
+
+        std::vector<double> m_Time;
+        std::vector<double> m_Distance;
+        std::vector<double> m_X;
+        std::vector<double> m_Y;
+        std::vector<double> m_Heading;
+        std::vector<double> m_Velocity;
+        std::vector<double> m_Acceleration;
+        std::vector<double> m_AngularVelocity;
+        std::vector<double> m_Curvature;
+
+        // The last sample at or before each multiple of kDistanceStep.
+        std::vector<uint32_t> m_DistanceIndex;
+
+        PathIndex m_Index;
+
+        std::vector<double> m_Cusps;
+};
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Deploy {
+    // Path to a file deployed from src/main/deploy.  That is /home/lvuser/deploy
+    // on the robot, and the project's src/main/deploy in simulation.
+    std::string path(const std::string &relative);
+
+    // Names of the .json files in directory, such as the paths, in order.
+    std::vector<std::string> listPaths(const std::string &directory);
+}
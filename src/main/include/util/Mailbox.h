@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Holds the latest value from exactly one writer thread, for any number of
+// readers.  A sequence lock: Write never blocks or allocates, and Read retries
+// if it overlapped a write, so a reader always sees a whole value, never half
+// of an old one and half of a new one.
+//
+// Meant for small structs like setpoints, which are replaced rather than
+// queued.  Use SpscRing when every value matters.
+template <typename T>
+class Mailbox {
+    static_assert(std::is_trivially_copyable<T>::value, "Mailbox values are copied bytewise");
+
+    public:
+        Mailbox () : Mailbox(T{}) {}
+
+        explicit Mailbox (const T &initial) {
+            Store(initial);
+        }
+
+        // Writer only.
+        void Write (const T &value) {
+            uint32_t sequence = m_Sequence.load(std::memory_order_relaxed);
+            m_Sequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            Store(value);
+
+            m_Sequence.store(sequence + 2, std::memory_order_release);
+        }
+
+        T Read () const {
+            std::array<uint64_t, kWords> words;
+            uint32_t before, after;
+
+            do {
+                before = m_Sequence.load(std::memory_order_acquire);
+                for (std::size_t i = 0; i < kWords; i++) {
+                    words[i] = m_Words[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                after = m_Sequence.load(std::memory_order_relaxed);
+            } while (before != after || (before & 1));
+
+            T value;
+            std::memcpy(&value, words.data(), sizeof(T));
+            return value;
+        }
+
+    private:
+        static constexpr std::size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+        // Copied through atomic words so a read racing a write is well defined,
+        // just discarded.
+        void Store (const T &value) {
+            std::array<uint64_t, kWords> words {};
+            std::memcpy(words.data(), &value, sizeof(T));
+            for (std::size_t i = 0; i < kWords; i++) {
+                m_Words[i].store(words[i], std::memory_order_relaxed);
+            }
+        }
+
+        std::atomic<uint32_t> m_Sequence {0};
+        std::array<std::atomic<uint64_t>, kWords> m_Words;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include <frc/TimedRobot.h>
+#include <units/time.h>
+
+// Runs periodic work at its own rate instead of every robot loop.
+//
+// Tasks slower than the robot loop run every Nth loop.  Each one is given the
+// phase (which of those N loops) that currently has the least work on it, so
+// ten 10 Hz tasks land two per loop instead of all ten on the same one.
+//
+// Tasks faster than the robot loop get their own TimedRobot callback, offset
+// half a period so they fall between robot loops.  TimedRobot runs every
+// callback on the main thread, so they need no locking against commands.
+class RateScheduler {
+    public:
+        static RateScheduler& GetInstance();
+
+        void Schedule(std::function<void()> task, units::second_t period);
+
+        // Hands the fast tasks to the robot.  Tasks scheduled before this are
+        // held until it is called; tasks scheduled after are added right away.
+        void Install(frc::TimedRobot* robot);
+
+        // Call once per robot loop, before the command scheduler, so tasks see
+        // the same ordering as subsystem Periodic.
+        void Run();
+
+        // The robot loop's period, or the fastest task's if that's shorter.
+        // The simulation steps its clock no further than this at a time.
+        units::second_t GetFastestPeriod () const { return m_FastestPeriod; }
+
+    private:
+        // Loops over which the load is balanced.  Every divisor from 1 to 10
+        // loops (5 Hz and faster) fits evenly.
+        static constexpr int kHyperPeriod = 2520;
+
+        struct Task {
+            std::function<void()> task;
+            int divisor;
+            int countdown;
+        };
+
+        RateScheduler();
+
+        int PickPhase(int divisor);
+
+        frc::TimedRobot* m_Robot = nullptr;
+
+        units::second_t m_FastestPeriod;
+
+        std::vector<Task> m_Tasks;
+
+        // Fast tasks waiting for Install, and their periods.
+        std::vector<std::pair<std::function<void()>, units::second_t>> m_PendingFastTasks;
+
+        // Number of tasks that run on each loop of the hyper period.
+        std::vector<int> m_Load = std::vector<int>(kHyperPeriod, 0);
+};
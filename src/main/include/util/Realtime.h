@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <cpptoml.h>
+
+// An opt-in profile for matches, set up from [realtime] in config.toml.
+//
+// By default the robot program runs with normal scheduling, and the first run
+// of anything can page fault, so the first seconds of auto jitter.  With
+// enabled = true:
+//  - the main loop, the drivetrain control loop, sensor interrupt threads and
+//    the HAL notifier thread that wakes them all get real-time priorities
+//  - memory is locked with mlockall, and the heap is kept from shrinking
+//  - every one of those threads touches its stack ahead of time, and some
+//    heap is reserved and touched
+//  - prefault tasks, like waiting for path data, run before the match
+// and each step is reported on stdout, along with the page faults taken in
+// disabled, auto and teleop.
+//
+// Only on the robot.  Simulation ignores it.
+namespace Realtime {
+    enum class Thread { kMain, kControl, kAcquisition };
+
+    // Call before any of the threads above start.
+    void Configure(std::shared_ptr<cpptoml::table> toml);
+
+    bool IsEnabled();
+
+    // Called from the main thread, in RobotInit.  Locks memory, raises the
+    // main and HAL notifier threads and runs the prefault tasks.
+    void Start();
+
+    // Called once from inside any other thread above, to raise and prefault
+    // it.
+    void EnterThread(Thread thread, const char* name);
+
+    // Run by Start.  touch returns the bytes it touched.
+    void AddPrefault(std::string name, std::function<std::size_t()> touch);
+
+    // Reads and writes back a byte of every page, so they're mapped before
+    // they're needed.  Not for memory another thread could be writing.
+    std::size_t TouchPages(void* data, std::size_t bytes);
+
+    // Prints the page faults since the last report, when enabled.  Call as
+    // each mode starts.
+    void ReportFaults(const char* mode);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Fixed size, lock-free queue for exactly one producer thread and one
+// consumer thread.  Neither side ever blocks or allocates, so it is safe to
+// push from an interrupt handler.
+template <typename T, std::size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+    public:
+        // Producer only.  Returns false, dropping the value, when full.
+        bool Push (const T &value) {
+            std::size_t head = m_Head.load(std::memory_order_relaxed);
+            if (head - m_Tail.load(std::memory_order_acquire) >= N) {
+                return false;
+            }
+
+            m_Buffer[head & (N - 1)] = value;
+            m_Head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer only.  Returns false when empty.
+        bool Pop (T &value) {
+            std::size_t tail = m_Tail.load(std::memory_order_relaxed);
+            if (tail == m_Head.load(std::memory_order_acquire)) {
+                return false;
+            }
+
+            value = m_Buffer[tail & (N - 1)];
+            m_Tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        std::array<T, N> m_Buffer;
+
+        // Keep the two indices on separate cache lines so the threads don't
+        // fight over one.
+        alignas(64) std::atomic<std::size_t> m_Head {0};
+        alignas(64) std::atomic<std::size_t> m_Tail {0};
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string>
+#include <type_traits>
+
+#include <networktables/NetworkTableEntry.h>
+#include <units/time.h>
+
+// Values reported to the dashboard.
+//
+// Keep a TelemetryNumber, TelemetryBoolean or TelemetryString for each key and
+// Set it as often as you like.  Set only stores the value.  Telemetry::Flush,
+// once per robot loop, sends the values that changed since they were last
+// sent, but no more often than each one's period.
+//
+// The entry is looked up in the SmartDashboard table once, when the handle is
+// made.  Only use handles from the main thread.
+
+class TelemetryEntry {
+    public:
+        TelemetryEntry(const std::string &key, units::second_t period);
+        virtual ~TelemetryEntry();
+
+        TelemetryEntry(const TelemetryEntry&) = delete;
+        TelemetryEntry& operator=(const TelemetryEntry&) = delete;
+
+        // For listening to dashboard edits.
+        nt::NetworkTableEntry GetEntry () { return m_Entry; }
+
+        // Sends the value if it is due.
+        void Flush(units::second_t now);
+
+    protected:
+        virtual void Send() = 0;
+
+        nt::NetworkTableEntry m_Entry;
+        bool m_Changed = false;
+
+    private:
+        units::second_t m_Period;
+        units::second_t m_LastSent {-1.0e6};
+};
+
+template <typename T>
+class TelemetryValue : public TelemetryEntry {
+    public:
+        explicit TelemetryValue (const std::string &key, units::second_t period = 100_ms)
+            : TelemetryEntry(key, period) {}
+
+        void Set (const T &value) {
+            if (m_HasValue && value == m_Value) return;
+
+            m_Value = value;
+            m_HasValue = true;
+            m_Changed = true;
+        }
+
+    protected:
+        void Send () override {
+            if constexpr (std::is_same_v<T, bool>) {
+                m_Entry.SetBoolean(m_Value);
+            } else if constexpr (std::is_same_v<T, std::string>) {
+                m_Entry.SetString(m_Value);
+            } else {
+                m_Entry.SetDouble(m_Value);
+            }
+        }
+
+    private:
+        T m_Value {};
+        bool m_HasValue = false;
+};
+
+using TelemetryNumber = TelemetryValue<double>;
+using TelemetryBoolean = TelemetryValue<bool>;
+using TelemetryString = TelemetryValue<std::string>;
+
+namespace Telemetry {
+    // Call once per robot loop.
+    void Flush();
+}
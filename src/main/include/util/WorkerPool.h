@@ -0,0 +1,56 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// A few threads for work that shouldn't hold up the robot loop, like parsing
+// and approximating paths.  Jobs run in the order they were submitted.
+//
+// The roboRIO has two cores, and the main loop mostly waits, so the shared
+// pool has two threads.
+class WorkerPool {
+    public:
+        explicit WorkerPool(int threads);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        static WorkerPool& GetInstance();
+
+        // Queues job and returns a future for its result.  Exceptions thrown
+        // by the job come out of the future's get().
+        template <typename F>
+        std::future<std::invoke_result_t<F>> Submit (F job) {
+            using Result = std::invoke_result_t<F>;
+
+            // std::function needs something copyable.
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::move(job));
+            std::future<Result> result = task->get_future();
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Jobs.push_back([task] { (*task)(); });
+            }
+            m_JobAdded.notify_one();
+
+            return result;
+        }
+
+    private:
+        void WorkerThread();
+
+        std::mutex m_Mutex;
+        std::condition_variable m_JobAdded;
+        std::deque<std::function<void()>> m_Jobs;
+        bool m_Stopping = false;
+
+        std::vector<std::thread> m_Threads;
+};
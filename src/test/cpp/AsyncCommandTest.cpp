@@ -0,0 +1,161 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "commands/AsyncCommand.h"
+
+// Longest any of these should take, on a loaded build machine.
+#define kPatience std::chrono::seconds(2)
+
+// What the follow-on command was asked to do.
+struct Calls {
+    int initialized = 0;
+    int executed = 0;
+    int ended = 0;
+    bool interrupted = false;
+};
+
+// Records its calls, and finishes after a few loops.
+class RecordingCommand : public frc2::CommandHelper<frc2::CommandBase, RecordingCommand> {
+    public:
+        RecordingCommand (std::shared_ptr<Calls> calls, int loops) : m_Calls(calls), m_Loops(loops) {}
+
+        void Initialize () { m_Calls->initialized++; }
+        void Execute () { m_Calls->executed++; }
+        void End (bool interrupted) { m_Calls->ended++; m_Calls->interrupted = interrupted; }
+        bool IsFinished () { return m_Calls->executed >= m_Loops; }
+
+    private:
+        std::shared_ptr<Calls> m_Calls;
+        int m_Loops;
+};
+
+// Runs the command like the scheduler would, a loop at a time.  Returns
+// false if it never finished.
+template <typename T>
+static bool RunUntilFinished (AsyncCommand<T> &command) {
+    auto deadline = std::chrono::steady_clock::now() + kPatience;
+    while (std::chrono::steady_clock::now() < deadline) {
+        command.Execute();
+        if (command.IsFinished()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+TEST(AsyncCommandTest, HandsResultToFollowOn) {
+    auto calls = std::make_shared<Calls>();
+    int received = 0;
+
+    AsyncCommand<int> command {
+        [](const std::atomic<bool> &cancelled) { return 42; },
+        [&](int result) -> std::unique_ptr<frc2::Command> {
+            received = result;
+            return std::make_unique<RecordingCommand>(calls, 3);
+        }
+    };
+
+    command.Initialize();
+    ASSERT_TRUE(RunUntilFinished(command));
+    command.End(false);
+
+    EXPECT_EQ(42, received);
+    EXPECT_EQ(1, calls->initialized);
+    EXPECT_EQ(3, calls->executed);
+    // Ended once, by the command itself, not again by End.
+    EXPECT_EQ(1, calls->ended);
+    EXPECT_FALSE(calls->interrupted);
+}
+
+TEST(AsyncCommandTest, FinishesWithoutFollowOn) {
+    AsyncCommand<int> command {
+        [](const std::atomic<bool> &cancelled) { return 1; },
+        [](int result) -> std::unique_ptr<frc2::Command> { return nullptr; }
+    };
+
+    command.Initialize();
+    EXPECT_TRUE(RunUntilFinished(command));
+}
+
+TEST(AsyncCommandTest, InterruptCancelsWithoutWaiting) {
+    // Held up until the test lets it go, so End can only return quickly if
+    // it doesn't wait for the work.
+    auto release = std::make_shared<std::atomic<bool>>(false);
+    auto sawCancel = std::make_shared<std::promise<bool>>();
+    auto seen = sawCancel->get_future();
+    bool followedOn = false;
+
+    AsyncCommand<int> command {
+        [release, sawCancel](const std::atomic<bool> &cancelled) {
+            while (!*release) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            sawCancel->set_value(cancelled);
+            return 0;
+        },
+        [&](int result) -> std::unique_ptr<frc2::Command> {
+            followedOn = true;
+            return nullptr;
+        }
+    };
+
+    command.Initialize();
+    command.Execute();
+    ASSERT_FALSE(command.IsFinished());
+
+    auto start = std::chrono::steady_clock::now();
+    command.End(true);
+    auto took = std::chrono::steady_clock::now() - start;
+
+    EXPECT_LT(took, std::chrono::milliseconds(100));
+    EXPECT_TRUE(command.IsFinished());
+
+    *release = true;
+    ASSERT_EQ(std::future_status::ready, seen.wait_for(kPatience));
+    EXPECT_TRUE(seen.get());
+    EXPECT_FALSE(followedOn);
+}
+
+TEST(AsyncCommandTest, InterruptEndsFollowOn) {
+    auto calls = std::make_shared<Calls>();
+
+    AsyncCommand<int> command {
+        [](const std::atomic<bool> &cancelled) { return 0; },
+        [&](int result) -> std::unique_ptr<frc2::Command> {
+            return std::make_unique<RecordingCommand>(calls, 1000);
+        }
+    };
+
+    command.Initialize();
+    auto deadline = std::chrono::steady_clock::now() + kPatience;
+    while (0 == calls->initialized && std::chrono::steady_clock::now() < deadline) {
+        command.Execute();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(1, calls->initialized);
+
+    command.End(true);
+    EXPECT_TRUE(command.IsFinished());
+    EXPECT_EQ(1, calls->ended);
+    EXPECT_TRUE(calls->interrupted);
+}
+
+TEST(AsyncCommandTest, ThrowingWorkFinishes) {
+    bool followedOn = false;
+
+    AsyncCommand<int> command {
+        [](const std::atomic<bool> &cancelled) -> int { throw std::runtime_error("no path"); },
+        [&](int result) -> std::unique_ptr<frc2::Command> {
+            followedOn = true;
+            return nullptr;
+        }
+    };
+
+    command.Initialize();
+    EXPECT_TRUE(RunUntilFinished(command));
+    EXPECT_FALSE(followedOn);
+    command.End(false);
+}
@@ -0,0 +1,109 @@
+#include "gtest/gtest.h"
+
+#include "conveyor/ConveyorModel.h"
+
+// As in config.toml.
+static ConveyorModel::Configuration TestConfiguration () {
+    ConveyorModel::Configuration config;
+    config.feederPosition    = 0.90;
+    config.exitPosition      = 1.30;
+    config.cellDiameter      = 0.178;
+    config.conveyorCellSpeed = 1.5;
+    config.feederCellSpeed   = 2.5;
+    return config;
+}
+
+#define kDt 0.005
+
+// Feed until the model's count drops, or give up after a second.
+static bool FeedUntilCountDrops (ConveyorModel &model) {
+    int count = model.GetCount();
+    for (double t = 0; t < 1.0; t += kDt) {
+        model.Update(kDt, 1.0, 1.0);
+        if (model.GetCount() < count) return true;
+    }
+    return false;
+}
+
+TEST(ConveyorModelTest, ExitEdgeRemovesFrontCell) {
+    ConveyorModel model{TestConfiguration()};
+    model.Reset(3);
+
+    EXPECT_TRUE(model.IsCellStaged());
+
+    model.OnExitEdge();
+    EXPECT_EQ(2, model.GetCount());
+}
+
+TEST(ConveyorModelTest, ShootSequenceBeamFirst) {
+    ConveyorModel model{TestConfiguration()};
+    model.Reset(3);
+
+    // The exit beam sees each cell as it reaches the flywheel, before the
+    // model would have given up on it.
+    for (int shot = 1; shot <= 3; shot++) {
+        while (model.GetPosition(0) < 1.30) {
+            model.Update(kDt, 1.0, 1.0);
+        }
+        model.OnExitEdge();
+        EXPECT_EQ(3 - shot, model.GetCount()) << "shot " << shot;
+    }
+
+    // Nothing left to lose.
+    for (int i = 0; i < 100; i++) model.Update(kDt, 1.0, 1.0);
+    EXPECT_TRUE(model.IsEmpty());
+}
+
+TEST(ConveyorModelTest, ShootSequenceLateBeam) {
+    ConveyorModel model{TestConfiguration()};
+    model.Reset(3);
+
+    // The model runs ahead and drops each cell past the exit before its
+    // edge arrives.  The late edge belongs to the cell already gone.
+    for (int shot = 1; shot <= 3; shot++) {
+        ASSERT_TRUE(FeedUntilCountDrops(model)) << "shot " << shot;
+        EXPECT_EQ(3 - shot, model.GetCount()) << "shot " << shot;
+
+        model.OnExitEdge();
+        EXPECT_EQ(3 - shot, model.GetCount()) << "late edge, shot " << shot;
+    }
+
+    EXPECT_TRUE(model.IsEmpty());
+}
+
+TEST(ConveyorModelTest, LateEdgeDoesNotTakeNextCell) {
+    ConveyorModel model{TestConfiguration()};
+    model.Reset(2);
+
+    ASSERT_TRUE(FeedUntilCountDrops(model));
+    model.OnExitEdge();
+    EXPECT_EQ(1, model.GetCount());
+
+    // The next cell's own edge still counts it out.
+    model.OnExitEdge();
+    EXPECT_TRUE(model.IsEmpty());
+}
+
+TEST(ConveyorModelTest, NotEmptyUntilLastCellSeen) {
+    ConveyorModel model{TestConfiguration()};
+    model.Reset(1);
+
+    // A slow last cell the model has given up on is still inside.
+    ASSERT_TRUE(FeedUntilCountDrops(model));
+    EXPECT_EQ(0, model.GetCount());
+    EXPECT_FALSE(model.IsEmpty());
+
+    model.OnExitEdge();
+    EXPECT_TRUE(model.IsEmpty());
+}
+
+TEST(ConveyorModelTest, ResetForgetsOwedEdges) {
+    ConveyorModel model{TestConfiguration()};
+    model.Reset(2);
+
+    ASSERT_TRUE(FeedUntilCountDrops(model));
+
+    model.Reset(2);
+    model.OnExitEdge();
+    EXPECT_EQ(1, model.GetCount());
+}
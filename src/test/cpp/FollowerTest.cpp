@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include <frc/geometry/Pose2d.h>
+
+#include "trajectory/PurePursuitFollower.h"
+#include "trajectory/RamseteFollower.h"
+#include "trajectory/Trajectory.h"
+
+constexpr double PI = 3.1415926535897932;
+
+static const Trajectory::Constraints kConstraints {
+    2.0,    // maximumVelocity
+    1.5,    // maximumAcceleration
+    2.0,    // maximumDeceleration
+    1.5     // maximumRadialAcceleration
+};
+
+// The robot loop.
+#define kLoopPeriod 0.02
+
+// Started this far (m) left of the path and turned (rad) off it, so the
+// feedback has something to do.
+#define kStartOffset 0.1
+#define kStartTurn 0.1
+
+// How far off the path (m) the robot may get, how far once it's had time
+// (s) to get back on, and how near the end it has to finish.  Ramsete's
+// gain scales with the reference speed, so it's slow to get back on while
+// speeding up from rest.
+#define kMaximumError 0.15
+#define kSettleTime 2.0
+#define kSettledError 0.06
+#define kEndTolerance 0.1
+
+// Drivetrain heading hold, as in Drivetrain::GetRotationalCorrection.
+#define kACorrection 3.0
+#define aCorrectionMax 0.7
+
+// Left a quarter turn, then right a quarter turn, both of radius r.
+static std::vector<Trajectory::Waypoint> SCurve (double r) {
+    std::vector<Trajectory::Waypoint> waypoints;
+    for (int i = 0; i <= 30; i++) {
+        double a = (PI/2) * i / 30;
+        waypoints.push_back({r*std::sin(a), r*(1 - std::cos(a)), a, 1/r});
+    }
+    for (int i = 1; i <= 30; i++) {
+        double a = (PI/2) * i / 30;
+        waypoints.push_back({2*r - r*std::cos(a), r + r*std::sin(a), PI/2 - a, -1/r});
+    }
+    return waypoints;
+}
+
+// Out to (2, 0), then backs straight out to where it started.
+static std::vector<Trajectory::Waypoint> Cusp () {
+    return {{0, 0, 0, 0}, {2, 0, 0, 0}, {0, 0, PI, 0, true}};
+}
+
+// Drives exactly at the speed asked for, and turns at the rate asked for
+// plus the drivetrain's correction toward targetAngle.
+struct Robot {
+    double x, y, angle;
+
+    frc::Pose2d GetPose () const {
+        return {units::meter_t{x}, units::meter_t{y}, frc::Rotation2d{units::radian_t{angle}}};
+    }
+
+    void Drive (const Follower::Output &output, double dt) {
+        double target = output.targetAngle;
+        if (angle - target > PI) {
+            target += 2*PI;
+        } else if (target - angle > PI) {
+            target -= 2*PI;
+        }
+
+        double w = output.angularVelocity + std::clamp(kACorrection * (target - angle), -aCorrectionMax, aCorrectionMax);
+        double heading = angle + w*dt/2;
+        x += output.targetSpeed * std::cos(heading) * dt;
+        y += output.targetSpeed * std::sin(heading) * dt;
+        angle += w*dt;
+    }
+};
+
+struct Run {
+    bool finished = false;
+    Robot robot;
+
+    // Furthest from the path (m), and after kSettleTime.
+    double maximumError = 0;
+    double settledError = 0;
+
+    // Furthest targetAngle was from the robot's heading (rad).
+    double maximumTurn = 0;
+};
+
+// Follows the trajectory from just off its start, until the follower says
+// it's done or well after it should have been.
+static Run Follow (Follower &follower, const Trajectory &trajectory) {
+    Run run;
+    auto start = trajectory.GetSample(0);
+    run.robot = {
+        start.x - kStartOffset*std::sin(start.heading),
+        start.y + kStartOffset*std::cos(start.heading),
+        start.heading + kStartTurn
+    };
+
+    follower.Start(run.robot.GetPose());
+    for (double time = 0; time < trajectory.GetDuration() + 5.0; time += kLoopPeriod) {
+        Follower::Output output;
+        if (!follower.Update(run.robot.GetPose(), time, output)) {
+            run.finished = true;
+            break;
+        }
+        run.maximumTurn = std::max(run.maximumTurn, std::fabs(output.targetAngle - run.robot.angle));
+
+        run.robot.Drive(output, kLoopPeriod);
+
+        auto nearest = trajectory.Project(run.robot.x, run.robot.y, 0, trajectory.GetLength());
+        double error = std::hypot(run.robot.x - nearest.x, run.robot.y - nearest.y);
+        run.maximumError = std::max(run.maximumError, error);
+        if (time > kSettleTime) run.settledError = std::max(run.settledError, error);
+    }
+    return run;
+}
+
+static void ExpectCompleted (const Run &run, const Trajectory &trajectory) {
+    auto end = trajectory.GetSample(trajectory.GetSize() - 1);
+    EXPECT_TRUE(run.finished);
+    EXPECT_LT(run.maximumError, kMaximumError);
+    EXPECT_LT(run.settledError, kSettledError);
+    EXPECT_NEAR(end.x, run.robot.x, kEndTolerance);
+    EXPECT_NEAR(end.y, run.robot.y, kEndTolerance);
+}
+
+TEST(FollowerTest, RamseteFollowsACurve) {
+    Trajectory trajectory {SCurve(1.5), kConstraints};
+    RamseteFollower follower {trajectory, RamseteFollower::Gains{}};
+
+    auto run = Follow(follower, trajectory);
+    ExpectCompleted(run, trajectory);
+    // Heading is corrected through angularVelocity alone.
+    EXPECT_EQ(0, run.maximumTurn);
+}
+
+TEST(FollowerTest, RamseteReversesAtACusp) {
+    Trajectory trajectory {Cusp(), kConstraints};
+    RamseteFollower follower {trajectory, RamseteFollower::Gains{}};
+
+    auto run = Follow(follower, trajectory);
+    ExpectCompleted(run, trajectory);
+    EXPECT_EQ(0, run.maximumTurn);
+}
+
+TEST(FollowerTest, PurePursuitFollowsACurve) {
+    Trajectory trajectory {SCurve(1.5), kConstraints};
+    PurePursuitFollower follower {trajectory, PurePursuitFollower::Lookahead{}};
+
+    ExpectCompleted(Follow(follower, trajectory), trajectory);
+}
+
+TEST(FollowerTest, PurePursuitReversesAtACusp) {
+    Trajectory trajectory {Cusp(), kConstraints};
+    PurePursuitFollower follower {trajectory, PurePursuitFollower::Lookahead{}};
+
+    ExpectCompleted(Follow(follower, trajectory), trajectory);
+}
@@ -0,0 +1,93 @@
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+#include "shooter/LeadCompensation.h"
+
+#define kBallSpeed 11.0
+
+TEST(LeadCompensationTest, StandingStillAimsStraight) {
+    Lead::Solution solution = Lead::solve(5.0, 0.3, 0.0, kBallSpeed);
+
+    EXPECT_DOUBLE_EQ(0.0, solution.aimOffset);
+    EXPECT_DOUBLE_EQ(5.0, solution.effectiveRange);
+    EXPECT_DOUBLE_EQ(5.0 / kBallSpeed, solution.flightTime);
+}
+
+TEST(LeadCompensationTest, DrivingAtTargetShortensShot) {
+    Lead::Solution solution = Lead::solve(5.0, 0.0, 2.0, kBallSpeed);
+
+    EXPECT_NEAR(0.0, solution.aimOffset, 1e-12);
+    EXPECT_DOUBLE_EQ(5.0 / (kBallSpeed + 2.0), solution.flightTime);
+    EXPECT_LT(solution.effectiveRange, 5.0);
+}
+
+TEST(LeadCompensationTest, DrivingAwayLengthensShot) {
+    Lead::Solution solution = Lead::solve(5.0, M_PI, 2.0, kBallSpeed);
+
+    EXPECT_NEAR(0.0, solution.aimOffset, 1e-12);
+    EXPECT_NEAR(5.0 / (kBallSpeed - 2.0), solution.flightTime, 1e-12);
+    EXPECT_GT(solution.effectiveRange, 5.0);
+}
+
+TEST(LeadCompensationTest, CrossingCancelsDrift) {
+    // Target off the left side, driving forward: the robot carries the cell
+    // forward, so the shot turns toward the back (counter-clockwise) against it.
+    double bearing = M_PI / 2;
+    double robotSpeed = 2.0;
+    Lead::Solution solution = Lead::solve(5.0, bearing, robotSpeed, kBallSpeed);
+
+    EXPECT_GT(solution.aimOffset, 0.0);
+
+    // Cell velocity, robot frame: the shot's plus the robot's.
+    double shot = bearing + solution.aimOffset;
+    double vx = kBallSpeed * std::cos(shot) + robotSpeed;
+    double vy = kBallSpeed * std::sin(shot);
+
+    // Straight down the line of sight, and there when promised.
+    EXPECT_NEAR(0.0, vx, 1e-9);
+    EXPECT_NEAR(5.0, vy * solution.flightTime, 1e-9);
+}
+
+TEST(LeadCompensationTest, LandsOnTargetAtAnyBearing) {
+    for (double bearing = -M_PI; bearing <= M_PI; bearing += 0.1) {
+        Lead::Solution solution = Lead::solve(4.0, bearing, 1.5, kBallSpeed);
+
+        double shot = bearing + solution.aimOffset;
+        double x = (kBallSpeed * std::cos(shot) + 1.5) * solution.flightTime;
+        double y = kBallSpeed * std::sin(shot) * solution.flightTime;
+
+        EXPECT_NEAR(4.0 * std::cos(bearing), x, 1e-9) << "bearing " << bearing;
+        EXPECT_NEAR(4.0 * std::sin(bearing), y, 1e-9) << "bearing " << bearing;
+        EXPECT_NEAR(kBallSpeed * solution.flightTime, solution.effectiveRange, 1e-9);
+    }
+}
+
+TEST(LeadCompensationTest, OutrunningTheShotDoesNotLead) {
+    Lead::Solution solution = Lead::solve(5.0, M_PI, 12.0, kBallSpeed);
+
+    EXPECT_DOUBLE_EQ(0.0, solution.aimOffset);
+    EXPECT_DOUBLE_EQ(5.0, solution.effectiveRange);
+    EXPECT_DOUBLE_EQ(5.0 / kBallSpeed, solution.flightTime);
+}
+
+TEST(LeadCompensationTest, CrossSpeedBeyondBallSpeedClamps) {
+    // Can't cancel all of it, so shoot straight back and let the closing
+    // speed carry the cell.
+    Lead::Solution solution = Lead::solve(5.0, M_PI / 3, 20.0, kBallSpeed);
+
+    EXPECT_DOUBLE_EQ(M_PI / 2, solution.aimOffset);
+    EXPECT_NEAR(5.0 / (20.0 * std::cos(M_PI / 3)), solution.flightTime, 1e-9);
+}
+
+TEST(LeadCompensationTest, NoBallSpeedOrRange) {
+    Lead::Solution stopped = Lead::solve(5.0, 0.0, 2.0, 0.0);
+    EXPECT_DOUBLE_EQ(0.0, stopped.aimOffset);
+    EXPECT_DOUBLE_EQ(5.0, stopped.effectiveRange);
+    EXPECT_DOUBLE_EQ(0.0, stopped.flightTime);
+
+    Lead::Solution point = Lead::solve(0.0, 0.0, 2.0, kBallSpeed);
+    EXPECT_DOUBLE_EQ(0.0, point.aimOffset);
+    EXPECT_DOUBLE_EQ(0.0, point.effectiveRange);
+    EXPECT_DOUBLE_EQ(0.0, point.flightTime);
+}
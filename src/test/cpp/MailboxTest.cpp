@@ -0,0 +1,55 @@
+#include <cstdint>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "util/Mailbox.h"
+
+#define kWrites 2000000
+
+// Several words, all holding the same number, so a read that mixed two
+// writes shows as words that disagree.
+struct Words {
+    uint64_t words[8];
+};
+
+static Words Fill (uint64_t n) {
+    Words value;
+    for (auto &word : value.words) word = n;
+    return value;
+}
+
+TEST(MailboxTest, HoldsInitialValue) {
+    Mailbox<Words> mailbox {Fill(7)};
+    auto value = mailbox.Read();
+    for (auto word : value.words) EXPECT_EQ(7u, word);
+}
+
+TEST(MailboxTest, NeverTearsUnderAConcurrentWriter) {
+    Mailbox<Words> mailbox {Fill(0)};
+
+    std::thread writer {[&] {
+        for (uint64_t n = 1; n <= kWrites; n++) mailbox.Write(Fill(n));
+    }};
+
+    // Reads as fast as it can until the last write lands.
+    long reads = 0, torn = 0, backwards = 0;
+    uint64_t last = 0;
+    while (last < kWrites) {
+        auto value = mailbox.Read();
+        reads++;
+
+        for (auto word : value.words) {
+            if (word != value.words[0]) {
+                torn++;
+                break;
+            }
+        }
+        if (value.words[0] < last) backwards++;
+        last = value.words[0];
+    }
+    writer.join();
+
+    EXPECT_EQ(0, torn) << "in " << reads << " reads";
+    EXPECT_EQ(0, backwards) << "in " << reads << " reads";
+}
@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "trajectory/PathIndex.h"
+
+constexpr double PI = 3.1415926535897932;
+
+#define kVertices 400
+
+// A figure eight four meters wide, starting at its right end and crossing
+// itself at the origin: vertex 100 on the way down and vertex 300 on the
+// way back up.
+struct FigureEight {
+    std::vector<double> xs, ys, distances;
+
+    FigureEight () {
+        for (int i = 0; i <= kVertices; i++) {
+            double a = PI/2 + 2*PI*i/kVertices;
+            xs.push_back(2*std::sin(a));
+            ys.push_back(std::sin(2*a));
+            distances.push_back(i == 0 ? 0 : distances.back() + std::hypot(xs[i] - xs[i-1], ys[i] - ys[i-1]));
+        }
+    }
+
+    double GetLength () const { return distances.back(); }
+
+    // Every segment, clipped to the window, nearest first along the path on
+    // ties like PathIndex.  Returns the squared distance to the point.
+    double Nearest (double x, double y, double from, double to, PathIndex::Projection &nearest) const {
+        double best = INFINITY;
+        for (std::size_t i = 0; i + 1 < xs.size(); i++) {
+            double d0 = distances[i], d1 = distances[i+1];
+            if (d1 < from || d0 > to) continue;
+
+            double dx = xs[i+1] - xs[i], dy = ys[i+1] - ys[i];
+            double t = ((x - xs[i])*dx + (y - ys[i])*dy) / (dx*dx + dy*dy);
+            t = std::clamp(t, std::max(0.0, (from - d0) / (d1 - d0)), std::min(1.0, (to - d0) / (d1 - d0)));
+
+            double px = xs[i] + t*dx, py = ys[i] + t*dy;
+            double squared = (x - px)*(x - px) + (y - py)*(y - py);
+            if (squared < best) {
+                best = squared;
+                nearest = {d0 + t*(d1 - d0), px, py, 0};
+            }
+        }
+        return best;
+    }
+};
+
+TEST(PathIndexTest, EmptyWithoutASegment) {
+    EXPECT_TRUE(PathIndex{}.IsEmpty());
+    EXPECT_TRUE((PathIndex{{1.0}, {2.0}, {0.0}}.IsEmpty()));
+}
+
+TEST(PathIndexTest, MatchesBruteForce) {
+    FigureEight path;
+    PathIndex index {path.xs, path.ys, path.distances};
+
+    std::mt19937 random {1};
+    std::uniform_real_distribution<double> coordinate {-3, 3};
+    std::uniform_real_distribution<double> along {0, path.GetLength()};
+
+    for (int n = 0; n < 5000; n++) {
+        double x = coordinate(random), y = coordinate(random);
+        // Alternately a follower's short window and the whole path.
+        double from = along(random);
+        double to = n % 2 ? from + 1.0 : path.GetLength();
+
+        PathIndex::Projection expected;
+        double best = path.Nearest(x, y, from, to, expected);
+
+        auto projection = index.Project(x, y, from, to);
+        double squared = (x - projection.x)*(x - projection.x) + (y - projection.y)*(y - projection.y);
+
+        ASSERT_NEAR(std::sqrt(best), std::sqrt(squared), 1e-9) << "(" << x << ", " << y << ") from " << from << " to " << to;
+        ASSERT_GE(projection.distance, from - 1e-9);
+        ASSERT_LE(projection.distance, to + 1e-9);
+    }
+}
+
+TEST(PathIndexTest, MatchesBruteForceOffTheGrid) {
+    FigureEight path;
+    PathIndex index {path.xs, path.ys, path.distances};
+
+    for (double angle = 0; angle < 2*PI; angle += 0.1) {
+        double x = 20*std::cos(angle), y = 20*std::sin(angle);
+
+        PathIndex::Projection expected;
+        double best = path.Nearest(x, y, 0, path.GetLength(), expected);
+
+        auto projection = index.Project(x, y, 0, path.GetLength());
+        EXPECT_NEAR(std::sqrt(best), std::hypot(x - projection.x, y - projection.y), 1e-9) << "at " << angle;
+    }
+}
+
+TEST(PathIndexTest, CrossTrackIsPositiveToTheLeft) {
+    // Along x.
+    PathIndex index {{0.0, 1.0, 2.0}, {0.0, 0.0, 0.0}, {0.0, 1.0, 2.0}};
+
+    auto left = index.Project(1.5, 0.3, 0, 2);
+    EXPECT_NEAR(1.5, left.distance, 1e-9);
+    EXPECT_NEAR(0.3, left.crossTrack, 1e-9);
+
+    auto right = index.Project(0.5, -0.2, 0, 2);
+    EXPECT_NEAR(0.5, right.distance, 1e-9);
+    EXPECT_NEAR(-0.2, right.crossTrack, 1e-9);
+}
+
+TEST(PathIndexTest, ProgressNeverGoesBackwards) {
+    FigureEight path;
+    PathIndex index {path.xs, path.ys, path.distances};
+
+    // A robot wandering either side of the path, and sometimes back along
+    // it, as a follower would see it.
+    std::mt19937 random {2};
+    std::normal_distribution<double> noise {0, 0.1};
+
+    double progress = 0;
+    for (double driven = 0; driven < path.GetLength(); driven += 0.02) {
+        PathIndex::Projection truth;
+        double d = std::clamp(driven + noise(random), 0.0, path.GetLength());
+        path.Nearest(path.xs[0], path.ys[0], d, d, truth);
+
+        auto projection = index.Project(truth.x + noise(random), truth.y + noise(random), progress, progress + 1.0);
+        ASSERT_GE(projection.distance, progress) << "driven " << driven;
+        progress = projection.distance;
+
+        // And keeps up, without jumping ahead.
+        ASSERT_NEAR(driven, progress, 0.5) << "driven " << driven;
+    }
+}
+
+TEST(PathIndexTest, FigureEightStaysOnItsPass) {
+    FigureEight path;
+    PathIndex index {path.xs, path.ys, path.distances};
+
+    double first = path.distances[kVertices/4];
+    double second = path.distances[3*kVertices/4];
+
+    // Just off the crossing, nearer the second pass than the first.
+    double x = 0.05, y = 0.05;
+    auto anywhere = index.Project(x, y, 0, path.GetLength());
+    ASSERT_NEAR(second, anywhere.distance, 0.2);
+
+    // Coming up to the first pass, it stays on the first.
+    for (double progress = first - 0.5; progress < first; progress += 0.05) {
+        auto projection = index.Project(x, y, progress, progress + 1.0);
+        EXPECT_NEAR(first, projection.distance, 0.2) << "from " << progress;
+    }
+
+    // And on the second pass, the second.
+    for (double progress = second - 0.5; progress < second; progress += 0.05) {
+        auto projection = index.Project(x, y, progress, progress + 1.0);
+        EXPECT_NEAR(second, projection.distance, 0.2) << "from " << progress;
+    }
+}
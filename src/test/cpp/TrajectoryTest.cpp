@@ -0,0 +1,234 @@
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "trajectory/Trajectory.h"
+
+constexpr double PI = 3.1415926535897932;
+
+// Braking twice as hard as speeding up, so a mix-up between the two shows.
+static const Trajectory::Constraints kConstraints {
+    1.5,    // maximumVelocity
+    1.0,    // maximumAcceleration
+    2.0,    // maximumDeceleration
+    0.5     // maximumRadialAcceleration
+};
+
+// Room for rounding in the profile and resampling.
+#define kTolerance 1e-6
+
+// Along x, from the origin.
+static std::vector<Trajectory::Waypoint> Straight (double length) {
+    return {{0, 0, 0, 0}, {length, 0, 0, 0}};
+}
+
+// A quarter turn left around (0, radius), from the origin.
+static std::vector<Trajectory::Waypoint> Arc (double radius) {
+    std::vector<Trajectory::Waypoint> waypoints;
+    for (int i = 0; i <= 30; i++) {
+        double angle = (PI/2) * i / 30;
+        waypoints.push_back({radius*std::sin(angle), radius*(1 - std::cos(angle)), angle, 1/radius});
+    }
+    return waypoints;
+}
+
+TEST(TrajectoryTest, EmptyWithoutTwoWaypoints) {
+    Trajectory trajectory {{{0, 0, 0, 0}}, kConstraints};
+    EXPECT_TRUE(trajectory.IsEmpty());
+    EXPECT_EQ(0, trajectory.GetDuration());
+}
+
+TEST(TrajectoryTest, StartsAndEndsAtRest) {
+    for (auto waypoints : {Straight(4.0), Arc(2.0)}) {
+        Trajectory trajectory {waypoints, kConstraints};
+        ASSERT_FALSE(trajectory.IsEmpty());
+
+        auto start = trajectory.GetSample(0);
+        auto end = trajectory.GetSample(trajectory.GetSize() - 1);
+        EXPECT_NEAR(0, start.velocity, kTolerance);
+        EXPECT_NEAR(0, end.velocity, kTolerance);
+        EXPECT_NEAR(0, start.distance, kTolerance);
+        EXPECT_NEAR(trajectory.GetLength(), end.distance, kTolerance);
+        EXPECT_NEAR(waypoints.back().x, end.x, kTolerance);
+        EXPECT_NEAR(waypoints.back().y, end.y, kTolerance);
+    }
+}
+
+TEST(TrajectoryTest, StaysUnderMaximumVelocity) {
+    Trajectory trajectory {Straight(6.0), kConstraints};
+
+    double fastest = 0;
+    for (double velocity : trajectory.GetVelocities()) {
+        EXPECT_LE(std::fabs(velocity), kConstraints.maximumVelocity + kTolerance);
+        fastest = std::max(fastest, velocity);
+    }
+    // Long enough to get up to speed.
+    EXPECT_NEAR(kConstraints.maximumVelocity, fastest, 0.01);
+}
+
+TEST(TrajectoryTest, SlowsForCurvature) {
+    Trajectory trajectory {Arc(2.0), kConstraints};
+
+    // v^2 / r must stay under the radial limit through the bend.
+    double limit = std::sqrt(kConstraints.maximumRadialAcceleration * 2.0);
+    for (std::size_t i = 0; i < trajectory.GetSize(); i++) {
+        auto sample = trajectory.GetSample(i);
+        EXPECT_LE(sample.velocity, limit + kTolerance) << "at " << sample.distance << " m";
+        EXPECT_NEAR(sample.velocity * sample.curvature, sample.angularVelocity, kTolerance);
+    }
+}
+
+TEST(TrajectoryTest, StaysUnderAccelerationLimits) {
+    for (auto waypoints : {Straight(6.0), Arc(2.0)}) {
+        Trajectory trajectory {waypoints, kConstraints};
+        const auto &times = trajectory.GetTimes();
+        const auto &velocities = trajectory.GetVelocities();
+
+        for (std::size_t i = 1; i < trajectory.GetSize(); i++) {
+            double dt = times[i] - times[i-1];
+            if (dt <= 0) continue;
+
+            double acceleration = (velocities[i] - velocities[i-1]) / dt;
+            EXPECT_LE(acceleration, kConstraints.maximumAcceleration + kTolerance) << "at " << times[i] << " s";
+            EXPECT_GE(acceleration, -kConstraints.maximumDeceleration - kTolerance) << "at " << times[i] << " s";
+        }
+    }
+}
+
+TEST(TrajectoryTest, SamplesEvenlyInTime) {
+    Trajectory trajectory {Straight(4.0), kConstraints};
+    const auto &times = trajectory.GetTimes();
+
+    for (std::size_t i = 1; i + 1 < times.size(); i++) {
+        EXPECT_NEAR(Trajectory::kStep, times[i] - times[i-1], kTolerance);
+    }
+    // The last one lands on the end, however short the step.
+    EXPECT_GT(times.back() - times[times.size() - 2], 0);
+    EXPECT_LE(times.back() - times[times.size() - 2], Trajectory::kStep + kTolerance);
+}
+
+TEST(TrajectoryTest, AtTimeInterpolates) {
+    Trajectory trajectory {Straight(4.0), kConstraints};
+
+    for (std::size_t i = 10; i + 1 < trajectory.GetSize(); i += 37) {
+        auto a = trajectory.GetSample(i);
+        auto b = trajectory.GetSample(i + 1);
+        auto middle = trajectory.AtTime((a.time + b.time) / 2);
+
+        EXPECT_NEAR((a.time + b.time) / 2, middle.time, kTolerance);
+        EXPECT_NEAR((a.distance + b.distance) / 2, middle.distance, kTolerance);
+        EXPECT_NEAR((a.x + b.x) / 2, middle.x, kTolerance);
+        EXPECT_NEAR((a.velocity + b.velocity) / 2, middle.velocity, kTolerance);
+    }
+}
+
+TEST(TrajectoryTest, AtTimeInterpolatesHeadingAcrossPi) {
+    // Driving left along x, so the heading sits at pi and jitters across it.
+    std::vector<Trajectory::Waypoint> waypoints {{0, 0, PI, 0}, {-2, 0.001, -PI + 0.001, 0}};
+    Trajectory trajectory {waypoints, kConstraints};
+
+    for (double t = 0; t < trajectory.GetDuration(); t += 0.013) {
+        EXPECT_GT(std::fabs(trajectory.AtTime(t).heading), PI - 0.01) << "at " << t << " s";
+    }
+}
+
+TEST(TrajectoryTest, AtTimeClampsToTheEnds) {
+    Trajectory trajectory {Arc(2.0), kConstraints};
+    auto first = trajectory.GetSample(0);
+    auto last = trajectory.GetSample(trajectory.GetSize() - 1);
+
+    auto before = trajectory.AtTime(-1.0);
+    EXPECT_EQ(first.time, before.time);
+    EXPECT_EQ(first.x, before.x);
+    EXPECT_EQ(first.y, before.y);
+
+    auto after = trajectory.AtTime(trajectory.GetDuration() + 1.0);
+    EXPECT_EQ(last.time, after.time);
+    EXPECT_EQ(last.x, after.x);
+    EXPECT_EQ(last.y, after.y);
+    EXPECT_EQ(0, after.velocity);
+}
+
+TEST(TrajectoryTest, AtDistanceInterpolates) {
+    Trajectory trajectory {Arc(2.0), kConstraints};
+
+    for (double d = 0; d < trajectory.GetLength(); d += 0.0731) {
+        auto sample = trajectory.AtDistance(d);
+        EXPECT_NEAR(d, sample.distance, kTolerance);
+
+        // On the circle, give or take the chords between waypoints.
+        EXPECT_NEAR(2.0, std::hypot(sample.x, sample.y - 2.0), 0.01) << "at " << d << " m";
+
+        // And agrees with the time it's reached.
+        EXPECT_NEAR(d, trajectory.AtTime(sample.time).distance, 1e-4);
+    }
+}
+
+TEST(TrajectoryTest, AtDistanceClampsToTheEnds) {
+    Trajectory trajectory {Straight(4.0), kConstraints};
+
+    auto before = trajectory.AtDistance(-1.0);
+    EXPECT_EQ(0, before.distance);
+    EXPECT_EQ(0, before.x);
+
+    auto after = trajectory.AtDistance(trajectory.GetLength() + 1.0);
+    EXPECT_NEAR(trajectory.GetLength(), after.distance, kTolerance);
+    EXPECT_NEAR(4.0, after.x, kTolerance);
+    EXPECT_EQ(0, after.velocity);
+}
+
+TEST(TrajectoryTest, BackwardsDrivesNegative) {
+    Trajectory trajectory {Straight(4.0), kConstraints, true};
+
+    for (double velocity : trajectory.GetVelocities()) {
+        EXPECT_LE(velocity, kTolerance);
+    }
+    // Facing away from the way it drives.
+    EXPECT_NEAR(PI, std::fabs(trajectory.AtDistance(2.0).heading), kTolerance);
+    EXPECT_NEAR(4.0, trajectory.AtDistance(4.0).x, kTolerance);
+}
+
+// Out to (2, 0), then backs straight out to where it started.
+static std::vector<Trajectory::Waypoint> Cusp () {
+    return {{0, 0, 0, 0}, {2, 0, 0, 0}, {0, 0, PI, 0, true}};
+}
+
+TEST(TrajectoryTest, StopsAndReversesAtACusp) {
+    Trajectory trajectory {Cusp(), kConstraints};
+    ASSERT_EQ(1u, trajectory.GetCusps().size());
+    EXPECT_NEAR(2.0, trajectory.GetCusps()[0], kTolerance);
+    EXPECT_NEAR(4.0, trajectory.GetLength(), kTolerance);
+
+    auto cusp = trajectory.AtDistance(2.0);
+    EXPECT_NEAR(0, cusp.velocity, 0.05);
+    EXPECT_NEAR(2.0, cusp.x, 1e-4);
+
+    // Forwards up to it, backwards after, facing the same way throughout.
+    for (std::size_t i = 0; i < trajectory.GetSize(); i++) {
+        auto sample = trajectory.GetSample(i);
+        if (sample.distance < 2.0 - kTolerance) {
+            EXPECT_GE(sample.velocity, -kTolerance) << "at " << sample.distance << " m";
+        } else if (sample.distance > 2.0 + kTolerance) {
+            EXPECT_LE(sample.velocity, kTolerance) << "at " << sample.distance << " m";
+        }
+        EXPECT_NEAR(0, sample.heading, kTolerance) << "at " << sample.distance << " m";
+    }
+    EXPECT_GT(trajectory.AtDistance(1.0).velocity, 0.5);
+    EXPECT_LT(trajectory.AtDistance(3.0).velocity, -0.5);
+    EXPECT_NEAR(0, trajectory.AtDistance(4.0).x, kTolerance);
+}
+
+TEST(TrajectoryTest, NextStopIsTheCuspThenTheEnd) {
+    Trajectory trajectory {Cusp(), kConstraints};
+    double cusp = trajectory.GetCusps()[0];
+
+    EXPECT_NEAR(cusp, trajectory.NextStop(0), kTolerance);
+    EXPECT_NEAR(cusp, trajectory.NextStop(1.5), kTolerance);
+    EXPECT_NEAR(trajectory.GetLength(), trajectory.NextStop(cusp), kTolerance);
+    EXPECT_NEAR(trajectory.GetLength(), trajectory.NextStop(3.0), kTolerance);
+
+    Trajectory straight {Straight(4.0), kConstraints};
+    EXPECT_TRUE(straight.GetCusps().empty());
+    EXPECT_NEAR(straight.GetLength(), straight.NextStop(0), kTolerance);
+}